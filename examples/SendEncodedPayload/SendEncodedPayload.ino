@@ -236,6 +236,11 @@ void loop() {
               debugSerial.println("The size of the payload is greater than allowed. Transmission failed!");
             break ;
            
+            case LORA_NO_FREE_CH:
+              debugSerial.println("Duty cycle exhausted. Sleeping until the next transmission opportunity.");
+              delay(OrangeForRN2483.nextTxOpportunity()) ;
+            break ;
+
             case LORA_BUSY:
               debugSerial.println("The device is busy. Sleeping for 10 extra seconds.");
               delay(10000) ;
@@ -0,0 +1,380 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "SimulatedModule.h"
+#include "TimeOnAir.h"
+
+#define SIMULATED_RX_DELAY		2000		// end of the RX2 window after the uplink
+#define SIMULATED_JOIN_DELAY	6000
+
+SimulatedModule::SimulatedModule() : busyUntil(0), sleepUntil(0), sleepPending(false), baudrate(RN2483_BAUDRATE),
+	dutyCycle(false), seed(1), peer(NULL), rxFrom(0), rxUntil(0), rxOpen(false), noFreeChannel(0)
+{
+	setResponder(respond, this);
+	enforceDutyCycle(false);
+
+	// the 3 default channels of the RN2483, 0.33% each
+	for (int i = 0; i < 3; i++)
+	{
+		set("mac ch freq " + std::to_string(i), std::to_string(868100000 + (i * 200000)));
+		set("mac ch dcycle " + std::to_string(i), "302");
+		set("mac ch status " + std::to_string(i), "on");
+	}
+
+	set("sys ver", SIMULATED_VERSION);
+	set("sys hweui", "0004A30B001A2B3C");
+	set("sys vdd", "3312");
+	set("mac dr", "5");
+	set("mac adr", "off");
+	set("mac retx", "7");
+	set("mac rxdelay1", "1000");
+	set("mac rx2", "3 869525000");
+	set("mac status", "00000000");
+	set("mac pwridx", "1");
+	set("mac upctr", "0");
+	set("mac dnctr", "0");
+	set("radio mod", "lora");
+	set("radio freq", "868100000");
+	set("radio pwr", "1");
+	set("radio sf", "sf12");
+	set("radio bw", "125");
+	set("radio cr", "4/5");
+	set("radio crc", "on");
+	set("radio iqi", "off");
+	set("radio sync", "34");
+	set("radio prlen", "8");
+	set("radio wdt", "15000");
+	set("radio snr", "-128");
+	set("radio bt", "0.5");
+	set("radio bitrate", "50000");
+	set("radio fdev", "25000");
+	set("radio rxbw", "25");
+	set("radio afcbw", "41.7");
+}
+
+void SimulatedModule::respond(LoopbackTransport* loopback, const uint8_t* line, uint16_t len, void* context)
+{
+	SimulatedModule* module = (SimulatedModule*)context;
+
+	// the autobaud byte sent after a break prefixes the next command
+	while ((len > 0) && ((*line == 0x55) || (*line == 0x00)))
+	{
+		line++;
+		len--;
+	}
+	std::string command((const char*)line, len);
+	module->commands.push_back(command);
+
+	// deaf while asleep
+	if (module->isAsleep()) return;
+	module->handle(command);
+}
+
+int SimulatedModule::pickChannel(uint32_t start, uint32_t airtime)
+{
+	if (!this->dutyCycle) return 0;
+
+	int free[SIMULATED_CHANNELS];
+	int count = 0;
+	for (int i = 0; i < SIMULATED_CHANNELS; i++)
+	{
+		if ((get("mac ch status " + std::to_string(i)) == "on") && ((int32_t)(start - this->channelUntil[i]) >= 0)) free[count++] = i;
+	}
+	if (count == 0) return -1;
+
+	this->seed = (this->seed * 1103515245) + 12345;
+	int channel = free[(this->seed >> 16) % count];
+	this->channelUntil[channel] = start + (airtime * (atol(get("mac ch dcycle " + std::to_string(channel)).c_str()) + 1));
+	return channel;
+}
+
+uint32_t SimulatedModule::getTransferTime(size_t len)
+{
+	// 10 bits per byte, CRLF included
+	return (this->baudrate == 0) ? 0 : (((len + 2) * 10 * 1000) + this->baudrate - 1) / this->baudrate;
+}
+
+void SimulatedModule::emit(const std::string& line, uint32_t delay)
+{
+	sScheduledLine scheduledLine = { hostClock() + delay, line };
+
+	// kept in the order of the due times
+	std::deque<sScheduledLine>::iterator it = this->scheduled.end();
+	while ((it != this->scheduled.begin()) && ((int32_t)((it - 1)->due - scheduledLine.due) > 0)) it--;
+	this->scheduled.insert(it, scheduledLine);
+}
+
+void SimulatedModule::script(const std::string& command, const std::string& answer, const std::string& final, uint32_t finalDelay)
+{
+	this->scripted[command].push_back(answer);
+	this->scripted[command].push_back(final);
+	this->scripted[command].push_back(std::to_string(finalDelay));
+}
+
+void SimulatedModule::queueDownlink(uint8_t port, const std::string& hex)
+{
+	this->downlinks.push_back(hex.empty() ? std::to_string(port) : std::to_string(port) + " " + hex);
+}
+
+void SimulatedModule::enforceDutyCycle(bool enable)
+{
+	this->dutyCycle = enable;
+	for (int i = 0; i < SIMULATED_CHANNELS; i++) this->channelUntil[i] = 0;
+}
+
+void SimulatedModule::setBaudrate(uint32_t baudrate)
+{
+	this->baudrate = baudrate;
+}
+
+void SimulatedModule::link(SimulatedModule* peer)
+{
+	this->peer = peer;
+	peer->peer = this;
+}
+
+uint32_t SimulatedModule::getRadioAirtime(uint16_t len)
+{
+	// "sf7", "125", "4/5" and the preamble length of the radio registers
+	eCodingRate codingRate = (eCodingRate)(get("radio cr")[2] - '5');
+	uint32_t airtime = TimeOnAir::loraFrame(atoi(get("radio sf").c_str() + 2), atoi(get("radio bw").c_str()), codingRate,
+		atoi(get("radio prlen").c_str()), len);
+	return (airtime + 999) / 1000;
+}
+
+std::string SimulatedModule::get(const std::string& name)
+{
+	std::map<std::string, std::string>::iterator it = this->registers.find(name);
+	return (it == this->registers.end()) ? "" : it->second;
+}
+
+void SimulatedModule::set(const std::string& name, const std::string& value)
+{
+	this->registers[name] = value;
+}
+
+bool SimulatedModule::isAsleep()
+{
+	return (int32_t)(this->sleepUntil - hostClock()) > 0;
+}
+
+size_t SimulatedModule::countCommands(const std::string& prefix)
+{
+	size_t count = 0;
+	for (size_t i = 0; i < this->commands.size(); i++)
+	{
+		if (this->commands[i].compare(0, prefix.size(), prefix) == 0) count++;
+	}
+	return count;
+}
+
+void SimulatedModule::handle(const std::string& command)
+{
+	// the module handles one command at a time, once it is received entirely
+	uint32_t now = hostClock();
+	uint32_t ready = now + getTransferTime(command.size());
+	if ((int32_t)(this->busyUntil - ready) > 0) ready = this->busyUntil;
+
+	std::string answer;
+	std::string final;
+	uint32_t finalDelay = 0;
+
+	char type[16] = "", verb[16] = "", param[32] = "";
+	int consumed = 0;
+	sscanf(command.c_str(), "%15s %15s %n", type, verb, &consumed);
+	std::string rest = (consumed > 0) ? command.substr(consumed) : "";
+	sscanf(rest.c_str(), "%31s", param);
+	std::string value = (rest.size() > strlen(param)) ? rest.substr(strlen(param) + 1) : "";
+	std::string name = std::string(type) + " " + param;
+
+	std::map<std::string, std::deque<std::string> >::iterator script = this->scripted.find(command);
+	if ((script != this->scripted.end()) && !script->second.empty())
+	{
+		answer = script->second[0];
+		final = script->second[1];
+		finalDelay = atol(script->second[2].c_str());
+		script->second.erase(script->second.begin(), script->second.begin() + 3);
+	}
+	else if ((strcmp(type, "sys") == 0) && ((strcmp(verb, "reset") == 0) || (strcmp(verb, "factoryRESET") == 0)))
+	{
+		answer = SIMULATED_VERSION;
+	}
+	else if ((strcmp(type, "sys") == 0) && (strcmp(verb, "sleep") == 0))
+	{
+		// answered once awake, see release()
+		this->sleepUntil = ready + atol(param);
+		this->sleepPending = true;
+		return;
+	}
+	else if ((strcmp(type, "mac") == 0) && (strcmp(param, "ch") == 0) && ((strcmp(verb, "get") == 0) || (strcmp(verb, "set") == 0)))
+	{
+		// "mac get ch <attribute> <id>", "mac set ch <attribute> <id> <value>"
+		char attribute[16] = "";
+		unsigned int id = SIMULATED_CHANNELS;
+		sscanf(value.c_str(), "%15s %u", attribute, &id);
+		std::string key = "mac ch " + std::string(attribute) + " " + std::to_string(id);
+		size_t setting = value.find(' ', strlen(attribute) + 1);
+
+		if (id >= SIMULATED_CHANNELS) answer = "invalid_param";
+		else if (strcmp(verb, "get") == 0) answer = this->registers.count(key) ? this->registers[key] : "invalid_param";
+		else if (setting == std::string::npos) answer = "invalid_param";
+		else
+		{
+			set(key, value.substr(setting + 1));
+			answer = "ok";
+		}
+	}
+	else if (strcmp(verb, "get") == 0)
+	{
+		answer = this->registers.count(name) ? this->registers[name] : "invalid_param";
+	}
+	else if (strcmp(verb, "set") == 0)
+	{
+		set(name, value);
+		answer = "ok";
+	}
+	else if ((strcmp(type, "mac") == 0) && (strcmp(verb, "tx") == 0))
+	{
+		size_t data = value.find(' ');
+		uint16_t len = (data == std::string::npos) ? 0 : (value.size() - data - 1) / 2;
+		uint32_t airtime = TimeOnAir::dataFrame((eDataRate)atoi(get("mac dr").c_str()), len);
+
+		if (pickChannel(ready, airtime) < 0)
+		{
+			this->noFreeChannel++;
+			answer = "no_free_ch";
+		}
+		else
+		{
+			set("mac upctr", std::to_string(atol(get("mac upctr").c_str()) + 1));
+			answer = "ok";
+			finalDelay = airtime + SIMULATED_RX_DELAY;
+			if (this->downlinks.empty()) final = "mac_tx_ok";
+			else
+			{
+				final = "mac_rx " + this->downlinks.front();
+				this->downlinks.pop_front();
+			}
+		}
+	}
+	else if ((strcmp(type, "mac") == 0) && (strcmp(verb, "join") == 0) &&
+		(pickChannel(ready, (TimeOnAir::frame((eDataRate)atoi(get("mac dr").c_str()), JOIN_REQUEST_SIZE) + 999) / 1000) < 0))
+	{
+		this->noFreeChannel++;
+		answer = "no_free_ch";
+	}
+	else if ((strcmp(type, "mac") == 0) && (strcmp(verb, "join") == 0))
+	{
+		set("mac status", "00000001");
+		answer = "ok";
+		final = "accepted";
+		finalDelay = (strcmp(param, "otaa") == 0) ? SIMULATED_JOIN_DELAY : 0;
+	}
+	else if ((strcmp(type, "radio") == 0) && (strcmp(verb, "tx") == 0))
+	{
+		uint32_t airtime = getRadioAirtime(rest.size() / 2);
+		sRadioTx tx = { ready, airtime };
+		this->radioTx.push_back(tx);
+
+		if (this->peer != NULL)
+		{
+			sPacket packet = { ready, airtime, rest };
+			this->peer->incoming.push_back(packet);
+		}
+		answer = "ok";
+		final = "radio_tx_ok";
+		finalDelay = airtime;
+	}
+	else if ((strcmp(type, "radio") == 0) && (strcmp(verb, "rx") == 0))
+	{
+		// "radio_err" once the watchdog ends the window, see release()
+		this->rxFrom = ready;
+		this->rxUntil = ready + atol(get("radio wdt").c_str());
+		this->rxOpen = true;
+		answer = "ok";
+	}
+	else if ((strcmp(type, "mac") == 0) && (strcmp(verb, "pause") == 0))
+	{
+		answer = "4294967245";
+	}
+	else if ((strcmp(type, "mac") == 0) && ((strcmp(verb, "resume") == 0) || (strcmp(verb, "save") == 0)))
+	{
+		answer = "ok";
+	}
+	else
+	{
+		answer = "invalid_param";
+	}
+
+	uint32_t due = ready + getTransferTime(answer.size());
+	this->busyUntil = due;
+	emit(answer, due - now);
+	if (!final.empty()) emit(final, due - now + finalDelay);
+}
+
+void SimulatedModule::release()
+{
+	if (this->sleepPending && !isAsleep())
+	{
+		this->sleepPending = false;
+		emit("ok");
+	}
+
+	// a packet is heard when a window is open as its transmission starts
+	while (!this->incoming.empty() && ((int32_t)(hostClock() - this->incoming.front().start) >= 0))
+	{
+		const sPacket& packet = this->incoming.front();
+		if (this->rxOpen && ((int32_t)(packet.start - this->rxFrom) >= 0) && ((int32_t)(this->rxUntil - packet.start) > 0))
+		{
+			this->rxOpen = false;
+			emit("radio_rx  " + packet.data, packet.start + packet.airtime - hostClock());
+		}
+		this->incoming.pop_front();
+	}
+
+	if (this->rxOpen && ((int32_t)(hostClock() - this->rxUntil) >= 0))
+	{
+		this->rxOpen = false;
+		emit("radio_err");
+	}
+
+	while (!this->scheduled.empty() && ((int32_t)(hostClock() - this->scheduled.front().due) >= 0))
+	{
+		// waits for the library to read the previous lines
+		const std::string& line = this->scheduled.front().line;
+		if (LOOPBACK_BUFFER_SIZE - 1 - LoopbackTransport::available() < (int)line.size() + 2) return;
+
+		injectLine(line.c_str());
+		this->scheduled.pop_front();
+	}
+}
+
+int SimulatedModule::available()
+{
+	release();
+	return LoopbackTransport::available();
+}
+
+uint16_t SimulatedModule::read(uint8_t* buffer, uint16_t size)
+{
+	release();
+	return LoopbackTransport::read(buffer, size);
+}
+
+void SimulatedModule::sendBreak()
+{
+	LoopbackTransport::sendBreak();
+
+	// wakes the module up, which then answers "sys sleep"
+	if (isAsleep()) this->sleepUntil = hostClock();
+}
@@ -0,0 +1,133 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			SimulatedModule.h
+* @brief		RN2483 played on a LoopbackTransport for the host tests
+* @details		The commands written by the library are answered on the virtual clock of the host build: the
+*				"mac set"/"radio set" values are kept and read back by "get", "mac tx" and "mac join" get their
+*				final response after the time on air, and "sys sleep" keeps the module deaf until its end. With the
+*				duty cycle enforced, "mac tx" and "mac join" pick a free enabled channel at random, as the RN2483,
+*				and each channel stays off for "mac ch dcycle" + 1 times the time on air. The
+*				UART is simulated at 57600 bauds, the module handling one command at a time. Two modules linked
+*				together exchange the packets of "radio tx" when the other one is in a "radio rx" window.
+*/
+
+#ifndef _SIMULATED_MODULE_H
+#define _SIMULATED_MODULE_H
+
+#include <Arduino.h>
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "LoopbackTransport.h"
+
+#define SIMULATED_VERSION		"RN2483 1.0.5 Oct 31 2018 15:06:52"
+#define SIMULATED_CHANNELS		16
+
+class SimulatedModule : public LoopbackTransport
+{
+protected:
+	typedef struct _sScheduledLine {
+		uint32_t due;
+		std::string line;
+	}sScheduledLine;
+
+	typedef struct _sPacket {
+		uint32_t start;
+		uint32_t airtime;
+		std::string data;
+	}sPacket;
+
+	std::deque<sScheduledLine> scheduled;
+	std::map<std::string, std::string> registers;
+	std::map<std::string, std::deque<std::string> > scripted;
+	std::deque<std::string> downlinks;
+	uint32_t busyUntil;						// End of the current answer on the UART
+	uint32_t sleepUntil;
+	bool sleepPending;						// "ok" of "sys sleep" not sent yet
+	uint32_t baudrate;
+	uint32_t channelUntil[SIMULATED_CHANNELS];	// End of the off-time of each channel
+	bool dutyCycle;
+	uint32_t seed;								// Channel picked at random, the same way on each run
+	SimulatedModule* peer;
+	std::deque<sPacket> incoming;			// Packets sent by the peer, heard if a window is open at their start
+	uint32_t rxFrom;
+	uint32_t rxUntil;
+	bool rxOpen;							// "radio rx" window waiting for a packet
+
+	static void respond(LoopbackTransport* loopback, const uint8_t* line, uint16_t len, void* context);
+	void release();
+	uint32_t getTransferTime(size_t len);
+	uint32_t getRadioAirtime(uint16_t len);
+	int pickChannel(uint32_t start, uint32_t airtime);
+
+	virtual void handle(const std::string& command);
+
+public:
+	typedef struct _sRadioTx {
+		uint32_t start;
+		uint32_t airtime;						// ms
+	}sRadioTx;
+
+	std::vector<std::string> commands;			// Every command received, without CRLF
+	uint32_t noFreeChannel;						// "mac tx" and "mac join" refused by the duty cycle
+	std::vector<sRadioTx> radioTx;				// Packets sent by "radio tx"
+
+	SimulatedModule();
+
+	/**
+	* @brief		Answering a command after a delay, possibly followed by a final response
+	* @details		Scripted answers are used once, in order, before the default behaviour
+	*/
+	void script(const std::string& command, const std::string& answer, const std::string& final = "", uint32_t finalDelay = 0);
+
+	/**
+	* @brief		Queuing a downlink received after the next uplink
+	*/
+	void queueDownlink(uint8_t port, const std::string& hex);
+
+	/**
+	* @brief		Sending a line right away, as an unsolicited event of the module
+	*/
+	void emit(const std::string& line, uint32_t delay = 0);
+
+	/**
+	* @brief		Enforcing the duty cycle of each channel on "mac tx" and "mac join"
+	*/
+	void enforceDutyCycle(bool enable);
+
+	/**
+	* @brief		Simulating the UART at a given speed, 0 for an instantaneous one
+	*/
+	void setBaudrate(uint32_t baudrate);
+
+	/**
+	* @brief		Linking two modules on the same radio channel, both ways
+	*/
+	void link(SimulatedModule* peer);
+
+	std::string get(const std::string& name);
+	void set(const std::string& name, const std::string& value);
+	bool isAsleep();
+	size_t countCommands(const std::string& prefix);
+
+	virtual int available();
+	virtual uint16_t read(uint8_t* buffer, uint16_t size);
+	virtual void sendBreak();
+};
+
+#endif
@@ -0,0 +1,89 @@
+# Script of the size_report target, run with cmake -P: compiles the library and object_sizes.cpp for the
+# SAMD21, then prints the flash and static RAM of the library and the RAM of each object.
+#
+# SAMD21_CXX, SAMD21_NM, SAMD21_SIZE	tools of the SAMD21 toolchain
+# SAMD21_FLAGS							compiler options, separated by |
+# SOURCES, INCLUDES						sources of the library and include directories, separated by |
+# REPORT_SOURCE							object_sizes.cpp
+# WORK_DIR								directory of the objects
+
+foreach(tool SAMD21_CXX SAMD21_NM SAMD21_SIZE)
+	if(NOT ${tool} OR ("${${tool}}" MATCHES "-NOTFOUND$"))
+		message(FATAL_ERROR "size_report: ${tool} not found, set it to the tool of the SAMD21 toolchain (arm-none-eabi-)")
+	endif()
+endforeach()
+
+string(REPLACE "|" ";" SAMD21_FLAGS "${SAMD21_FLAGS}")
+string(REPLACE "|" ";" SOURCES "${SOURCES}")
+string(REPLACE "|" ";" INCLUDES "${INCLUDES}")
+
+set(INCLUDE_FLAGS)
+foreach(dir ${INCLUDES})
+	list(APPEND INCLUDE_FLAGS -I${dir})
+endforeach()
+
+# compile(<object> <source> <definitions>...)
+function(compile object source)
+	set(DEFINE_FLAGS -DARDUINO=10800)
+	foreach(definition ${ARGN})
+		list(APPEND DEFINE_FLAGS -D${definition})
+	endforeach()
+
+	execute_process(COMMAND ${SAMD21_CXX} ${SAMD21_FLAGS} ${DEFINE_FLAGS} ${INCLUDE_FLAGS} -c ${source} -o ${object}
+		RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "size_report: ${source} does not build for the SAMD21: ${result}")
+	endif()
+endfunction()
+
+# report(<name> <definitions>...)
+function(report name)
+	set(dir ${WORK_DIR}/${name})
+	file(MAKE_DIRECTORY ${dir})
+
+	set(objects)
+	foreach(source ${SOURCES})
+		get_filename_component(base ${source} NAME_WE)
+		compile(${dir}/${base}.o ${source} ${ARGN})
+		list(APPEND objects ${dir}/${base}.o)
+	endforeach()
+
+	# "text data bss dec hex filename", the last line holds the totals
+	execute_process(COMMAND ${SAMD21_SIZE} -t ${objects} OUTPUT_VARIABLE output RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "size_report: ${SAMD21_SIZE} failed")
+	endif()
+	string(REGEX MATCH "[ \t]*([0-9]+)[ \t]+([0-9]+)[ \t]+([0-9]+)[ \t]+[0-9]+[ \t]+[0-9a-fA-F]+[ \t]+\\(TOTALS\\)" totals "${output}")
+	math(EXPR flash "${CMAKE_MATCH_1} + ${CMAKE_MATCH_2}")
+	math(EXPR ram "${CMAKE_MATCH_2} + ${CMAKE_MATCH_3}")
+
+	set(options "${ARGN}")
+	if(NOT options)
+		set(options "default options")
+	endif()
+	string(REPLACE ";" " " options "${options}")
+	message("SAMD21, ${options}:")
+	message("  library: ${flash} bytes of flash, ${ram} bytes of static RAM")
+
+	# each object is a symbol of its size, given in decimal by nm
+	compile(${dir}/object_sizes.o ${REPORT_SOURCE} ${ARGN})
+	execute_process(COMMAND ${SAMD21_NM} -S -t d ${dir}/object_sizes.o OUTPUT_VARIABLE output RESULT_VARIABLE result)
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "size_report: ${SAMD21_NM} failed")
+	endif()
+	string(REPLACE "\n" ";" lines "${output}")
+	foreach(line ${lines})
+		if(line MATCHES "^[0-9]+ 0*([0-9]+) [A-Za-z] sizeof_(.+)$")
+			set(type "${CMAKE_MATCH_2}                        ")
+			string(SUBSTRING "${type}" 0 24 type)
+			set(size "      ${CMAKE_MATCH_1}")
+			string(LENGTH "${size}" length)
+			math(EXPR start "${length} - 6")
+			string(SUBSTRING "${size}" ${start} 6 size)
+			message("  ${type} ${size} bytes")
+		endif()
+	endforeach()
+endfunction()
+
+report(default)
+report(full RN_STATS=1 RN_PARAM_CACHE=1)
@@ -0,0 +1,62 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			TestSupport.h
+* @brief		Checks shared by the host tests
+* @details		Each test is a program returning 0 when all its checks passed. A failed check prints its
+*				location and the test goes on, so that one run reports all the failures.
+*/
+
+#ifndef _TEST_SUPPORT_H
+#define _TEST_SUPPORT_H
+
+#include <Arduino.h>
+
+#include <stdio.h>
+
+static int testFailures = 0;
+
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) \
+		{ \
+			printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			testFailures++; \
+		} \
+	} while (0)
+
+#define CHECK_EQUAL(expected, actual) \
+	do { \
+		long long expectedValue = (long long)(expected); \
+		long long actualValue = (long long)(actual); \
+		if (expectedValue != actualValue) \
+		{ \
+			printf("%s:%d: CHECK_EQUAL(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #expected, #actual, expectedValue, actualValue); \
+			testFailures++; \
+		} \
+	} while (0)
+
+#define CHECK_STRING(expected, actual) \
+	do { \
+		const char* actualValue = (const char*)(actual); \
+		if ((actualValue == NULL) || (strcmp((expected), actualValue) != 0)) \
+		{ \
+			printf("%s:%d: CHECK_STRING(%s, %s) failed: \"%s\"\n", __FILE__, __LINE__, #expected, #actual, (actualValue == NULL) ? "(null)" : actualValue); \
+			testFailures++; \
+		} \
+	} while (0)
+
+#define TEST_RESULT()		((testFailures == 0) ? 0 : 1)
+
+#endif
@@ -0,0 +1,79 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// "mac set" commands per second against a module simulated at 57600 bauds, in virtual time:
+// one blocking setter per parameter, then batches with a growing window
+
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+#include <stdio.h>
+
+#define BENCH_ROUNDS		100
+
+static const char* values[] = { "3", "on", "7", "5000", "1", "15" };
+static const eParamMac params[] = { DATARATE, ADR, RETRANS_NB, RX_DELAY_1, PWR_IND_VAL, BAT_LVL };
+#define BENCH_COMMANDS		(sizeof(params) / sizeof(params[0]))
+
+static void report(const char* name, uint32_t elapsed)
+{
+	uint32_t commands = BENCH_ROUNDS * BENCH_COMMANDS;
+	printf("%-24s %6u commands in %7u ms: %7.1f commands/s\n", name, commands, elapsed, (commands * 1000.0) / elapsed);
+}
+
+static void benchSetters()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	uint32_t start = hostClock();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		orange.setDataRate(DATA_RATE_3);
+		orange.enableAdr(true);
+		orange.setRetx(7);
+		orange.setRxDelay1(5000);
+		orange.setPwrIdx(1);
+		orange.setBatLvl(15);
+	}
+	report("blocking setters", hostClock() - start);
+}
+
+static void benchBatch(uint8_t window)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	uint32_t start = hostClock();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		orange.beginBatch();
+		for (size_t i = 0; i < BENCH_COMMANDS; i++) orange.addToBatch(params[i], values[i]);
+		orange.commitBatch(window);
+	}
+
+	char name[32];
+	sprintf(name, "batch, window %u", window);
+	report(name, hostClock() - start);
+}
+
+int main()
+{
+	benchSetters();
+	for (uint8_t window = 1; window <= MAX_PENDING_COMMANDS; window++) benchBatch(window);
+	return 0;
+}
@@ -0,0 +1,75 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Response lines classified per second, in host time: the former scans of the success and error
+// keywords against ResponseClassifier, on the lines of a provisioning followed by uplinks
+
+#include "ResponseClassifier.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#define BENCH_ROUNDS		2000000
+
+static const char* successResponses[] = { "ok", "mac_tx_ok", "accepted", "mac_rx" };
+static const char* possibleResponses[] = { "invalid_param", "keys_not_init", "no_free_ch", "silent", "busy", "mac_paused",
+	"denied", "invalid_data_len", "frame_counter_err_rejoin_needed" };
+
+// about the mix of a device sending uplinks, with a few reads and errors
+static const char* lines[] = { "ok", "mac_tx_ok", "ok", "mac_tx_ok", "ok", "mac_rx 2 0102A0", "ok", "mac_tx_ok", "5", "ok",
+	"accepted", "ok", "no_free_ch", "0004A30B001A2B3C", "ok", "mac_tx_ok", "3312", "invalid_param", "ok", "mac_tx_ok" };
+#define BENCH_LINES			(sizeof(lines) / sizeof(lines[0]))
+
+static volatile int sink;
+
+// former checkSuccess() and checkErrors()
+static int scan(const char* line)
+{
+	for (size_t i = 0; i < sizeof(successResponses) / sizeof(successResponses[0]); i++)
+	{
+		if (strncmp(successResponses[i], line, strlen(successResponses[i])) == 0) return i;
+	}
+	for (size_t i = 0; i < sizeof(possibleResponses) / sizeof(possibleResponses[0]); i++)
+	{
+		if (strcmp(line, possibleResponses[i]) == 0) return 10 + i;
+	}
+	return -1;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double elapsed)
+{
+	printf("%-22s %8.1f million lines/s\n", name, (double)BENCH_ROUNDS * BENCH_LINES / elapsed / 1e6);
+}
+
+int main()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		for (size_t i = 0; i < BENCH_LINES; i++) sink = scan(lines[i]);
+	}
+	report("linear scans", seconds(start));
+
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		for (size_t i = 0; i < BENCH_LINES; i++) sink = ResponseClassifier::classify(lines[i]);
+	}
+	report("ResponseClassifier", seconds(start));
+	return 0;
+}
@@ -0,0 +1,84 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// "mac_rx" lines parsed and decoded per second in host time, with the String allocations of each: the
+// former parse through String against DownlinkMessage
+
+#include "DownlinkMessage.h"
+#include "HexCodec.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#define BENCH_ROUNDS		1000000
+
+static const char line[] = "mac_rx 2 0102A0FFCAFE00112233445566";
+
+class LineDownlink : public DownlinkMessageBuffer<DOWNLINK_BUFFER_SIZE>
+{
+public:
+	using DownlinkSink::setResponseMessage;
+};
+
+static uint8_t formerBuffer[DOWNLINK_BUFFER_SIZE * 2 + 1];
+static uint8_t formerPayload[DOWNLINK_BUFFER_SIZE];
+static volatile uint8_t sink;
+
+// former setResponseMessage() then getMessageByteArray()
+static void formerParse(const char* message)
+{
+	String msg_str = String(message);
+	int first_idx = msg_str.indexOf(' ');
+	String msgType = msg_str.substring(0, first_idx);
+	int second_idx = msg_str.indexOf(' ', first_idx + 1);
+	String port = msg_str.substring(first_idx + 1, second_idx);
+	String msg = msg_str.substring(second_idx + 1, msg_str.length());
+
+	sink = (uint8_t)port.toInt();
+	strcpy((char*)formerBuffer, msg.c_str());
+
+	int16_t decoded = HexCodec::decode((char*)formerBuffer, strlen((char*)formerBuffer), formerPayload);
+	if (decoded > 0) sink = formerPayload[0];
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double elapsed, uint32_t allocations)
+{
+	printf("%-18s %8.1f million lines/s %6.1f allocations/line\n", name, BENCH_ROUNDS / elapsed / 1e6,
+		(double)allocations / BENCH_ROUNDS);
+}
+
+int main()
+{
+	uint32_t allocations = hostStringAllocations();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++) formerParse(line);
+	report("String parse", seconds(start), hostStringAllocations() - allocations);
+
+	LineDownlink downlink;
+	allocations = hostStringAllocations();
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		uint16_t len;
+		downlink.setResponseMessage((uint8_t*)line);
+		const uint8_t* payload = downlink.getPayload(&len);
+		if (payload != NULL) sink = payload[0];
+	}
+	report("DownlinkMessage", seconds(start), hostStringAllocations() - allocations);
+	return 0;
+}
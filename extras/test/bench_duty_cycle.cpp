@@ -0,0 +1,67 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// 20 minutes of 20-byte uplinks at DR0 on a simulated module enforcing the dcycle of its channels: sleeping
+// until nextTxOpportunity() against retrying every 10 s and letting the module refuse
+
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+#include <stdio.h>
+
+#define BENCH_DURATION			(20 * 60000UL)
+#define BENCH_RETRY				10000
+#define BENCH_PAYLOAD			20
+
+typedef struct _sRun {
+	uint32_t uplinks;
+	uint32_t refused;						// "no_free_ch" answered by the module
+	uint32_t txCommands;
+}sRun;
+
+static sRun run(bool scheduled)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	module.enforceDutyCycle(true);
+	orange.rejoin();
+	orange.setDataRate(DATA_RATE_0);
+
+	// the library lets every uplink through, as before it tracked the duty cycle
+	orange.enforceDutyCycle(scheduled);
+
+	sRun result = { 0, 0, 0 };
+	uint8_t payload[BENCH_PAYLOAD] = { 0 };
+	uint32_t start = hostClock();
+	while (hostClock() - start < BENCH_DURATION)
+	{
+		delay(scheduled ? orange.nextTxOpportunity() : BENCH_RETRY);
+		if (orange.sendMessage(payload, sizeof(payload), 1)) result.uplinks++;
+	}
+	result.refused = module.noFreeChannel;
+	result.txCommands = module.countCommands("mac tx");
+	return result;
+}
+
+int main()
+{
+	sRun blind = run(false);
+	sRun scheduled = run(true);
+
+	printf("%-32s %8s %8s %10s\n", "", "uplinks", "refused", "mac tx");
+	printf("%-32s %8u %8u %10u\n", "retry every 10 s", blind.uplinks, blind.refused, blind.txCommands);
+	printf("%-32s %8u %8u %10u\n", "sleep until nextTxOpportunity()", scheduled.uplinks, scheduled.refused, scheduled.txCommands);
+	return 0;
+}
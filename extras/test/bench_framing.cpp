@@ -0,0 +1,116 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Bytes of "mac tx" commands framed per second, in host time: the former character by character
+// printing to the stream against the framing in one buffer written at once
+
+#include "OrangeForRN2483.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#define BENCH_FRAMES		200000
+
+// same conversion as the former writeHexString()
+#define NIBBLE_TO_HEX_CHAR(i)	((i <= 9) ? ('0' + i) : ('A' - 10 + i))
+
+class NullTransport : public RnTransport
+{
+public:
+	uint32_t bytes;
+	uint32_t calls;
+
+	NullTransport() : bytes(0), calls(0) {}
+
+	virtual int available() { return 0; }
+	virtual uint16_t read(uint8_t* buffer, uint16_t size) { return 0; }
+	virtual uint16_t write(const uint8_t* data, uint16_t len) { bytes += len; calls++; return len; }
+	virtual void sendBreak() {}
+};
+
+class NullStream : public Print
+{
+public:
+	uint32_t bytes;
+	uint32_t calls;
+
+	NullStream() : bytes(0), calls(0) {}
+
+	virtual size_t write(uint8_t c) { bytes++; calls++; return 1; }
+};
+
+// the framing of submitUplink(), without the command bookkeeping
+class FramingRequest : public RnRequestClass
+{
+public:
+	bool frameUplink(const uint8_t* payload, uint8_t len, uint8_t port)
+	{
+		if (!cmdRequest(MAC, CommandTable::name(TX_MAC), STR_UNCNF)) return false;
+		appendToFrame(SEPARATOR);
+		appendToFrame((uint32_t)port);
+		writeHexString(payload, len);
+		return sendFrame();
+	}
+};
+
+static void printUplink(Print* stream, const uint8_t* payload, uint8_t len, uint8_t port)
+{
+	stream->print("mac");
+	stream->print(SEPARATOR);
+	stream->print("tx");
+	stream->print(SEPARATOR);
+	stream->print(STR_UNCNF);
+	stream->print(SEPARATOR);
+	stream->print(port);
+	stream->print(SEPARATOR);
+	for (uint8_t i = 0; i < len; i++)
+	{
+		stream->print(static_cast<char>(NIBBLE_TO_HEX_CHAR((payload[i] >> 4) & 0x0F)));
+		stream->print(static_cast<char>(NIBBLE_TO_HEX_CHAR(payload[i] & 0x0F)));
+	}
+	stream->print(CRLF);
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void bench(uint8_t len)
+{
+	uint8_t payload[222];
+	for (uint8_t i = 0; i < len; i++) payload[i] = i * 37;
+
+	NullStream stream;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < BENCH_FRAMES; i++) printUplink(&stream, payload, len, 2);
+	double printed = seconds(start);
+
+	NullTransport transport;
+	FramingRequest request;
+	request.init(&transport);
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < BENCH_FRAMES; i++) request.frameUplink(payload, len, 2);
+	double framed = seconds(start);
+
+	printf("%3u bytes payload  print: %7.1f MB/s %4u calls/frame   single write: %7.1f MB/s %u call/frame\n", len,
+		stream.bytes / printed / 1e6, stream.calls / BENCH_FRAMES, transport.bytes / framed / 1e6, transport.calls / BENCH_FRAMES);
+}
+
+int main()
+{
+	bench(11);
+	bench(51);
+	bench(222);
+	return 0;
+}
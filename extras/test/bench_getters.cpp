@@ -0,0 +1,67 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Answers of the getters parsed per second in host time, with the String allocations of each: the former
+// String copies with toInt() and equals() against NumberParser and strcmp() on the response buffer
+
+#include "NumberParser.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#define BENCH_ROUNDS		1000000
+
+static const char* numbers[] = { "5", "7", "1000", "868100000", "3312", "-128", "4294967295" };
+#define BENCH_NUMBERS		(sizeof(numbers) / sizeof(numbers[0]))
+static const char* keywords[] = { "on", "off", "lora", "4/5", "0.5" };
+#define BENCH_KEYWORDS		(sizeof(keywords) / sizeof(keywords[0]))
+#define BENCH_VALUES		(BENCH_NUMBERS + BENCH_KEYWORDS)
+
+static volatile long sink;
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double elapsed, uint32_t allocations)
+{
+	printf("%-14s %8.1f million values/s %6.2f allocations/value\n", name, (double)BENCH_ROUNDS * BENCH_VALUES / elapsed / 1e6,
+		(double)allocations / BENCH_ROUNDS / BENCH_VALUES);
+}
+
+int main()
+{
+	uint32_t allocations = hostStringAllocations();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		for (size_t i = 0; i < BENCH_NUMBERS; i++) sink = String(numbers[i]).toInt();
+		for (size_t i = 0; i < BENCH_KEYWORDS; i++) sink = String(keywords[i]).equals("on");
+	}
+	report("String", seconds(start), hostStringAllocations() - allocations);
+
+	allocations = hostStringAllocations();
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		for (size_t i = 0; i < BENCH_NUMBERS; i++)
+		{
+			int32_t value;
+			sink = NumberParser::parseInt(numbers[i], &value) ? value : -1;
+		}
+		for (size_t i = 0; i < BENCH_KEYWORDS; i++) sink = (strcmp(keywords[i], "on") == 0);
+	}
+	report("in place", seconds(start), hostStringAllocations() - allocations);
+	return 0;
+}
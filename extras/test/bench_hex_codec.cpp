@@ -0,0 +1,92 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Hexadecimal conversions per second, in host time: the former per-character macros against HexCodec
+
+#include "HexCodec.h"
+
+#include <chrono>
+#include <stdio.h>
+
+#define BENCH_ROUNDS		200000
+#define BENCH_SIZE			222
+
+// former conversions of InternalConstForRN2483.h
+#define HEX_CHAR_TO_HIGH_NIBBLE(X) (((X >= 'A') ? X - 'A' + 10 : X - '0') << 4)
+#define HEX_CHAR_TO_LOW_NIBBLE(X) ((X >= 'A') ? X - 'A' + 10 : X - '0')
+#define NIBBLE_TO_HEX_CHAR(i) ((i <= 9) ? ('0' + i) : ('A' - 10 + i))
+#define HIGH_NIBBLE(i) ((i >> 4) & 0x0F)
+#define LOW_NIBBLE(i) (i & 0x0F)
+
+static volatile uint8_t sink;
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* name, double elapsed)
+{
+	printf("%-22s %8.1f MB/s of bytes\n", name, (double)BENCH_ROUNDS * BENCH_SIZE / elapsed / 1e6);
+}
+
+int main()
+{
+	uint8_t data[BENCH_SIZE];
+	char hex[2 * BENCH_SIZE];
+	for (int i = 0; i < BENCH_SIZE; i++) data[i] = i * 37;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		data[0] = round;
+		for (int i = 0; i < BENCH_SIZE; i++)
+		{
+			hex[2 * i] = NIBBLE_TO_HEX_CHAR(HIGH_NIBBLE(data[i]));
+			hex[(2 * i) + 1] = NIBBLE_TO_HEX_CHAR(LOW_NIBBLE(data[i]));
+		}
+		sink = hex[round % sizeof(hex)];
+	}
+	report("encode, macros", seconds(start));
+
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		data[0] = round;
+		HexCodec::encode(data, BENCH_SIZE, hex);
+		sink = hex[round % sizeof(hex)];
+	}
+	report("encode, HexCodec", seconds(start));
+
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		hex[0] = '0' + (round % 10);
+		for (int i = 0; i < BENCH_SIZE; i++)
+		{
+			data[i] = HEX_CHAR_TO_HIGH_NIBBLE(hex[2 * i]) | HEX_CHAR_TO_LOW_NIBBLE(hex[(2 * i) + 1]);
+		}
+		sink = data[round % BENCH_SIZE];
+	}
+	report("decode, macros", seconds(start));
+
+	start = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		hex[0] = '0' + (round % 10);
+		HexCodec::decode(hex, sizeof(hex), data);
+		sink = data[round % BENCH_SIZE];
+	}
+	report("decode, HexCodec", seconds(start));
+	return 0;
+}
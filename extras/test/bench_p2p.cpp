@@ -0,0 +1,62 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Sustained goodput of a P2PLink stream between two simulated modules over 10 minutes of virtual time, at
+// SF7/125 kHz: in the 1% and 10% sub-bands, and at 433 MHz where the EU868 duty cycle does not apply
+
+#include "SimulatedModule.h"
+#include "P2PLink.h"
+
+#include <stdio.h>
+
+#define BENCH_DURATION			(10 * 60000UL)
+
+static void run(const char* name, uint32_t frequency)
+{
+	SimulatedModule senderModule, receiverModule;
+	RnRequestClass senderRequest, receiverRequest;
+	OrangeForRN2483Class sender(&senderRequest), receiver(&receiverRequest);
+	sender.init(&senderModule);
+	receiver.init(&receiverModule);
+	senderModule.link(&receiverModule);
+
+	P2PLink senderLink(&sender), receiverLink(&receiver);
+	sP2PConfig config = { frequency, SF7, 125, CR_4_5, 14, DEFAULT_P2P_RX_WINDOW };
+	receiverLink.begin(config);
+	senderLink.begin(config);
+	senderLink.listen(false);
+
+	uint8_t data[P2P_TX_BUFFER_SIZE] = { 0 };
+	uint32_t start = hostClock();
+	while (hostClock() - start < BENCH_DURATION)
+	{
+		senderLink.write(data, sizeof(data));
+		senderLink.poll();
+		receiverLink.poll();
+		receiverLink.read(data, sizeof(data));
+	}
+
+	sP2PStats sent, received;
+	senderLink.getStats(&sent);
+	receiverLink.getStats(&received);
+	printf("%-22s %8u %8u %8u %10u\n", name, sent.packetsSent, received.lostPackets, sent.airtime, receiverLink.getGoodput());
+}
+
+int main()
+{
+	printf("%-22s %8s %8s %8s %10s\n", "", "packets", "lost", "airtime", "bytes/s");
+	run("868.1 MHz, 1%", 868100000);
+	run("869.525 MHz, 10%", 869525000);
+	run("433.175 MHz, no limit", 433175000);
+	return 0;
+}
@@ -0,0 +1,104 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Reading the radio configuration against a module simulated at 57600 bauds, in virtual time and without the
+// parameter cache: one blocking getter per field, then snapshot() with a growing window, compared to the time the
+// bytes alone take on the UART
+
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+#include <stdio.h>
+#include <string>
+
+#define BENCH_ROUNDS		100
+#define BENCH_BAUDRATE		57600
+
+static const char* fields[COUNT_RADIO_CFG] = { "mod", "freq", "pwr", "sf", "bw", "cr", "crc", "iqi", "sync", "prlen", "wdt", "snr" };
+
+static void report(const char* name, uint32_t elapsed, uint32_t transfer)
+{
+	printf("%-24s %7u ms, %6.2f ms/snapshot, %5.1f x the UART transfer\n", name, elapsed, (double)elapsed / BENCH_ROUNDS,
+		(double)elapsed / (BENCH_ROUNDS * transfer));
+}
+
+// bytes of the commands and of their responses, CRLF included, each way of the UART carrying its own
+static uint32_t transferTime(SimulatedModule& module)
+{
+	uint32_t commandBytes = 0;
+	uint32_t responseBytes = 0;
+	for (uint8_t i = 0; i < COUNT_RADIO_CFG; i++)
+	{
+		commandBytes += strlen("radio get ") + strlen(fields[i]) + 2;
+		responseBytes += module.get(std::string("radio ") + fields[i]).size() + 2;
+	}
+	uint32_t bytes = (commandBytes > responseBytes) ? commandBytes : responseBytes;
+	return ((bytes * 10 * 1000) + BENCH_BAUDRATE - 1) / BENCH_BAUDRATE;
+}
+
+static uint32_t benchGetters()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+	RadioCmdsClass* radio = orange.getRadioCmds();
+	uint32_t transfer = transferTime(module);
+
+	// the power has no getter, 11 fields out of 12
+	uint64_t watchdog;
+	uint32_t start = hostClock();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		radio->getModulation();
+		radio->getFrequency();
+		radio->getSF();
+		radio->getBandWidth();
+		radio->getCodingRate();
+		radio->getCrc();
+		radio->getIqInversion();
+		radio->getSync();
+		radio->getPreambleLength();
+		radio->getWatchdog(watchdog);
+		radio->getSigNoiseRation();
+	}
+	report("blocking getters", hostClock() - start, transfer);
+	return transfer;
+}
+
+static void benchSnapshot(uint8_t window)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+	uint32_t transfer = transferTime(module);
+
+	sRadioConfig config;
+	uint32_t start = hostClock();
+	for (int round = 0; round < BENCH_ROUNDS; round++) orange.getRadioCmds()->snapshot(&config, window);
+
+	char name[32];
+	sprintf(name, "snapshot, window %u", window);
+	report(name, hostClock() - start, transfer);
+}
+
+int main()
+{
+	uint32_t transfer = benchGetters();
+	for (uint8_t window = 1; window <= MAX_PENDING_COMMANDS; window++) benchSnapshot(window);
+	printf("UART transfer of the %u commands and responses: %u ms\n", COUNT_RADIO_CFG, transfer);
+	return 0;
+}
@@ -0,0 +1,130 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Time spent around a "sys sleep" on the virtual timeline of a simulated module: the former probes
+// of the module against the tracking of the sleep deadline
+
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+#include <stdio.h>
+
+#define BENCH_SLEEP			10000
+
+// the former "sys sleep" waiting for a response, and the former wakeUp() probing the module
+class ProbingRequest : public RnRequestClass
+{
+protected:
+	bool asleep;
+
+	bool probe()
+	{
+		if (!this->asleep) return false;
+		if (getResponse() == NULL) return true;
+		this->asleep = false;
+		return false;
+	}
+
+public:
+	ProbingRequest() : asleep(false) {}
+
+	void sleep(uint32_t duration)
+	{
+		char value[11];
+		sprintf(value, "%u", duration);
+		this->asleep = (rnRequest(SYS, CommandTable::name(SLEEP), NULL, value) == NULL);
+	}
+
+	void wakeUp()
+	{
+		if (probe())
+		{
+			setBreakCondition();
+			delay(100);
+			setWakeupFlag();
+			this->asleep = false;
+		}
+	}
+
+	void getDr()
+	{
+		wakeUp();
+		rnRequest(MAC, GET, "dr");
+	}
+};
+
+typedef struct _sTimes {
+	uint32_t enter;							// "sys sleep"
+	uint32_t early;							// getter while the module sleeps
+	uint32_t late;							// getter once the module woke up by itself
+}sTimes;
+
+static sTimes former()
+{
+	sTimes times;
+	SimulatedModule module;
+	ProbingRequest request;
+	request.init(&module);
+
+	uint32_t start = hostClock();
+	request.sleep(BENCH_SLEEP);
+	times.enter = hostClock() - start;
+
+	start = hostClock();
+	request.getDr();
+	times.early = hostClock() - start;
+
+	request.sleep(BENCH_SLEEP);
+	delay(BENCH_SLEEP + 100);
+	start = hostClock();
+	request.getDr();
+	times.late = hostClock() - start;
+	return times;
+}
+
+static sTimes deadline()
+{
+	sTimes times;
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+
+	uint32_t start = hostClock();
+	orange.getSysCmds()->sleep(BENCH_SLEEP);
+	times.enter = hostClock() - start;
+
+	start = hostClock();
+	orange.getDataRate();
+	times.early = hostClock() - start;
+
+	orange.getSysCmds()->sleep(BENCH_SLEEP);
+	delay(BENCH_SLEEP + 100);
+	start = hostClock();
+	orange.getDataRate();
+	times.late = hostClock() - start;
+	return times;
+}
+
+int main()
+{
+	sTimes before = former();
+	sTimes after = deadline();
+
+	printf("%-40s %8s %8s\n", "virtual ms", "probing", "deadline");
+	printf("%-40s %8u %8u\n", "sys sleep", before.enter, after.enter);
+	printf("%-40s %8u %8u\n", "getter on the sleeping module", before.early, after.early);
+	printf("%-40s %8u %8u\n", "getter once the module woke up", before.late, after.late);
+	return 0;
+}
@@ -0,0 +1,108 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Processing speed of the library in host time, over a session recorded against the simulated module and
+// played back by TraceReplayer: the replay only costs the processing of the library, the waits for the
+// module are skipped by the virtual time
+
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "TraceReplayer.h"
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#define BENCH_ROUNDS		2000
+#define SESSION_UPLINKS		20
+#define SESSION_GAP			(60UL * 1000)	// ms between two uplinks
+
+class TraceSink : public Print
+{
+public:
+	std::vector<uint8_t> bytes;
+
+	virtual size_t write(uint8_t c)
+	{
+		bytes.push_back(c);
+		return 1;
+	}
+};
+
+static void run(RnRequestClass& request, RnHandle handle)
+{
+	if (handle == RN_INVALID_HANDLE) return;
+	while (request.isBusy()) request.poll();
+}
+
+// setter, getter and confirmed uplink, one downlink every other uplink
+static void session(RnRequestClass& request, SimulatedModule* module)
+{
+	DownlinkMessage downlink;
+	request.setDownlinkSink(&downlink);
+
+	const uint8_t payload[] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08 };
+	for (int i = 0; i < SESSION_UPLINKS; i++)
+	{
+		std::string dr = std::to_string(i % 6);
+		run(request, request.submit(MAC, SET, "dr", dr.c_str()));
+		run(request, request.submit(MAC, GET, "dr", (const char*)NULL));
+
+		if ((module != NULL) && ((i % 2) == 0)) module->queueDownlink(2, "0102A0FFCAFE");
+		run(request, request.submitUplink(STR_CNF, payload, sizeof(payload), 1));
+		if (module != NULL) delay(SESSION_GAP);
+	}
+	request.setDownlinkSink(NULL);
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+	TraceSink sink;
+	uint32_t start = hostClock();
+	{
+		SimulatedModule module;
+		RnRequestClass request;
+		request.init(&module);
+		request.startRecording(&sink);
+		session(request, &module);
+		request.stopRecording();
+	}
+	uint32_t sessionTime = hostClock() - start;
+
+	uint32_t records = 0;
+	uint32_t mismatches = 0;
+	std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+	for (int round = 0; round < BENCH_ROUNDS; round++)
+	{
+		TraceReplayer replayer;
+		RnRequestClass request;
+		replayer.begin(sink.bytes.data(), sink.bytes.size());
+		request.init(&replayer);
+		request.setClock(TraceReplayer::clock, &replayer);
+		session(request, NULL);
+		records += replayer.getRecordCount();
+		mismatches += replayer.getMismatchCount();
+	}
+	double elapsed = seconds(hostStart);
+
+	printf("session: %u uplinks, %u ms, trace of %u bytes\n", SESSION_UPLINKS, sessionTime, (unsigned)sink.bytes.size());
+	printf("replay: %u rounds in %.3f s, %.2f us/record, %.2f us/uplink, %u mismatches\n", BENCH_ROUNDS, elapsed,
+		(elapsed * 1e6) / records, (elapsed * 1e6) / (BENCH_ROUNDS * SESSION_UPLINKS), mismatches);
+	return 0;
+}
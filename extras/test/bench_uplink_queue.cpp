@@ -0,0 +1,90 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// One hour of 8-byte records every 20 s at DR2 on a simulated module enforcing the duty cycle: one uplink per
+// record, the records not allowed by the duty cycle being lost, against packing them with UplinkQueue
+
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "UplinkQueue.h"
+
+#include <stdio.h>
+
+#define BENCH_DURATION			(60 * 60000UL)
+#define BENCH_PERIOD			20000
+#define BENCH_RECORD			8
+#define BENCH_MAX_AGE			(5 * 60000UL)
+
+typedef struct _sRun {
+	uint32_t records;
+	uint32_t delivered;
+	uint32_t uplinks;
+	uint32_t airtime;						// ms, time on air charged to the default channels
+	uint32_t efficiency;					// %, bytes of the records in the bytes sent
+}sRun;
+
+static sRun run(bool packed)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	module.enforceDutyCycle(true);
+	orange.setDataRate(DATA_RATE_2);
+	orange.rejoin();
+	uint32_t join = orange.getDutyCycle()->getAirtime(2);
+
+	UplinkQueue queue(1, &orange, BENCH_MAX_AGE);
+	sRun result = { 0, 0, 0, 0, 0 };
+	uint8_t record[BENCH_RECORD] = { 0 };
+	uint32_t start = hostClock();
+	while (hostClock() - start < BENCH_DURATION)
+	{
+		uint32_t next = hostClock() + BENCH_PERIOD;
+		result.records++;
+		if (packed)
+		{
+			queue.add(record, sizeof(record));
+			queue.poll();
+		}
+		else if ((orange.nextTxOpportunity() == 0) && orange.sendMessage(record, sizeof(record), 1)) result.delivered++;
+		delay(next - hostClock());
+	}
+
+	if (packed)
+	{
+		delay(orange.nextTxOpportunity());
+		queue.flush();
+		sUplinkQueueStats stats;
+		queue.getStats(&stats);
+		result.delivered = stats.records;
+		result.efficiency = queue.getPackingEfficiency();
+	}
+	else result.efficiency = (result.delivered == 0) ? 0 : (BENCH_RECORD * 100) / (BENCH_RECORD + LORAWAN_OVERHEAD);
+	result.uplinks = module.countCommands("mac tx");
+	result.airtime = orange.getDutyCycle()->getAirtime(2) - join;
+	return result;
+}
+
+int main()
+{
+	sRun single = run(false);
+	sRun packed = run(true);
+
+	printf("%-24s %8s %10s %8s %12s %11s\n", "", "records", "delivered", "uplinks", "airtime ms", "efficiency");
+	printf("%-24s %8u %10u %8u %12u %10u%%\n", "one uplink per record", single.records, single.delivered, single.uplinks,
+		single.airtime, single.efficiency);
+	printf("%-24s %8u %10u %8u %12u %10u%%\n", "UplinkQueue", packed.records, packed.delivered, packed.uplinks,
+		packed.airtime, packed.efficiency);
+	return 0;
+}
@@ -0,0 +1,39 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// RAM taken by each object of the library, part of the size_report target. Built for the SAMD21 and
+// never run: each object gives its size to a symbol, read back with nm.
+
+#include "OrangeForRN2483.h"
+#include "DownlinkQueue.h"
+#include "FragmentReassembler.h"
+#include "P2PLink.h"
+#include "ReliableSender.h"
+#include "UartTransport.h"
+#include "UplinkQueue.h"
+
+#define REPORT(type)		extern const char sizeof_##type[sizeof(type)]; const char sizeof_##type[sizeof(type)] = { 0 }
+
+REPORT(RnRequestClass);
+REPORT(OrangeForRN2483Class);
+REPORT(RadioCmdsClass);
+REPORT(SysCmdsClass);
+REPORT(ParamCache);
+REPORT(sRnStats);
+REPORT(DownlinkMessage);
+REPORT(DownlinkQueue);
+REPORT(UplinkQueue);
+REPORT(ReliableSender);
+REPORT(FragmentReassembler);
+REPORT(P2PLink);
+REPORT(UartTransport);
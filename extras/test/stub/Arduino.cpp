@@ -0,0 +1,457 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include <Arduino.h>
+
+#include <atomic>
+#include <stdio.h>
+
+// each thread drives its modules on its own timeline: a thread waiting for a duty cycle does not
+// move the clock of a thread waiting for a response
+static thread_local uint32_t virtualClock = 0;
+static std::atomic<uint32_t> stringAllocations(0);
+
+Uart Serial2;
+Uart SerialUSB;
+USBDeviceClass USBDevice;
+static HostUsb hostUsb;
+HostUsb* USB = &hostUsb;
+
+uint32_t millis()
+{
+	return virtualClock++;
+}
+
+uint32_t micros()
+{
+	return virtualClock * 1000;
+}
+
+void delay(uint32_t ms)
+{
+	virtualClock += ms;
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+}
+
+long random(long max)
+{
+	return (max <= 0) ? 0 : rand() % max;
+}
+
+long random(long min, long max)
+{
+	return (max <= min) ? min : min + (rand() % (max - min));
+}
+
+uint32_t hostClock()
+{
+	return virtualClock;
+}
+
+void hostAdvance(uint32_t ms)
+{
+	virtualClock += ms;
+}
+
+uint32_t hostStringAllocations()
+{
+	return stringAllocations;
+}
+
+void String::assign(const char* str, unsigned int length)
+{
+	free(this->buffer);
+	this->buffer = NULL;
+	this->len = 0;
+	append(str, length);
+}
+
+void String::append(const char* str, unsigned int length)
+{
+	if (length == 0) return;
+
+	char* grown = (char*)realloc(this->buffer, this->len + length + 1);
+	if (grown == NULL) return;
+	stringAllocations++;
+
+	memcpy(&grown[this->len], str, length);
+	this->len += length;
+	grown[this->len] = '\0';
+	this->buffer = grown;
+}
+
+String::String(const char* str) : buffer(NULL), len(0)
+{
+	if (str != NULL) append(str, strlen(str));
+}
+
+String::String(const String& other) : buffer(NULL), len(0)
+{
+	append(other.c_str(), other.len);
+}
+
+String::String(char c) : buffer(NULL), len(0)
+{
+	append(&c, 1);
+}
+
+// digits written backwards from the end of the buffer, which holds 66 characters
+static const char* formatInteger(char* digits, unsigned long long magnitude, bool negative, unsigned char base)
+{
+	int i = 65;
+
+	digits[i] = '\0';
+	do {
+		uint8_t digit = magnitude % base;
+		digits[--i] = (digit < 10) ? '0' + digit : 'A' + digit - 10;
+		magnitude /= base;
+	} while (magnitude != 0);
+	if (negative) digits[--i] = '-';
+
+	return &digits[i];
+}
+
+static void formatInteger(String* str, unsigned long long magnitude, bool negative, unsigned char base)
+{
+	char digits[66];
+	*str = formatInteger(digits, magnitude, negative, base);
+}
+
+String::String(unsigned char value, unsigned char base) : buffer(NULL), len(0)
+{
+	formatInteger(this, value, false, base);
+}
+
+String::String(int value, unsigned char base) : buffer(NULL), len(0)
+{
+	formatInteger(this, (value < 0) ? 0ULL - value : value, value < 0, base);
+}
+
+String::String(unsigned int value, unsigned char base) : buffer(NULL), len(0)
+{
+	formatInteger(this, value, false, base);
+}
+
+String::String(long value, unsigned char base) : buffer(NULL), len(0)
+{
+	formatInteger(this, (value < 0) ? 0ULL - value : value, value < 0, base);
+}
+
+String::String(unsigned long value, unsigned char base) : buffer(NULL), len(0)
+{
+	formatInteger(this, value, false, base);
+}
+
+String::String(long long value, unsigned char base) : buffer(NULL), len(0)
+{
+	formatInteger(this, (value < 0) ? 0ULL - value : value, value < 0, base);
+}
+
+String::String(unsigned long long value, unsigned char base) : buffer(NULL), len(0)
+{
+	formatInteger(this, value, false, base);
+}
+
+String::String(float value, unsigned char decimals) : buffer(NULL), len(0)
+{
+	char digits[48];
+	snprintf(digits, sizeof(digits), "%.*f", decimals, (double)value);
+	append(digits, strlen(digits));
+}
+
+String::String(double value, unsigned char decimals) : buffer(NULL), len(0)
+{
+	char digits[48];
+	snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+	append(digits, strlen(digits));
+}
+
+String::~String()
+{
+	free(this->buffer);
+}
+
+String& String::operator=(const String& other)
+{
+	if (this != &other) assign(other.c_str(), other.len);
+	return *this;
+}
+
+String& String::operator=(const char* str)
+{
+	assign(str, (str != NULL) ? strlen(str) : 0);
+	return *this;
+}
+
+String& String::operator+=(const String& other)
+{
+	append(other.c_str(), other.len);
+	return *this;
+}
+
+String& String::operator+=(const char* str)
+{
+	if (str != NULL) append(str, strlen(str));
+	return *this;
+}
+
+String& String::operator+=(char c)
+{
+	append(&c, 1);
+	return *this;
+}
+
+String operator+(const String& left, const String& right)
+{
+	String result(left);
+	result += right;
+	return result;
+}
+
+String operator+(const String& left, const char* right)
+{
+	String result(left);
+	result += right;
+	return result;
+}
+
+String operator+(const char* left, const String& right)
+{
+	String result(left);
+	result += right;
+	return result;
+}
+
+const char* String::c_str() const
+{
+	return (this->buffer != NULL) ? this->buffer : "";
+}
+
+unsigned int String::length() const
+{
+	return this->len;
+}
+
+bool String::equals(const String& other) const
+{
+	return strcmp(c_str(), other.c_str()) == 0;
+}
+
+bool String::equals(const char* str) const
+{
+	return strcmp(c_str(), (str != NULL) ? str : "") == 0;
+}
+
+bool String::operator==(const String& other) const
+{
+	return equals(other);
+}
+
+bool String::operator==(const char* str) const
+{
+	return equals(str);
+}
+
+bool String::operator!=(const char* str) const
+{
+	return !equals(str);
+}
+
+char String::charAt(unsigned int index) const
+{
+	return (index < this->len) ? this->buffer[index] : '\0';
+}
+
+char String::operator[](unsigned int index) const
+{
+	return charAt(index);
+}
+
+int String::indexOf(char c, unsigned int from) const
+{
+	for (unsigned int i = from; i < this->len; i++)
+	{
+		if (this->buffer[i] == c) return i;
+	}
+	return -1;
+}
+
+String String::substring(unsigned int from) const
+{
+	return substring(from, this->len);
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+	String result;
+	if (to > this->len) to = this->len;
+	if (from < to) result.append(&this->buffer[from], to - from);
+	return result;
+}
+
+bool String::startsWith(const char* prefix) const
+{
+	return strncmp(c_str(), prefix, strlen(prefix)) == 0;
+}
+
+long String::toInt() const
+{
+	return atol(c_str());
+}
+
+float String::toFloat() const
+{
+	return (float)atof(c_str());
+}
+
+void String::toCharArray(char* buf, unsigned int size) const
+{
+	if (size == 0) return;
+	strncpy(buf, c_str(), size - 1);
+	buf[size - 1] = '\0';
+}
+
+void String::getBytes(unsigned char* buf, unsigned int size) const
+{
+	toCharArray((char*)buf, size);
+}
+
+size_t Print::write(const uint8_t* buffer, size_t size)
+{
+	size_t n = 0;
+	while ((n < size) && (write(buffer[n]) == 1)) n++;
+	return n;
+}
+
+size_t Print::write(const char* str)
+{
+	return (str != NULL) ? write((const uint8_t*)str, strlen(str)) : 0;
+}
+
+size_t Print::print(const char* str)
+{
+	return write(str);
+}
+
+size_t Print::print(const String& str)
+{
+	return write(str.c_str());
+}
+
+size_t Print::print(char c)
+{
+	return write((uint8_t)c);
+}
+
+size_t Print::print(int value, int base)
+{
+	char digits[66];
+	return write(formatInteger(digits, (value < 0) ? 0ULL - value : value, value < 0, (unsigned char)base));
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+	char digits[66];
+	return write(formatInteger(digits, value, false, (unsigned char)base));
+}
+
+size_t Print::print(long value, int base)
+{
+	char digits[66];
+	return write(formatInteger(digits, (value < 0) ? 0ULL - value : value, value < 0, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+	char digits[66];
+	return write(formatInteger(digits, value, false, (unsigned char)base));
+}
+
+size_t Print::print(double value, int decimals)
+{
+	char digits[48];
+	snprintf(digits, sizeof(digits), "%.*f", decimals, value);
+	return write(digits);
+}
+
+size_t Print::println()
+{
+	return write("\r\n");
+}
+
+size_t Print::println(const char* str)
+{
+	return print(str) + println();
+}
+
+size_t Print::println(const String& str)
+{
+	return print(str) + println();
+}
+
+size_t Print::println(char c)
+{
+	return print(c) + println();
+}
+
+size_t Print::println(int value, int base)
+{
+	return print(value, base) + println();
+}
+
+size_t Print::println(unsigned int value, int base)
+{
+	return print(value, base) + println();
+}
+
+size_t Print::println(long value, int base)
+{
+	return print(value, base) + println();
+}
+
+size_t Print::println(unsigned long value, int base)
+{
+	return print(value, base) + println();
+}
+
+size_t Print::println(double value, int decimals)
+{
+	return print(value, decimals) + println();
+}
+
+size_t Uart::write(uint8_t c)
+{
+	return 1;
+}
+
+int Uart::available()
+{
+	return 0;
+}
+
+int Uart::read()
+{
+	return -1;
+}
+
+int Uart::peek()
+{
+	return -1;
+}
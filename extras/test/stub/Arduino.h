@@ -0,0 +1,203 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			Arduino.h
+* @brief		Minimal Arduino core for the host build of the tests
+* @details		Only what the library uses. Time is virtual: each call to millis() moves the clock 1 ms
+*				forward, so that the busy waits of the library end, and delay() jumps ahead. String
+*				allocates on the heap like the Arduino one and counts its allocations.
+*/
+
+#ifndef _HOST_ARDUINO_H
+#define _HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define PROGMEM
+#define pgm_read_byte(addr)		(*(const uint8_t*)(addr))
+#define pgm_read_word(addr)		(*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)	(*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)		(*(void* const*)(addr))
+
+#define DEC						10
+#define HEX						16
+#define LOW						0
+#define HIGH					1
+#define INPUT					0
+#define OUTPUT					1
+#define LORA_RESET				4
+
+// values of the SAMD RTC registers used by RTCZero.h
+#define RTC_MODE2_MASK_SEL_OFF_Val				0
+#define RTC_MODE2_MASK_SEL_SS_Val				1
+#define RTC_MODE2_MASK_SEL_MMSS_Val				2
+#define RTC_MODE2_MASK_SEL_HHMMSS_Val			3
+#define RTC_MODE2_MASK_SEL_DDHHMMSS_Val			4
+#define RTC_MODE2_MASK_SEL_MMDDHHMMSS_Val		5
+#define RTC_MODE2_MASK_SEL_YYMMDDHHMMSS_Val		6
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+long random(long max);
+long random(long min, long max);
+
+/**
+* @brief		Current virtual time in ms, without moving the clock
+* @details		millis() returns the virtual time and moves it 1 ms forward. The clock is per thread
+*/
+uint32_t hostClock();
+
+/**
+* @brief		Moving the virtual clock forward
+*/
+void hostAdvance(uint32_t ms);
+
+/**
+* @brief		Number of heap allocations made by String objects since the start
+*/
+uint32_t hostStringAllocations();
+
+class String
+{
+protected:
+	char* buffer;
+	unsigned int len;
+
+	void assign(const char* str, unsigned int length);
+	void append(const char* str, unsigned int length);
+
+public:
+	String(const char* str = "");
+	String(const String& other);
+	explicit String(char c);
+	explicit String(unsigned char value, unsigned char base = DEC);
+	explicit String(int value, unsigned char base = DEC);
+	explicit String(unsigned int value, unsigned char base = DEC);
+	explicit String(long value, unsigned char base = DEC);
+	explicit String(unsigned long value, unsigned char base = DEC);
+	explicit String(long long value, unsigned char base = DEC);
+	explicit String(unsigned long long value, unsigned char base = DEC);
+	explicit String(float value, unsigned char decimals = 2);
+	explicit String(double value, unsigned char decimals = 2);
+	~String();
+
+	String& operator=(const String& other);
+	String& operator=(const char* str);
+	String& operator+=(const String& other);
+	String& operator+=(const char* str);
+	String& operator+=(char c);
+	friend String operator+(const String& left, const String& right);
+	friend String operator+(const String& left, const char* right);
+	friend String operator+(const char* left, const String& right);
+
+	const char* c_str() const;
+	unsigned int length() const;
+	bool equals(const String& other) const;
+	bool equals(const char* str) const;
+	bool operator==(const String& other) const;
+	bool operator==(const char* str) const;
+	bool operator!=(const char* str) const;
+	char charAt(unsigned int index) const;
+	char operator[](unsigned int index) const;
+	int indexOf(char c, unsigned int from = 0) const;
+	String substring(unsigned int from) const;
+	String substring(unsigned int from, unsigned int to) const;
+	bool startsWith(const char* prefix) const;
+	long toInt() const;
+	float toFloat() const;
+	void toCharArray(char* buf, unsigned int size) const;
+	void getBytes(unsigned char* buf, unsigned int size) const;
+};
+
+class Print
+{
+public:
+	virtual ~Print() {}
+
+	virtual size_t write(uint8_t c) = 0;
+	virtual size_t write(const uint8_t* buffer, size_t size);
+	size_t write(const char* str);
+
+	size_t print(const char* str);
+	size_t print(const String& str);
+	size_t print(char c);
+	size_t print(int value, int base = DEC);
+	size_t print(unsigned int value, int base = DEC);
+	size_t print(long value, int base = DEC);
+	size_t print(unsigned long value, int base = DEC);
+	size_t print(double value, int decimals = 2);
+	size_t println();
+	size_t println(const char* str);
+	size_t println(const String& str);
+	size_t println(char c);
+	size_t println(int value, int base = DEC);
+	size_t println(unsigned int value, int base = DEC);
+	size_t println(long value, int base = DEC);
+	size_t println(unsigned long value, int base = DEC);
+	size_t println(double value, int decimals = 2);
+};
+
+class Stream : public Print
+{
+public:
+	virtual int available() = 0;
+	virtual int read() = 0;
+	virtual int peek() = 0;
+	virtual void flush() {}
+	virtual void begin(unsigned long baudrate) {}
+};
+
+/**
+* \brief     UART without anything connected, the tests use their own transports
+*/
+class Uart : public Stream
+{
+public:
+	virtual size_t write(uint8_t c);
+	using Print::write;
+	virtual int available();
+	virtual int read();
+	virtual int peek();
+};
+
+class USBDeviceClass
+{
+public:
+	void attach() {}
+	void detach() {}
+};
+
+typedef struct {
+	struct {
+		struct {
+			struct {
+				volatile uint8_t UPRSM;
+			} bit;
+		} CTRLB;
+	} DEVICE;
+} HostUsb;
+
+extern Uart Serial2;
+extern Uart SerialUSB;
+extern USBDeviceClass USBDevice;
+extern HostUsb* USB;
+
+#endif
@@ -0,0 +1,93 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// RTC of the host build: standbyMode() jumps to the alarm without moving millis(),
+// which stops in the standby mode of the SAMD
+
+#include "RTCZero.h"
+
+static uint32_t rtcSeconds = 0;				// time of the day, days from the 1st of the month
+static uint32_t alarmSeconds = 0;
+static voidFuncPtr alarmCallback = NULL;
+
+RTCZero::RTCZero()
+{
+	_configured = false;
+}
+
+void RTCZero::begin(bool resetTime)
+{
+	_configured = true;
+	if (resetTime) rtcSeconds = 0;
+}
+
+void RTCZero::enableAlarm(Alarm_Match match)
+{
+}
+
+void RTCZero::disableAlarm()
+{
+}
+
+void RTCZero::attachInterrupt(voidFuncPtr callback)
+{
+	alarmCallback = callback;
+}
+
+void RTCZero::detachInterrupt()
+{
+	alarmCallback = NULL;
+}
+
+void RTCZero::standbyMode()
+{
+	// the alarm matches the time of the day, the next day if it is already past
+	uint32_t now = rtcSeconds % 86400;
+	rtcSeconds += (alarmSeconds >= now) ? alarmSeconds - now : 86400 - now + alarmSeconds;
+	if (alarmCallback != NULL) alarmCallback();
+}
+
+uint8_t RTCZero::getSeconds()
+{
+	return rtcSeconds % 60;
+}
+
+uint8_t RTCZero::getMinutes()
+{
+	return (rtcSeconds / 60) % 60;
+}
+
+uint8_t RTCZero::getHours()
+{
+	return (rtcSeconds / 3600) % 24;
+}
+
+uint8_t RTCZero::getDay()
+{
+	return 1 + (rtcSeconds / 86400);
+}
+
+void RTCZero::setTime(uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+	rtcSeconds = ((rtcSeconds / 86400) * 86400) + (hours * 3600UL) + (minutes * 60UL) + seconds;
+}
+
+void RTCZero::setDate(uint8_t day, uint8_t month, uint8_t year)
+{
+	rtcSeconds = ((day - 1) * 86400UL) + (rtcSeconds % 86400);
+}
+
+void RTCZero::setAlarmTime(uint8_t hours, uint8_t minutes, uint8_t seconds)
+{
+	alarmSeconds = (hours * 3600UL) + (minutes * 60UL) + seconds;
+}
@@ -0,0 +1,106 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Batch of "mac set" commands: order on the wire, per-command results and pipelining
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+static void fillBatch(OrangeForRN2483Class& orange)
+{
+	const uint8_t appKey[16] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF };
+
+	orange.beginBatch();
+	CHECK(orange.addToBatch(DATARATE, "3"));
+	CHECK(orange.addToBatch(ADR, "on"));
+	CHECK(orange.addToBatch(RETRANS_NB, "99"));
+	CHECK(orange.addToBatch(RX_DELAY_1, "5000"));
+	CHECK(orange.addToBatch(APP_KEY, appKey, sizeof(appKey)));
+}
+
+static void testResults()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	module.script("mac set retx 99", "invalid_param");
+
+	fillBatch(orange);
+	size_t first = module.commands.size();
+	CHECK_EQUAL(1, orange.commitBatch());
+
+	CHECK_EQUAL(first + 5, module.commands.size());
+	CHECK_STRING("mac set dr 3", module.commands[first].c_str());
+	CHECK_STRING("mac set adr on", module.commands[first + 1].c_str());
+	CHECK_STRING("mac set retx 99", module.commands[first + 2].c_str());
+	CHECK_STRING("mac set rxdelay1 5000", module.commands[first + 3].c_str());
+	CHECK_STRING("mac set appkey 00112233445566778899AABBCCDDEEFF", module.commands[first + 4].c_str());
+
+	CHECK_EQUAL(LORA_SUCCESS, orange.getBatchResult(0));
+	CHECK_EQUAL(LORA_SUCCESS, orange.getBatchResult(1));
+	CHECK_EQUAL(LORA_INVALID_PARAM, orange.getBatchResult(2));
+	CHECK_EQUAL(LORA_SUCCESS, orange.getBatchResult(3));
+	CHECK_EQUAL(LORA_SUCCESS, orange.getBatchResult(4));
+	CHECK_EQUAL(LORA_INVALID_PARAM, orange.getBatchResult(5));
+	std::string adr = module.get("mac adr");
+	CHECK_STRING("on", adr.c_str());
+}
+
+static void testFullBatch()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	orange.beginBatch();
+	for (uint8_t i = 0; i < MAX_BATCH_COMMANDS; i++) CHECK(orange.addToBatch(RETRANS_NB, "1"));
+	CHECK(!orange.addToBatch(RETRANS_NB, "1"));
+
+	char tooLong[MAX_BATCH_VALUE_SIZE + 1];
+	memset(tooLong, '0', MAX_BATCH_VALUE_SIZE);
+	tooLong[MAX_BATCH_VALUE_SIZE] = '\0';
+	orange.beginBatch();
+	CHECK(!orange.addToBatch(APP_KEY, tooLong));
+}
+
+static uint32_t commitTime(uint8_t window)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	fillBatch(orange);
+	uint32_t start = hostClock();
+	CHECK_EQUAL(0, orange.commitBatch(window));
+	return hostClock() - start;
+}
+
+static void testPipelining()
+{
+	// the next command is on the wire while the module answers the previous one
+	uint32_t sequential = commitTime(1);
+	uint32_t pipelined = commitTime(DEFAULT_BATCH_WINDOW);
+	CHECK(pipelined < sequential);
+}
+
+int main()
+{
+	testResults();
+	testFullBatch();
+	testPipelining();
+	return TEST_RESULT();
+}
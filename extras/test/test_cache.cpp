@@ -0,0 +1,153 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Parameter cache: hits and misses, write-through of the setters, bypass of one getter, and the
+// invalidation by mac tx, mac join, an unsolicited mac_rx and a reset
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+static void run(RnRequestClass& request, RnHandle handle)
+{
+	CHECK(handle != RN_INVALID_HANDLE);
+	while (request.isBusy()) request.poll();
+}
+
+static void testHitMiss()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	request.resetStats();
+
+	size_t reads = module.countCommands("mac get dr");
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(reads + 1, module.countCommands("mac get dr"));
+
+	sRnStats stats;
+	request.getStats(&stats);
+	CHECK_EQUAL(1, stats.cacheMisses);
+	CHECK_EQUAL(1, stats.cacheHits);
+
+	// changed behind the library, the cached value is kept until refreshed
+	module.set("mac dr", "2");
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(DATA_RATE_2, orange.refresh().getDataRate());
+	CHECK_EQUAL(DATA_RATE_2, orange.getDataRate());
+	CHECK_EQUAL(reads + 2, module.countCommands("mac get dr"));
+
+	// a bypass is neither a hit nor a miss, and only applies to the next command
+	request.getStats(&stats);
+	CHECK_EQUAL(1, stats.cacheMisses);
+	CHECK_EQUAL(3, stats.cacheHits);
+	orange.refresh();
+	CHECK(orange.setRetx(3));
+	CHECK_EQUAL(DATA_RATE_2, orange.getDataRate());
+	CHECK_EQUAL(reads + 2, module.countCommands("mac get dr"));
+}
+
+static void testWriteThrough()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	size_t reads = module.countCommands("mac get dr");
+	CHECK(orange.setDataRate(DATA_RATE_3));
+	CHECK_EQUAL(DATA_RATE_3, orange.getDataRate());
+	CHECK_EQUAL(reads, module.countCommands("mac get dr"));
+
+	// a value the module refuses is not cached
+	module.script("mac set dr 1", "invalid_param");
+	CHECK(!orange.setDataRate(DATA_RATE_1));
+	CHECK_EQUAL(DATA_RATE_3, orange.getDataRate());
+	CHECK_EQUAL(reads + 1, module.countCommands("mac get dr"));
+}
+
+static void testDisabled()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+	request.resetStats();
+
+	size_t reads = module.countCommands("mac get dr");
+	orange.getDataRate();
+	orange.getDataRate();
+	CHECK_EQUAL(reads + 2, module.countCommands("mac get dr"));
+
+	sRnStats stats;
+	request.getStats(&stats);
+	CHECK_EQUAL(0, stats.cacheMisses);
+	CHECK_EQUAL(0, stats.cacheHits);
+}
+
+// counts the commands sent to read the data rate, changed by the network, and ADR, set by the device only
+static void readBoth(SimulatedModule& module, OrangeForRN2483Class& orange, size_t* dataRateReads, size_t* adrReads)
+{
+	orange.getDataRate();
+	orange.isAdr();
+	*dataRateReads = module.countCommands("mac get dr");
+	*adrReads = module.countCommands("mac get adr");
+}
+
+static void testInvalidation()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	size_t dataRateReads;
+	size_t adrReads;
+	readBoth(module, orange, &dataRateReads, &adrReads);
+
+	const uint8_t payload[] = { 0x01 };
+	run(request, request.submitUplink(STR_UNCNF, payload, sizeof(payload), 1));
+	readBoth(module, orange, &dataRateReads, &adrReads);
+	readBoth(module, orange, &dataRateReads, &adrReads);
+	CHECK_EQUAL(2, dataRateReads);
+	CHECK_EQUAL(1, adrReads);
+
+	run(request, request.submit(MAC, CommandTable::name(JOIN), "abp", (const char*)NULL));
+	readBoth(module, orange, &dataRateReads, &adrReads);
+	CHECK_EQUAL(3, dataRateReads);
+	CHECK_EQUAL(1, adrReads);
+
+	// a downlink received after the uplink completed
+	module.emit("mac_rx 3 AB");
+	for (int i = 0; i < 10; i++) request.poll();
+	readBoth(module, orange, &dataRateReads, &adrReads);
+	CHECK_EQUAL(4, dataRateReads);
+	CHECK_EQUAL(1, adrReads);
+
+	run(request, request.submit(SYS, CommandTable::name(RESET), NULL, (const char*)NULL));
+	readBoth(module, orange, &dataRateReads, &adrReads);
+	CHECK_EQUAL(5, dataRateReads);
+	CHECK_EQUAL(2, adrReads);
+}
+
+int main()
+{
+	testHitMiss();
+	testWriteThrough();
+	testDisabled();
+	testInvalidation();
+	return TEST_RESULT();
+}
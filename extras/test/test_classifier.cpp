@@ -0,0 +1,117 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Response classifier: keywords, values looking like keywords, and the reset banner against the answer of "sys get ver"
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+typedef struct _sKeyword {
+	const char* line;
+	eResponseToken token;
+	eSuccessType successType;
+	eErrorType errorType;
+}sKeyword;
+
+static const sKeyword keywords[] = {
+	{ "ok", RESP_OK, LORA_OK, LORA_SUCCESS },
+	{ "mac_tx_ok", RESP_MAC_TX_OK, LORA_MAC_TX_OK, LORA_SUCCESS },
+	{ "accepted", RESP_ACCEPTED, LORA_ACCEPTED, LORA_SUCCESS },
+	{ "mac_rx 1 CAFE", RESP_MAC_RX, LORA_RX, LORA_SUCCESS },
+	{ "mac_err", RESP_MAC_ERR, LORA_FAILED, LORA_MAC_ERR },
+	{ "radio_tx_ok", RESP_RADIO_TX_OK, LORA_RADIO_TX_OK, LORA_SUCCESS },
+	{ "radio_rx  CAFE", RESP_RADIO_RX, LORA_RADIO_RX, LORA_SUCCESS },
+	{ "radio_err", RESP_RADIO_ERR, LORA_FAILED, LORA_RADIO_ERR },
+	{ SIMULATED_VERSION, RESP_RESET_BANNER, LORA_FAILED, LORA_SUCCESS },
+	{ "invalid_param", RESP_INVALID_PARAM, LORA_FAILED, LORA_INVALID_PARAM },
+	{ "keys_not_init", RESP_KEYS_NOT_INIT, LORA_FAILED, LORA_KEYS_NOT_INIT },
+	{ "no_free_ch", RESP_NO_FREE_CH, LORA_FAILED, LORA_NO_FREE_CH },
+	{ "silent", RESP_SILENT, LORA_FAILED, LORA_SILENT },
+	{ "busy", RESP_BUSY, LORA_FAILED, LORA_BUSY },
+	{ "mac_paused", RESP_MAC_PAUSED, LORA_FAILED, LORA_MAC_PAUSED },
+	{ "denied", RESP_DENIED, LORA_FAILED, LORA_JOIN_DENIED },
+	{ "invalid_data_len", RESP_INVALID_DATA_LEN, LORA_FAILED, LORA_INVALID_DATA_LEN },
+	{ "frame_counter_err_rejoin_needed", RESP_FRAME_COUNTER_ERR, LORA_FAILED, LORA_ERR_FRAME_CNTR_ERR_REJOIN_NEEDED },
+};
+
+// values answered by "get" commands, and keywords with a character more or less
+static const char* values[] = { "", "5", "on", "off", "sf12", "4/5", "4294967245", "0004A30B001A2B3C", "o", "oK",
+	"okay", "ok ", "mac_tx_ok2", "mac_rx", "mac_", "mac_txok", "radio_", "radio_rx", "radio_tx_okay", "invalid_",
+	"invalid_params", "RN2483", "rn2483 1.0.5", "busyness", "silen", "deniedx", "no_free_c", "keys_not_ini" };
+
+static void testKeywords()
+{
+	for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++)
+	{
+		eResponseToken token = ResponseClassifier::classify(keywords[i].line);
+		CHECK_EQUAL(keywords[i].token, token);
+		CHECK_EQUAL(keywords[i].successType, ResponseClassifier::getSuccessType(token));
+		CHECK_EQUAL(keywords[i].errorType, ResponseClassifier::getErrorType(token));
+	}
+}
+
+static void testValues()
+{
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+	{
+		if (ResponseClassifier::classify(values[i]) != RESP_VALUE) printf("\"%s\" taken for a keyword\n", values[i]);
+		CHECK_EQUAL(RESP_VALUE, ResponseClassifier::classify(values[i]));
+	}
+	CHECK_EQUAL(LORA_FAILED, ResponseClassifier::getSuccessType(RESP_VALUE));
+	CHECK_EQUAL(LORA_SUCCESS, ResponseClassifier::getErrorType(RESP_VALUE));
+}
+
+static uint8_t banners;
+
+static void onEvent(eResponseToken token, uint8_t* line, void* context)
+{
+	if (token == RESP_RESET_BANNER) banners++;
+}
+
+static void testVersionAnswer()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(true);
+	request.addEventHandler(onEvent);
+	banners = 0;
+
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(1, module.countCommands("mac get dr"));
+
+	// the answer looks like the banner, but it is not a reset
+	String version = orange.getSysCmds()->getVersion();
+	CHECK_STRING(SIMULATED_VERSION, version.c_str());
+	CHECK_EQUAL(0, banners);
+	CHECK(orange.getJoinState() == false);
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(1, module.countCommands("mac get dr"));
+
+	// a real reset, while no command is pending
+	module.emit(SIMULATED_VERSION);
+	request.poll();
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(1, banners);
+	CHECK_EQUAL(2, module.countCommands("mac get dr"));
+}
+
+int main()
+{
+	testKeywords();
+	testValues();
+	testVersionAnswer();
+	return TEST_RESULT();
+}
@@ -0,0 +1,166 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Asynchronous command engine: submission, poll()-driven completion, final responses and timeouts
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+static uint8_t completions;
+static eSuccessType lastSuccess;
+static eErrorType lastError;
+static char lastResponse[DEFAULT_INPUT_BUFFER_SIZE];
+
+static void onDone(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context)
+{
+	completions++;
+	lastSuccess = successType;
+	lastError = errorType;
+	strcpy(lastResponse, (response != NULL) ? (char*)response : "");
+}
+
+static void testGet()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	request.init(&module);
+	completions = 0;
+
+	RnHandle handle = request.submit(MAC, GET, "dr", (const char*)NULL, onDone);
+	CHECK(handle != RN_INVALID_HANDLE);
+	CHECK_EQUAL(CMD_SENT, request.getCommandState(handle));
+	CHECK_EQUAL(0, completions);
+
+	while (request.isBusy()) request.poll();
+
+	CHECK_EQUAL(CMD_DONE, request.getCommandState(handle));
+	CHECK_EQUAL(1, completions);
+	CHECK_EQUAL(LORA_SUCCESS, lastError);
+	CHECK_STRING("5", lastResponse);
+	CHECK_STRING("mac get dr", module.commands.back().c_str());
+}
+
+static void testUplink()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	request.init(&module);
+	completions = 0;
+
+	const uint8_t payload[] = { 0x01, 0x02, 0x03, 0x04 };
+	uint32_t start = hostClock();
+	RnHandle handle = request.submitUplink(STR_UNCNF, payload, sizeof(payload), 2, onDone);
+	CHECK(handle != RN_INVALID_HANDLE);
+
+	// the application keeps running between the "ok" and "mac_tx_ok"
+	bool waitedFinal = false;
+	uint32_t loops = 0;
+	while (request.isBusy())
+	{
+		request.poll();
+		if (request.getCommandState(handle) == CMD_WAIT_FINAL) waitedFinal = true;
+		loops++;
+	}
+
+	CHECK(waitedFinal);
+	CHECK(loops > 100);
+	CHECK(hostClock() - start >= TimeOnAir::dataFrame(DATA_RATE_5, sizeof(payload)));
+	CHECK_EQUAL(1, completions);
+	CHECK_EQUAL(LORA_MAC_TX_OK, lastSuccess);
+	CHECK_EQUAL(LORA_SUCCESS, lastError);
+	CHECK_STRING("mac tx uncnf 2 01020304", module.commands.back().c_str());
+}
+
+static void testDownlink()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	request.init(&module);
+	completions = 0;
+	module.queueDownlink(3, "CAFE");
+
+	const uint8_t payload[] = { 0x2A };
+	request.submitUplink(STR_CNF, payload, sizeof(payload), 1, onDone);
+	while (request.isBusy()) request.poll();
+
+	CHECK_EQUAL(1, completions);
+	CHECK_EQUAL(LORA_RX, lastSuccess);
+	CHECK_EQUAL(LORA_SUCCESS, lastError);
+}
+
+static void testTimeout()
+{
+	// nothing answers
+	LoopbackTransport silent;
+	RnRequestClass request;
+	request.init(&silent);
+	completions = 0;
+
+	uint32_t start = hostClock();
+	request.submit(MAC, GET, "dr", (const char*)NULL, onDone);
+	while (request.isBusy()) request.poll();
+
+	CHECK_EQUAL(1, completions);
+	CHECK_EQUAL(LORA_FAILED, lastSuccess);
+	CHECK_EQUAL(LORA_TIMEOUT, lastError);
+	CHECK(hostClock() - start >= DEFAULT_TIMEOUT);
+}
+
+static void testOneFinalResponseAtATime()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	request.init(&module);
+	request.setPipelineDepth(MAX_PENDING_COMMANDS);
+
+	const uint8_t payload[] = { 0x01 };
+	CHECK(request.submitUplink(STR_UNCNF, payload, sizeof(payload), 1) != RN_INVALID_HANDLE);
+	CHECK_EQUAL(RN_INVALID_HANDLE, request.submit(MAC, GET, "dr", (const char*)NULL));
+	CHECK_EQUAL(LORA_BUSY, orange.getLastError());
+
+	while (request.isBusy()) request.poll();
+	CHECK(request.submit(MAC, GET, "dr", (const char*)NULL) != RN_INVALID_HANDLE);
+	while (request.isBusy()) request.poll();
+}
+
+static void testBlockingWrappers()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	CHECK(orange.rejoin());
+	CHECK_EQUAL(1, module.countCommands("mac join otaa"));
+
+	// the join is charged to the duty cycle like an uplink
+	CHECK(orange.getDutyCycle()->getAirtime(2) > 0);
+	delay(orange.nextTxOpportunity());
+
+	uint8_t payload[] = { 0x10, 0x20 };
+	CHECK(orange.sendMessage(payload, sizeof(payload), 5));
+	CHECK_EQUAL(1, module.countCommands("mac tx uncnf 5 1020"));
+}
+
+int main()
+{
+	testGet();
+	testUplink();
+	testDownlink();
+	testTimeout();
+	testOneFinalResponseAtATime();
+	testBlockingWrappers();
+	return TEST_RESULT();
+}
@@ -0,0 +1,218 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Downlink dispatch: order of the port ranges, downlinks queued during a series of uplinks and handed over by
+// poll(), wrap-around of the DownlinkQueue pool and downlinks lost when the queue is full
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "DownlinkQueue.h"
+#include "HexCodec.h"
+
+#include <string>
+#include <vector>
+
+// handler name, port and hexadecimal payload of each call
+typedef struct _sCall {
+	char handler;
+	uint8_t port;
+	std::string hex;
+}sCall;
+
+static std::vector<sCall> calls;
+
+static void record(char handler, uint8_t port, const uint8_t* payload, uint16_t len)
+{
+	char hex[(2 * DOWNLINK_BUFFER_SIZE) + 1];
+	hex[HexCodec::encode(payload, len, hex)] = '\0';
+	sCall call = { handler, port, hex };
+	calls.push_back(call);
+}
+
+static void handlerA(uint8_t port, const uint8_t* payload, uint16_t len, void* context) { record('A', port, payload, len); }
+static void handlerB(uint8_t port, const uint8_t* payload, uint16_t len, void* context) { record('B', port, payload, len); }
+static void handlerC(uint8_t port, const uint8_t* payload, uint16_t len, void* context) { record('C', port, payload, len); }
+
+// a downlink received while no uplink is running
+static void receive(SimulatedModule& module, RnRequestClass& request, const std::string& line)
+{
+	module.emit(line);
+	for (int i = 0; i < 10; i++) request.poll();
+}
+
+static void testRangeOrder()
+{
+	calls.clear();
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	// the first bound range containing the port wins, whatever its width
+	CHECK(orange.onDownlink(10, 20, handlerA));
+	CHECK(orange.onDownlink(15, handlerB));
+	CHECK(orange.onDownlink(1, 223, handlerC));
+	CHECK(!orange.onDownlink(30, 20, handlerA));
+
+	receive(module, request, "mac_rx 15 01");
+	receive(module, request, "mac_rx 5 02");
+	receive(module, request, "mac_rx 20 03");
+	CHECK_EQUAL(0, calls.size());
+	CHECK_EQUAL(3, orange.dispatchDownlinks());
+	CHECK_EQUAL(3, calls.size());
+	CHECK_EQUAL('A', calls[0].handler);
+	CHECK_EQUAL('C', calls[1].handler);
+	CHECK_EQUAL('A', calls[2].handler);
+
+	// the next range takes over once a handler is removed
+	orange.removeDownlinkHandler(handlerA);
+	receive(module, request, "mac_rx 15 04");
+	receive(module, request, "mac_rx 224 05");
+	orange.poll();
+	CHECK_EQUAL(4, calls.size());
+	CHECK_EQUAL('B', calls[3].handler);
+	CHECK_STRING("04", calls[3].hex.c_str());
+
+	sDownlinkStats stats;
+	orange.getDownlinkStats(&stats);
+	CHECK_EQUAL(5, stats.queued);
+	CHECK_EQUAL(4, stats.dispatched);
+	CHECK_EQUAL(1, stats.unhandled);
+}
+
+static void testQueuedDuringUplinks()
+{
+	calls.clear();
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enforceDutyCycle(false);
+	CHECK(orange.rejoin());
+	CHECK(orange.onDownlink(1, 223, handlerA));
+
+	// never handed over inside the blocking uplinks
+	uint8_t payload[] = { 0x01 };
+	module.queueDownlink(2, "0A");
+	CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	module.queueDownlink(3, "0B0C");
+	CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	CHECK_EQUAL(0, calls.size());
+
+	// in the order they were received
+	orange.poll();
+	CHECK_EQUAL(2, calls.size());
+	CHECK_EQUAL(2, calls[0].port);
+	CHECK_STRING("0A", calls[0].hex.c_str());
+	CHECK_EQUAL(3, calls[1].port);
+	CHECK_STRING("0B0C", calls[1].hex.c_str());
+
+	// the last downlink is still readable the usual way
+	uint16_t len = 0;
+	CHECK(orange.getDownlinkMessage()->getPayload(&len) != NULL);
+	CHECK_EQUAL(2, len);
+
+	sDownlinkStats stats;
+	orange.getDownlinkStats(&stats);
+	CHECK_EQUAL(2, stats.queued);
+	CHECK_EQUAL(2, stats.dispatched);
+	CHECK_EQUAL(2, stats.maxDepth);
+}
+
+static void testWrapAround()
+{
+	DownlinkQueue queue;
+	uint8_t payload[DOWNLINK_QUEUE_BYTES * 2 / 5];
+	const uint8_t* data = NULL;
+
+	// 2 payloads of 2/5 of the pool, the third one goes back to the start of the pool once the first one is read
+	for (uint8_t i = 0; i < 2; i++)
+	{
+		memset(payload, i, sizeof(payload));
+		CHECK(queue.push(i, payload, sizeof(payload)));
+	}
+	memset(payload, 2, sizeof(payload));
+	CHECK(!queue.push(2, payload, sizeof(payload)));
+	queue.pop();
+	CHECK(queue.push(2, payload, sizeof(payload)));
+
+	// contiguous payloads, in order
+	for (uint8_t i = 1; i <= 2; i++)
+	{
+		const sQueuedDownlink* downlink = queue.peek(&data);
+		CHECK(downlink != NULL);
+		CHECK_EQUAL(i, downlink->port);
+		CHECK_EQUAL(sizeof(payload), downlink->length);
+		CHECK((data[0] == i) && (data[sizeof(payload) - 1] == i));
+		queue.pop();
+	}
+	CHECK(queue.peek(&data) == NULL);
+
+	// the entries wrap around as well
+	for (uint8_t i = 0; i < 3 * DOWNLINK_QUEUE_ENTRIES; i++)
+	{
+		CHECK(queue.push(i, &i, 1));
+		const sQueuedDownlink* downlink = queue.peek(&data);
+		CHECK((downlink != NULL) && (downlink->port == i) && (*data == i));
+		queue.pop();
+	}
+
+	// too long for the pool, empty payloads take no room
+	uint8_t large[DOWNLINK_QUEUE_BYTES + 1] = { 0 };
+	CHECK(!queue.push(1, large, sizeof(large)));
+	CHECK(queue.push(1, large, DOWNLINK_QUEUE_BYTES));
+	CHECK(queue.push(2, NULL, 0));
+	CHECK_EQUAL(2, queue.getCount());
+}
+
+static void testOverflow()
+{
+	calls.clear();
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	CHECK(orange.onDownlink(1, 223, handlerA));
+
+	// received while the application did not poll
+	for (int i = 0; i < DOWNLINK_QUEUE_ENTRIES + 2; i++) receive(module, request, "mac_rx 7 " + std::string(1, (char)('0' + i)) + "0");
+
+	sDownlinkStats stats;
+	orange.getDownlinkStats(&stats);
+	CHECK_EQUAL(DOWNLINK_QUEUE_ENTRIES, stats.queued);
+	CHECK_EQUAL(2, stats.overflows);
+	CHECK_EQUAL(DOWNLINK_QUEUE_ENTRIES, stats.maxDepth);
+
+	// the oldest ones are kept
+	CHECK_EQUAL(DOWNLINK_QUEUE_ENTRIES, orange.dispatchDownlinks());
+	CHECK_EQUAL(DOWNLINK_QUEUE_ENTRIES, calls.size());
+	CHECK_STRING("00", calls[0].hex.c_str());
+	std::string last = std::string(1, (char)('0' + DOWNLINK_QUEUE_ENTRIES - 1)) + "0";
+	CHECK_STRING(last.c_str(), calls[DOWNLINK_QUEUE_ENTRIES - 1].hex.c_str());
+
+	// room again once dispatched
+	receive(module, request, "mac_rx 7 FF");
+	orange.getDownlinkStats(&stats);
+	CHECK_EQUAL(DOWNLINK_QUEUE_ENTRIES + 1, stats.queued);
+}
+
+int main()
+{
+	testRangeOrder();
+	testQueuedDuringUplinks();
+	testWrapAround();
+	testOverflow();
+	return TEST_RESULT();
+}
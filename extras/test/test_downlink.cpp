@@ -0,0 +1,166 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Downlinks decoded as they are received, without String: port and payload, invalid and odd hexadecimal,
+// truncation to the buffer, downlinks without data, the parse of a whole "mac_rx" line and a
+// DownlinkMessage declared by a sketch
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include <string>
+
+class LineDownlink : public DownlinkMessageBuffer<4>
+{
+public:
+	using DownlinkSink::setResponseMessage;
+};
+
+static void receive(DownlinkSink* sink, uint8_t port, const char* hex)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	request.init(&module);
+	request.setDownlinkSink(sink);
+	module.queueDownlink(port, hex);
+
+	const uint8_t payload[] = { 0x01 };
+	request.submitUplink(STR_CNF, payload, sizeof(payload), 1);
+	while (request.isBusy()) request.poll();
+}
+
+static void testDecodedWithoutAllocation()
+{
+	DownlinkMessageBuffer<DOWNLINK_BUFFER_SIZE> downlink;
+
+	uint32_t allocations = hostStringAllocations();
+	receive(&downlink, 12, "0102A0FFcafe");
+	uint16_t len;
+	const uint8_t* payload = downlink.getPayload(&len);
+	char hex[16];
+	uint16_t hexLen = downlink.getHexMessage(hex, sizeof(hex));
+	CHECK_EQUAL(0, hostStringAllocations() - allocations);
+
+	const uint8_t expected[] = { 0x01, 0x02, 0xA0, 0xFF, 0xCA, 0xFE };
+	CHECK_EQUAL(12, downlink.getPort());
+	CHECK_EQUAL(sizeof(expected), len);
+	CHECK((payload != NULL) && (memcmp(expected, payload, sizeof(expected)) == 0));
+	CHECK_EQUAL(12, hexLen);
+	CHECK_STRING("0102A0FFCAFE", hex);
+	CHECK(!downlink.isTruncated());
+
+	// too small for the string and its NUL
+	CHECK_EQUAL(0, downlink.getHexMessage(hex, 12));
+
+	int8_t byteLen;
+	CHECK(downlink.getMessageByteArray(&byteLen) == payload);
+	CHECK_EQUAL(sizeof(expected), byteLen);
+	String message = downlink.getMessage();
+	CHECK_STRING("0102A0FFCAFE", message.c_str());
+}
+
+static void testInvalidData()
+{
+	DownlinkMessageBuffer<DOWNLINK_BUFFER_SIZE> downlink;
+	uint16_t len;
+
+	receive(&downlink, 3, "01G2");
+	CHECK_EQUAL(3, downlink.getPort());
+	CHECK(downlink.getPayload(&len) == NULL);
+	CHECK_EQUAL(0, len);
+
+	receive(&downlink, 4, "010");
+	CHECK_EQUAL(4, downlink.getPort());
+	CHECK(downlink.getPayload(&len) == NULL);
+
+	// the next valid downlink replaces the invalid one
+	receive(&downlink, 5, "AB");
+	CHECK(downlink.getPayload(&len) != NULL);
+	CHECK_EQUAL(1, len);
+}
+
+static void testTruncated()
+{
+	DownlinkMessageBuffer<4> downlink;
+	uint16_t len;
+
+	receive(&downlink, 7, "00112233445566");
+	const uint8_t* payload = downlink.getPayload(&len);
+	CHECK_EQUAL(4, len);
+	CHECK(downlink.isTruncated());
+	const uint8_t expected[] = { 0x00, 0x11, 0x22, 0x33 };
+	CHECK((payload != NULL) && (memcmp(expected, payload, sizeof(expected)) == 0));
+}
+
+static void testEmptyDownlink()
+{
+	DownlinkMessageBuffer<DOWNLINK_BUFFER_SIZE> downlink;
+	uint16_t len;
+
+	receive(&downlink, 2, "CAFE");
+	CHECK(downlink.getPayload(&len) != NULL);
+
+	// "mac_rx 9" does not report the payload of the previous downlink
+	receive(&downlink, 9, "");
+	CHECK_EQUAL(9, downlink.getPort());
+	CHECK(downlink.getPayload(&len) == NULL);
+	CHECK_EQUAL(0, len);
+	CHECK(!downlink.isTruncated());
+}
+
+static void testDeclaredMessage()
+{
+	DownlinkMessage downlink;
+	uint16_t len;
+	CHECK_EQUAL(0, downlink.getPort());
+	CHECK(downlink.getPayload(&len) == NULL);
+
+	// it holds a whole downlink of DOWNLINK_BUFFER_SIZE bytes
+	std::string hex;
+	for (uint16_t i = 0; i < DOWNLINK_BUFFER_SIZE; i++) hex += "5A";
+	receive(&downlink, 42, hex.c_str());
+	const uint8_t* payload = downlink.getPayload(&len);
+	CHECK_EQUAL(42, downlink.getPort());
+	CHECK_EQUAL(DOWNLINK_BUFFER_SIZE, len);
+	CHECK((payload != NULL) && (payload[0] == 0x5A) && (payload[len - 1] == 0x5A));
+	CHECK(!downlink.isTruncated());
+}
+
+static void testWholeLine()
+{
+	LineDownlink downlink;
+	uint16_t len;
+
+	uint32_t allocations = hostStringAllocations();
+	downlink.setResponseMessage((uint8_t*)"mac_rx 223 A1B2");
+	const uint8_t* payload = downlink.getPayload(&len);
+	CHECK_EQUAL(0, hostStringAllocations() - allocations);
+	CHECK_EQUAL(223, downlink.getPort());
+	CHECK_EQUAL(2, len);
+	CHECK((payload != NULL) && (payload[0] == 0xA1) && (payload[1] == 0xB2));
+
+	downlink.setResponseMessage(NULL);
+	CHECK_EQUAL(0, downlink.getPort());
+	CHECK(downlink.getPayload(&len) == NULL);
+}
+
+int main()
+{
+	testDecodedWithoutAllocation();
+	testInvalidData();
+	testTruncated();
+	testEmptyDownlink();
+	testDeclaredMessage();
+	testWholeLine();
+	return TEST_RESULT();
+}
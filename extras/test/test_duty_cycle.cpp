@@ -0,0 +1,249 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Duty cycle tracked by the library as the RN2483 enforces it: off-time of each channel, uplinks scheduled
+// with nextTxOpportunity() never refused by a module which applies its own rule, local refusal and its opt-out,
+// retransmissions of confirmed uplinks, dcycle of the channels, airtime charged at the data rate used and time
+// spent in standby
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+#define DEFAULT_SUB_BAND		2			// 868.0 - 868.6 MHz, 1%
+
+static void testOffTime()
+{
+	DutyCycle dutyCycle;
+	CHECK_EQUAL(3, dutyCycle.getChannelCount());
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(1000));
+
+	// each default channel is off for 303 times the time on air
+	dutyCycle.record(1000, 100);
+	dutyCycle.record(1000, 100);
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(1000));
+	dutyCycle.record(2000, 100);
+	CHECK_EQUAL(30300, dutyCycle.nextTxOpportunity(1000));
+	CHECK_EQUAL(1300, dutyCycle.nextTxOpportunity(30000));
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(31300));
+	CHECK_EQUAL(300, dutyCycle.getAirtime(DEFAULT_SUB_BAND));
+
+	// a channel with a shorter off-time
+	CHECK(dutyCycle.setChannelDutyCycle(0, 9));
+	CHECK(!dutyCycle.setChannelDutyCycle(3, 9));
+	dutyCycle.reset();
+	for (int i = 0; i < 3; i++) dutyCycle.record(40000, 100);
+	CHECK_EQUAL(1000, dutyCycle.nextTxOpportunity(40000));
+
+	// a channel of the 10% sub-band is free while the default ones are off
+	CHECK(dutyCycle.addChannel(869525000, 9));
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(40000));
+	dutyCycle.record(40000, 100);
+	CHECK_EQUAL(1000, dutyCycle.nextTxOpportunity(40000));
+	CHECK_EQUAL(100, dutyCycle.getAirtime(4));
+
+	CHECK(!dutyCycle.addChannel(915000000));
+	dutyCycle.reset();
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(40000));
+	CHECK_EQUAL(0, dutyCycle.getAirtime(DEFAULT_SUB_BAND));
+}
+
+static void testRadioSubBand()
+{
+	DutyCycle dutyCycle;
+
+	// the raw radio transmissions follow the 1% of the sub-band, uplinks included
+	dutyCycle.record(868300000, 1000, 100);
+	CHECK_EQUAL(10000, dutyCycle.nextTxOpportunity(868300000, 1000));
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(869525000, 1000));
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(1000));
+
+	dutyCycle.record(20000, 100);
+	CHECK_EQUAL(10000, dutyCycle.nextTxOpportunity(868300000, 20000));
+	CHECK_EQUAL(0, dutyCycle.nextTxOpportunity(915000000, 20000));
+}
+
+static void testScheduledUplinks()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	module.enforceDutyCycle(true);
+	module.set("mac dr", "0");
+
+	CHECK(orange.rejoin());
+
+	uint8_t payload[20] = { 0 };
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		delay(orange.nextTxOpportunity());
+		payload[0] = i;
+		CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	}
+	CHECK_EQUAL(8, module.countCommands("mac tx"));
+	CHECK_EQUAL(0, module.noFreeChannel);
+
+	// refused locally once the 3 channels are off, nothing is written to the module
+	while (orange.nextTxOpportunity() == 0) CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	size_t sent = module.countCommands("mac tx");
+	size_t written = module.commands.size();
+	CHECK(!orange.sendMessage(payload, sizeof(payload), 1));
+	CHECK_EQUAL(LORA_NO_FREE_CH, orange.getLastError());
+	CHECK_EQUAL(sent, module.countCommands("mac tx"));
+	CHECK_EQUAL(0, module.noFreeChannel);
+	CHECK(module.commands.size() - written <= 2);
+}
+
+static void testModuleRule()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	module.enforceDutyCycle(true);
+	CHECK(orange.rejoin());
+
+	// not refused by the library, the module decides: its answer matches the prediction of the library
+	orange.enforceDutyCycle(false);
+	uint8_t payload[40] = { 0 };
+	uint32_t refused = 0;
+	for (int i = 0; i < 40; i++)
+	{
+		uint32_t predicted = orange.nextTxOpportunity();
+		bool sent = orange.sendMessage(payload, sizeof(payload), 1);
+		CHECK_EQUAL(predicted == 0, sent);
+		if (!sent)
+		{
+			CHECK_EQUAL(LORA_NO_FREE_CH, orange.getLastError());
+			refused++;
+		}
+		delay(3000);
+	}
+	CHECK(refused > 0);
+	CHECK_EQUAL(refused, module.noFreeChannel);
+	CHECK_EQUAL(40, module.countCommands("mac tx"));
+}
+
+static void testRetransmissionsCharged()
+{
+	SimulatedModule module;
+	module.setBaudrate(0);
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	CHECK(orange.setDataRate(DATA_RATE_5));
+	CHECK(orange.rejoin());
+	orange.getDutyCycle()->reset();
+
+	// no acknowledgement after 2 retransmissions, at the earliest
+	uint8_t payload[] = { 0x01 };
+	uint32_t airtime = TimeOnAir::dataFrame(DATA_RATE_5, sizeof(payload));
+	uint32_t cycle = airtime + DEFAULT_RX_DELAY_1 + RX_WINDOW_GAP + ACK_TIMEOUT_MIN;
+	module.script("mac tx cnf 1 01", "ok", "mac_err", (2 * cycle) + airtime + DEFAULT_RX_DELAY_1);
+	CHECK(!orange.sendMessage(CONFIRMED_MESSAGE, payload, sizeof(payload), 1));
+	CHECK_EQUAL(LORA_MAC_ERR, orange.getLastError());
+	CHECK_EQUAL(3 * airtime, orange.getDutyCycle()->getAirtime(DEFAULT_SUB_BAND));
+	CHECK(orange.nextTxOpportunity() > 0);
+
+	// acknowledged right away, only sent once
+	orange.getDutyCycle()->reset();
+	CHECK(orange.sendMessage(CONFIRMED_MESSAGE, payload, sizeof(payload), 1));
+	CHECK_EQUAL(airtime, orange.getDutyCycle()->getAirtime(DEFAULT_SUB_BAND));
+}
+
+static void testChannelDutyCycle()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	CHECK(orange.setChannelDutyCycle(1, 99));
+	std::string dcycle = module.get("mac ch dcycle 1");
+	CHECK_STRING("99", dcycle.c_str());
+	CHECK(!orange.setChannelDutyCycle(3, 99));
+
+	// configured without the library
+	module.set("mac ch dcycle 0", "9");
+	module.set("mac ch dcycle 1", "9");
+	module.set("mac ch dcycle 2", "9");
+	CHECK(orange.readChannelDutyCycles());
+	DutyCycle* dutyCycle = orange.getDutyCycle();
+	for (int i = 0; i < 3; i++) dutyCycle->record(1000, 100);
+	CHECK_EQUAL(1000, dutyCycle->nextTxOpportunity(1000));
+}
+
+static void testAirtimeAtDataRate()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+	CHECK(orange.rejoin());
+	uint32_t join = orange.getDutyCycle()->getAirtime(DEFAULT_SUB_BAND);
+
+	uint8_t payload[10] = { 0 };
+	CHECK(orange.enableAdr(true));
+	CHECK(orange.setDataRate(DATA_RATE_0));
+	delay(orange.nextTxOpportunity());
+	CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	uint32_t slow = orange.getDutyCycle()->getAirtime(DEFAULT_SUB_BAND) - join;
+	CHECK_EQUAL(TimeOnAir::dataFrame(DATA_RATE_0, sizeof(payload)), slow);
+
+	// ADR moved the module to DR5 behind the back of the library
+	delay(orange.nextTxOpportunity());
+	module.set("mac dr", "5");
+	CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	CHECK_EQUAL(TimeOnAir::dataFrame(DATA_RATE_5, sizeof(payload)), orange.getDutyCycle()->getAirtime(DEFAULT_SUB_BAND) - join - slow);
+}
+
+static void testStandbyCounted()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	CHECK(orange.rejoin());
+	orange.getDutyCycle()->reset();
+
+	// the 3 channels are off for minutes at DR0
+	uint8_t payload[20] = { 0 };
+	CHECK(orange.setDataRate(DATA_RATE_0));
+	for (int i = 0; i < 3; i++) CHECK(orange.sendMessage(payload, sizeof(payload), 1));
+	uint32_t wait = orange.nextTxOpportunity();
+	CHECK(wait > 60000);
+
+	// millis() stops in standby, the library counts the time of the RTC
+	uint32_t before = millis();
+	orange.deepSleep(0, 1, 0);
+	uint32_t next = orange.nextTxOpportunity();
+	uint32_t awake = millis() - before;
+	CHECK(awake < 60000);
+	CHECK(next <= wait - 60000);
+	CHECK(next >= wait - 60000 - awake);
+}
+
+int main()
+{
+	testOffTime();
+	testRadioSubBand();
+	testScheduledUplinks();
+	testModuleRule();
+	testRetransmissionsCharged();
+	testChannelDutyCycle();
+	testAirtimeAtDataRate();
+	testStandbyCounted();
+	return TEST_RESULT();
+}
@@ -0,0 +1,128 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// sendFragmented(): a message sent through a module enforcing the duty cycle and rebuilt by FragmentReassembler,
+// a message too long refused before anything is sent, and the maximum payloads of RegionTable
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "FragmentReassembler.h"
+#include "HexCodec.h"
+#include "RegionTable.h"
+#include "TimeOnAir.h"
+
+#include <vector>
+
+#define UPLINK_PREFIX		"mac tx uncnf 1 "
+
+// the payloads of the uplinks, in the order they were sent
+static std::vector<std::vector<uint8_t> > uplinks(SimulatedModule& module)
+{
+	std::vector<std::vector<uint8_t> > frames;
+	for (size_t i = 0; i < module.commands.size(); i++)
+	{
+		const std::string& command = module.commands[i];
+		if (command.compare(0, strlen(UPLINK_PREFIX), UPLINK_PREFIX) != 0) continue;
+
+		std::string hex = command.substr(strlen(UPLINK_PREFIX));
+		std::vector<uint8_t> frame(hex.size() / 2);
+		CHECK_EQUAL((int16_t)frame.size(), HexCodec::decode(hex.c_str(), hex.size(), frame.data()));
+		frames.push_back(frame);
+	}
+	return frames;
+}
+
+static void testReassembled()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	module.enforceDutyCycle(true);
+	CHECK(orange.setDataRate(DATA_RATE_0));
+	CHECK(orange.rejoin());
+
+	// 7 fragments of at most 49 bytes at DR0, more than the 3 default channels allow at once
+	uint8_t message[300];
+	for (uint16_t i = 0; i < sizeof(message); i++) message[i] = (uint8_t)(i * 7);
+	CHECK(orange.sendFragmented(UNCONFIRMED_MESSAGE, message, sizeof(message), 1));
+	CHECK_EQUAL(0, module.noFreeChannel);
+
+	std::vector<std::vector<uint8_t> > frames = uplinks(module);
+	CHECK_EQUAL(7, frames.size());
+
+	FragmentReassembler reassembler;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		CHECK(frames[i].size() <= RegionTable::maxPayloadSize(REGION_EU868, DATA_RATE_0));
+		eReassemblyState state = reassembler.accept(frames[i].data(), frames[i].size());
+		CHECK_EQUAL((i + 1 == frames.size()) ? REASSEMBLY_COMPLETE : REASSEMBLY_PENDING, state);
+	}
+
+	uint16_t len = 0;
+	const uint8_t* rebuilt = reassembler.getMessage(&len);
+	CHECK_EQUAL(sizeof(message), len);
+	CHECK((rebuilt != NULL) && (memcmp(message, rebuilt, sizeof(message)) == 0));
+	CHECK_EQUAL(0, reassembler.getDroppedMessages());
+}
+
+static void testTooLong()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	CHECK(orange.setDataRate(DATA_RATE_0));
+	CHECK(orange.rejoin());
+
+	// one byte more than MAX_FRAGMENTS fragments at DR0, refused before the first fragment
+	std::vector<uint8_t> message((MAX_FRAGMENTS * (51 - FRAGMENT_HEADER_SIZE)) + 1, 0xA5);
+	CHECK(!orange.sendFragmented(UNCONFIRMED_MESSAGE, message.data(), message.size(), 1));
+	CHECK_EQUAL(LORA_INVALID_DATA_LEN, orange.getLastError());
+	CHECK_EQUAL(0, module.countCommands("mac tx"));
+
+	// the same message fits at DR5
+	CHECK(orange.setDataRate(DATA_RATE_5));
+	orange.enforceDutyCycle(false);
+	CHECK(orange.sendFragmented(UNCONFIRMED_MESSAGE, message.data(), message.size(), 1));
+	CHECK_EQUAL((message.size() + (222 - FRAGMENT_HEADER_SIZE) - 1) / (222 - FRAGMENT_HEADER_SIZE), module.countCommands("mac tx"));
+}
+
+static void testRegionTable()
+{
+	CHECK_EQUAL(51, RegionTable::maxPayloadSize(REGION_EU868, DATA_RATE_0));
+	CHECK_EQUAL(51, RegionTable::maxPayloadSize(REGION_EU868, DATA_RATE_2));
+	CHECK_EQUAL(115, RegionTable::maxPayloadSize(REGION_EU868, DATA_RATE_3));
+	CHECK_EQUAL(222, RegionTable::maxPayloadSize(REGION_EU868, DATA_RATE_5));
+	CHECK_EQUAL(222, RegionTable::maxPayloadSize(REGION_EU868, DATA_RATE_7));
+
+	// the same table for both EU regions, the one used for the time on air
+	for (int dataRate = DATA_RATE_0; dataRate < COUNT_DATA_RATE; dataRate++)
+	{
+		CHECK_EQUAL(TimeOnAir::maxPayloadSize((eDataRate)dataRate), RegionTable::maxPayloadSize(REGION_EU868, (eDataRate)dataRate));
+		CHECK_EQUAL(TimeOnAir::maxPayloadSize((eDataRate)dataRate), RegionTable::maxPayloadSize(REGION_EU433, (eDataRate)dataRate));
+	}
+
+	CHECK_EQUAL(0, RegionTable::maxPayloadSize(COUNT_REGION, DATA_RATE_0));
+	CHECK_EQUAL(0, RegionTable::maxPayloadSize(REGION_EU868, COUNT_DATA_RATE));
+	CHECK_EQUAL(0, RegionTable::maxPayloadSize(REGION_EU868, DATA_RATE_ERROR));
+}
+
+int main()
+{
+	testReassembled();
+	testTooLong();
+	testRegionTable();
+	return TEST_RESULT();
+}
@@ -0,0 +1,139 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Command framing: one write per command, transmitters providing their own buffers, short writes and overflows
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+class CountingModule : public SimulatedModule
+{
+public:
+	uint16_t writes;
+	uint16_t lastLength;
+	uint16_t accepted;						// bytes taken by each write, all of them when 0
+
+	CountingModule() : writes(0), lastLength(0), accepted(0) {}
+
+	virtual uint16_t write(const uint8_t* data, uint16_t len)
+	{
+		writes++;
+		lastLength = len;
+		if ((accepted == 0) || (accepted >= len)) return SimulatedModule::write(data, len);
+		return SimulatedModule::write(data, accepted);
+	}
+};
+
+class BufferTransmitter : public RnTransmitter
+{
+public:
+	uint8_t buffer[DEFAULT_OUTPUT_BUFFER_SIZE];
+	uint16_t size;
+	uint8_t* sent;
+	uint16_t sentLength;
+	bool available;
+
+	BufferTransmitter() : size(sizeof(buffer)), sent(NULL), sentLength(0), available(true) {}
+
+	virtual uint8_t* acquire(uint16_t* size)
+	{
+		if (!available) return NULL;
+		*size = this->size;
+		return buffer;
+	}
+
+	virtual bool transmit(uint8_t* buffer, uint16_t length)
+	{
+		sent = buffer;
+		sentLength = length;
+		return true;
+	}
+};
+
+static void testSingleWrite()
+{
+	CountingModule module;
+	RnRequestClass request;
+	request.init(&module);
+
+	CHECK(request.submit(MAC, SET, "retx", "7") != RN_INVALID_HANDLE);
+	while (request.isBusy()) request.poll();
+	CHECK_EQUAL(1, module.writes);
+	CHECK_EQUAL(strlen("mac set retx 7\r\n"), module.lastLength);
+
+	// the largest frame the module takes
+	uint8_t payload[222];
+	for (size_t i = 0; i < sizeof(payload); i++) payload[i] = i;
+	CHECK(request.submitUplink(STR_UNCNF, payload, sizeof(payload), 223) != RN_INVALID_HANDLE);
+	CHECK_EQUAL(2, module.writes);
+	CHECK_EQUAL(strlen("mac tx uncnf 223 ") + (2 * sizeof(payload)) + 2, module.lastLength);
+	CHECK_EQUAL(0, module.commands.back().compare(0, 23, "mac tx uncnf 223 000102"));
+	CHECK_EQUAL(0, module.commands.back().compare(module.commands.back().size() - 4, 4, "DCDD"));
+	while (request.isBusy()) request.poll();
+}
+
+static void testShortWrite()
+{
+	CountingModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	request.init(&module);
+	module.accepted = 4;
+
+	CHECK_EQUAL(RN_INVALID_HANDLE, request.submit(MAC, SET, "retx", "7"));
+	CHECK_EQUAL(LORA_TRANSPORT_ERR, orange.getLastError());
+	CHECK(!request.isBusy());
+}
+
+static void testTransmitter()
+{
+	LoopbackTransport silent;
+	BufferTransmitter transmitter;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	request.init(&silent);
+	request.setTransmitter(&transmitter);
+
+	// framed in place in the buffer of the transmitter
+	CHECK(request.submit(RADIO, SET, "sf", "sf7") != RN_INVALID_HANDLE);
+	CHECK(transmitter.sent == transmitter.buffer);
+	CHECK_EQUAL(strlen("radio set sf sf7\r\n"), transmitter.sentLength);
+	CHECK_EQUAL(0, memcmp(transmitter.buffer, "radio set sf sf7\r\n", transmitter.sentLength));
+
+	uint16_t written = 0;
+	silent.getWritten(&written);
+	CHECK_EQUAL(0, written);
+	while (request.isBusy()) request.poll();
+
+	// no buffer available
+	transmitter.available = false;
+	CHECK_EQUAL(RN_INVALID_HANDLE, request.submit(RADIO, SET, "sf", "sf7"));
+	CHECK_EQUAL(LORA_BUSY, orange.getLastError());
+
+	// the frame does not fit
+	transmitter.available = true;
+	transmitter.size = 8;
+	transmitter.sent = NULL;
+	CHECK_EQUAL(RN_INVALID_HANDLE, request.submit(RADIO, SET, "sf", "sf7"));
+	CHECK_EQUAL(LORA_INVALID_DATA_LEN, orange.getLastError());
+	CHECK(transmitter.sent == NULL);
+}
+
+int main()
+{
+	testSingleWrite();
+	testShortWrite();
+	testTransmitter();
+	return TEST_RESULT();
+}
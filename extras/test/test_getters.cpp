@@ -0,0 +1,105 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Getters parsing the answer of the module in place: values and malformed answers, with no String allocated
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+static void testKeywords()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+	RadioCmdsClass* radio = orange.getRadioCmds();
+
+	uint32_t allocations = hostStringAllocations();
+	CHECK_EQUAL(BT_0_5, radio->getBt());
+	CHECK_EQUAL(LORA_MODULATION, radio->getModulation());
+	CHECK_EQUAL(CR_4_5, radio->getCodingRate());
+	CHECK_EQUAL(BOOL_TRUE, radio->getCrc());
+	CHECK_EQUAL(BOOL_FALSE, radio->getIqInversion());
+	CHECK_EQUAL(BOOL_FALSE, orange.isAdr());
+	CHECK_EQUAL(0, hostStringAllocations() - allocations);
+
+	module.set("radio bt", "none");
+	module.set("radio mod", "fsk");
+	module.set("radio cr", "4/8");
+	module.set("radio crc", "off");
+	module.set("radio iqi", "on");
+	module.set("mac adr", "on");
+	CHECK_EQUAL(BT_NONE, radio->getBt());
+	CHECK_EQUAL(FSK_MODULATION, radio->getModulation());
+	CHECK_EQUAL(CR_4_8, radio->getCodingRate());
+	CHECK_EQUAL(BOOL_FALSE, radio->getCrc());
+	CHECK_EQUAL(BOOL_TRUE, radio->getIqInversion());
+	CHECK_EQUAL(BOOL_TRUE, orange.isAdr());
+
+	// near misses of the keywords
+	module.set("radio bt", "0.55");
+	module.set("radio cr", "4/9");
+	module.set("radio crc", "onn");
+	CHECK_EQUAL(BT_ERROR, radio->getBt());
+	CHECK_EQUAL(CR_ERROR, radio->getCodingRate());
+	CHECK_EQUAL(BOOL_FALSE, radio->getCrc());
+
+	// the setters send the keywords
+	CHECK(radio->setBt(BT_0_3));
+	CHECK(radio->setModulation(LORA_MODULATION));
+	CHECK(orange.enableAdr(false));
+	CHECK_EQUAL(BT_0_3, radio->getBt());
+	CHECK_EQUAL(LORA_MODULATION, radio->getModulation());
+	CHECK_EQUAL(BOOL_FALSE, orange.isAdr());
+	CHECK_EQUAL(0, hostStringAllocations() - allocations);
+}
+
+static void testNumbers()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+	RadioCmdsClass* radio = orange.getRadioCmds();
+	module.set("mac upctr", "4294967296");
+	module.set("mac sync", "34");
+
+	uint32_t allocations = hostStringAllocations();
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(7, orange.getRetransNb());
+	CHECK_EQUAL(1000, orange.getRxdelay1());
+	CHECK_EQUAL(4294967296ULL, orange.getUpctr());
+	CHECK_EQUAL(0x34, orange.getSync());
+	CHECK_EQUAL(3312, orange.getSysCmds()->getVdd());
+	CHECK_EQUAL(SF12, radio->getSF());
+	CHECK_EQUAL(868100000, radio->getFrequency());
+	CHECK_EQUAL(8, radio->getPreambleLength());
+	CHECK_EQUAL(-128, radio->getSigNoiseRation());
+	CHECK_EQUAL(0x34, radio->getSync());
+	CHECK_EQUAL(0, hostStringAllocations() - allocations);
+
+	module.set("radio sf", "12");
+	module.set("radio freq", "868x");
+	CHECK_EQUAL(SF_ERROR, radio->getSF());
+	CHECK_EQUAL(-1, radio->getFrequency());
+}
+
+int main()
+{
+	testKeywords();
+	testNumbers();
+	return TEST_RESULT();
+}
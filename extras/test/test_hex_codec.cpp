@@ -0,0 +1,129 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Hexadecimal codec: every digit, every byte, every pair of characters and every length and alignment of the bulk path
+
+#include "TestSupport.h"
+#include "HexCodec.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+
+static void testDigits()
+{
+	for (int c = 0; c < 256; c++)
+	{
+		char digit[2] = { (char)c, '\0' };
+		int8_t expected = isxdigit(c) ? (int8_t)strtol(digit, NULL, 16) : HEX_ERROR;
+		CHECK_EQUAL(expected, HexCodec::digitValue((char)c));
+	}
+}
+
+static void testEveryByte()
+{
+	for (int value = 0; value < 256; value++)
+	{
+		uint8_t byte = value;
+		char hex[3];
+		char expected[3];
+		sprintf(expected, "%02X", value);
+
+		CHECK_EQUAL(2, HexCodec::encode(&byte, 1, hex));
+		hex[2] = '\0';
+		CHECK_STRING(expected, hex);
+	}
+}
+
+static void testEveryPair()
+{
+	// 65536 pairs, valid only when both characters are hexadecimal digits
+	for (int high = 0; high < 256; high++)
+	{
+		for (int low = 0; low < 256; low++)
+		{
+			char hex[2] = { (char)high, (char)low };
+			uint8_t byte = 0;
+			int16_t decoded = HexCodec::decode(hex, 2, &byte);
+
+			if (isxdigit(high) && isxdigit(low))
+			{
+				char digits[3] = { (char)high, (char)low, '\0' };
+				CHECK_EQUAL(1, decoded);
+				CHECK_EQUAL(strtol(digits, NULL, 16), byte);
+			}
+			else
+			{
+				CHECK_EQUAL(HEX_ERROR, decoded);
+			}
+		}
+	}
+}
+
+static void testRoundTrip()
+{
+	uint8_t data[72];
+	uint8_t decoded[72];
+	char hex[2 * sizeof(data) + 8];
+
+	srand(4);
+	for (size_t i = 0; i < sizeof(data); i++) data[i] = rand();
+
+	// every length and alignment around the words of the bulk path
+	for (uint16_t offset = 0; offset < 8; offset++)
+	{
+		for (uint16_t len = 0; len + offset <= 64; len++)
+		{
+			CHECK_EQUAL(2 * len, HexCodec::encode(&data[offset], len, &hex[offset]));
+			memset(decoded, 0, sizeof(decoded));
+			CHECK_EQUAL(len, HexCodec::decode(&hex[offset], 2 * len, &decoded[offset]));
+			CHECK_EQUAL(0, memcmp(&data[offset], &decoded[offset], len));
+
+			// lower case
+			for (uint16_t i = 0; i < 2 * len; i++) hex[offset + i] = tolower(hex[offset + i]);
+			memset(decoded, 0, sizeof(decoded));
+			CHECK_EQUAL(len, HexCodec::decode(&hex[offset], 2 * len, &decoded[offset]));
+			CHECK_EQUAL(0, memcmp(&data[offset], &decoded[offset], len));
+		}
+	}
+}
+
+static void testInvalid()
+{
+	uint8_t data[32];
+	char hex[64];
+	memset(hex, 'a', sizeof(hex));
+
+	CHECK_EQUAL(HEX_ERROR, HexCodec::decode(hex, 3, data));
+	CHECK_EQUAL(0, HexCodec::decode(hex, 0, data));
+
+	// an invalid character anywhere, in the bulk path or in the tail
+	for (uint16_t i = 0; i < sizeof(hex); i++)
+	{
+		hex[i] = 'g';
+		CHECK_EQUAL(HEX_ERROR, HexCodec::decode(hex, sizeof(hex), data));
+		hex[i] = ':';
+		CHECK_EQUAL(HEX_ERROR, HexCodec::decode(hex, sizeof(hex), data));
+		hex[i] = 'a';
+	}
+	CHECK_EQUAL(sizeof(data), HexCodec::decode(hex, sizeof(hex), data));
+}
+
+int main()
+{
+	testDigits();
+	testEveryByte();
+	testEveryPair();
+	testRoundTrip();
+	testInvalid();
+	return TEST_RESULT();
+}
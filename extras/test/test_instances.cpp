@@ -0,0 +1,73 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Several modules driven at the same time from separate threads, each through its own objects
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define STRESS_MODULES		10
+#define STRESS_UPLINKS		20
+
+static std::atomic<int> failures(0);
+
+static void drive(int index, SimulatedModule* module)
+{
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(module);
+
+	if (!orange.rejoin()) failures++;
+	for (int i = 0; i < STRESS_UPLINKS; i++)
+	{
+		// each module sends its own payloads, on its own port
+		uint8_t payload[] = { (uint8_t)index, (uint8_t)i };
+		delay(orange.nextTxOpportunity());
+		if (!orange.sendMessage(payload, sizeof(payload), index + 1)) failures++;
+		if (orange.getDataRate() != DATA_RATE_5) failures++;
+	}
+}
+
+static void testThreads()
+{
+	std::vector<SimulatedModule> modules(STRESS_MODULES);
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < STRESS_MODULES; i++) threads.push_back(std::thread(drive, i, &modules[i]));
+	for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+
+	CHECK_EQUAL(0, failures);
+	for (int i = 0; i < STRESS_MODULES; i++)
+	{
+		CHECK_EQUAL(1, modules[i].countCommands("mac join otaa"));
+		CHECK_EQUAL(STRESS_UPLINKS, modules[i].countCommands("mac tx "));
+
+		char expected[32];
+		for (int j = 0; j < STRESS_UPLINKS; j++)
+		{
+			sprintf(expected, "mac tx uncnf %d %02X%02X", i + 1, i, j);
+			CHECK_EQUAL(1, modules[i].countCommands(expected));
+		}
+	}
+}
+
+int main()
+{
+	testThreads();
+	return TEST_RESULT();
+}
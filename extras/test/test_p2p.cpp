@@ -0,0 +1,161 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Point-to-point stream between two simulated modules: data and sequence numbers, duty cycle of the
+// sub-band respected between the packets and shared with the LoRaWAN uplinks
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "P2PLink.h"
+
+#define STREAM_SIZE			1000
+
+typedef struct _sEnd {
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange;
+	P2PLink link;
+
+	_sEnd() : orange(&request), link(&orange)
+	{
+		orange.init(&module);
+	}
+}sEnd;
+
+static sP2PConfig config(uint32_t frequency)
+{
+	sP2PConfig p2p = { frequency, SF7, 125, CR_4_5, 14, DEFAULT_P2P_RX_WINDOW };
+	return p2p;
+}
+
+// off-time of the ETSI rule between each packet and the next one
+static void checkDutyCycle(SimulatedModule& module, uint16_t inverseDutyCycle)
+{
+	for (size_t i = 1; i < module.radioTx.size(); i++)
+	{
+		uint32_t offUntil = module.radioTx[i - 1].start + (module.radioTx[i - 1].airtime * inverseDutyCycle);
+		if ((int32_t)(module.radioTx[i].start - offUntil) < 0)
+		{
+			printf("packet %u sent %d ms before the end of the off-time\n", (unsigned)i, (int)(offUntil - module.radioTx[i].start));
+			CHECK(false);
+			return;
+		}
+	}
+}
+
+static void testStream(uint32_t frequency, uint16_t inverseDutyCycle)
+{
+	sEnd sender;
+	sEnd receiver;
+	sender.module.link(&receiver.module);
+
+	CHECK(sender.link.begin(config(frequency)));
+	CHECK(receiver.link.begin(config(frequency)));
+	CHECK_EQUAL(1, sender.module.countCommands("mac pause"));
+	std::string sf = sender.module.get("radio sf");
+	CHECK_STRING("sf7", sf.c_str());
+	sender.link.listen(false);
+
+	uint8_t data[STREAM_SIZE];
+	for (uint16_t i = 0; i < STREAM_SIZE; i++) data[i] = (uint8_t)(i * 7);
+	CHECK_EQUAL(STREAM_SIZE / 2, sender.link.write(data, STREAM_SIZE / 2));
+
+	uint8_t received[STREAM_SIZE];
+	uint16_t receivedLen = 0;
+	uint16_t written = STREAM_SIZE / 2;
+	uint32_t start = hostClock();
+	while ((receivedLen < STREAM_SIZE) && (hostClock() - start < 3600000UL))
+	{
+		if (written < STREAM_SIZE) written += sender.link.write(&data[written], STREAM_SIZE - written);
+		sender.link.poll();
+		receiver.link.poll();
+		receivedLen += receiver.link.read(&received[receivedLen], STREAM_SIZE - receivedLen);
+	}
+
+	CHECK_EQUAL(STREAM_SIZE, receivedLen);
+	CHECK(memcmp(data, received, STREAM_SIZE) == 0);
+	CHECK(sender.module.radioTx.size() >= (STREAM_SIZE + P2P_MAX_PACKET_SIZE - P2P_HEADER_SIZE - 1) / (P2P_MAX_PACKET_SIZE - P2P_HEADER_SIZE));
+	checkDutyCycle(sender.module, inverseDutyCycle);
+
+	sP2PStats stats;
+	receiver.link.getStats(&stats);
+	CHECK_EQUAL(STREAM_SIZE, stats.bytesReceived);
+	CHECK_EQUAL(0, stats.lostPackets);
+	CHECK_EQUAL(0, stats.duplicates);
+	sender.link.getStats(&stats);
+	CHECK_EQUAL(STREAM_SIZE, stats.bytesSent);
+	CHECK_EQUAL(stats.airtime, sender.orange.getDutyCycle()->getAirtime(frequency >= 869400000 ? 4 : 2));
+
+	CHECK(sender.link.end());
+	CHECK(receiver.link.end());
+	CHECK_EQUAL(1, sender.module.countCommands("mac resume"));
+}
+
+static void testFlushWaits()
+{
+	sEnd sender;
+	sEnd receiver;
+	sender.module.link(&receiver.module);
+
+	CHECK(sender.link.begin(config(868100000)));
+	CHECK(receiver.link.begin(config(868100000)));
+	sender.link.listen(false);
+
+	uint8_t data[2 * (P2P_MAX_PACKET_SIZE - P2P_HEADER_SIZE)] = { 0 };
+	CHECK_EQUAL(sizeof(data), sender.link.write(data, sizeof(data)));
+	sender.link.flush();
+
+	CHECK_EQUAL(2, sender.module.radioTx.size());
+	checkDutyCycle(sender.module, 100);
+	CHECK(sender.link.nextTxOpportunity() > 0);
+}
+
+static void testSharedWithLoRaWAN()
+{
+	sEnd sender;
+	sEnd receiver;
+	sender.module.link(&receiver.module);
+
+	// an uplink makes the 1% sub-band of the default channels off for the radio, its other channels stay free
+	CHECK(sender.orange.rejoin());
+	delay(sender.orange.nextTxOpportunity());
+	uint8_t payload[] = { 0x01 };
+	CHECK(sender.orange.sendMessage(payload, sizeof(payload), 1));
+	uint32_t blocked = hostClock();
+	CHECK_EQUAL(0, sender.orange.nextTxOpportunity());
+
+	CHECK(sender.link.begin(config(868300000)));
+	CHECK(receiver.link.begin(config(868300000)));
+	sender.link.listen(false);
+	uint32_t wait = sender.link.nextTxOpportunity();
+	CHECK(wait > 0);
+
+	sender.link.write(payload, sizeof(payload));
+	sender.link.flush();
+	CHECK_EQUAL(1, sender.module.radioTx.size());
+	CHECK(sender.module.radioTx[0].start - blocked >= wait);
+
+	// the 10% sub-band is free meanwhile
+	sender.link.end();
+	CHECK(sender.link.begin(config(869525000)));
+	CHECK_EQUAL(0, sender.link.nextTxOpportunity());
+}
+
+int main()
+{
+	testStream(869525000, 10);
+	testStream(868100000, 100);
+	testFlushWaits();
+	testSharedWithLoRaWAN();
+	return TEST_RESULT();
+}
@@ -0,0 +1,113 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// applyProfile(): only the changing settings are sent, with and without the parameter cache, and
+// "mac save" only follows a change of the RX2 settings
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+// the settings of the simulated module
+static sDeviceProfile moduleProfile()
+{
+	sDeviceProfile profile;
+	profile.dataRate = DATA_RATE_5;
+	profile.adr = false;
+	profile.retx = 7;
+	profile.pwrIdx = 1;
+	profile.rxDelay1 = 1000;
+	profile.rx2DataRate = DATA_RATE_3;
+	profile.rx2Frequency = 869525000;
+	profile.syncWord = 0x34;
+	profile.linkCheck = 0;
+	profile.batteryLevel = 254;
+	return profile;
+}
+
+static void testUnchangedCached()
+{
+	SimulatedModule module;
+	module.set("mac sync", "34");
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	// the write-only settings are unknown until sent once
+	CHECK(orange.applyProfile(moduleProfile()));
+	CHECK_EQUAL(2, module.countCommands("mac set"));
+	CHECK_EQUAL(1, module.countCommands("mac set linkchk"));
+	CHECK_EQUAL(1, module.countCommands("mac set bat "));
+	CHECK_EQUAL(0, module.countCommands("mac save"));
+
+	size_t sent = module.commands.size();
+	CHECK(orange.applyProfile(moduleProfile()));
+	CHECK_EQUAL(sent, module.commands.size());
+}
+
+static void testUnchangedUncached()
+{
+	SimulatedModule module;
+	module.set("mac sync", "34");
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+
+	// the readable settings are read and compared, only the write-only ones are sent
+	for (int i = 1; i <= 2; i++)
+	{
+		CHECK(orange.applyProfile(moduleProfile()));
+		CHECK_EQUAL(7 * i, module.countCommands("mac get"));
+		CHECK_EQUAL(2 * i, module.countCommands("mac set"));
+		CHECK_EQUAL(0, module.countCommands("mac save"));
+	}
+}
+
+static void testSaveOnRx2Change(bool cache)
+{
+	SimulatedModule module;
+	module.set("mac sync", "34");
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(cache);
+	CHECK(orange.applyProfile(moduleProfile()));
+	size_t sets = module.countCommands("mac set");
+
+	// a setting lost by a reset of the module is not saved
+	sDeviceProfile profile = moduleProfile();
+	profile.dataRate = DATA_RATE_2;
+	CHECK(orange.applyProfile(profile));
+	CHECK_EQUAL(1, module.countCommands("mac set dr 2"));
+	CHECK_EQUAL(0, module.countCommands("mac save"));
+
+	profile.rx2DataRate = DATA_RATE_0;
+	CHECK(orange.applyProfile(profile));
+	CHECK_EQUAL(1, module.countCommands("mac set rx2 0 869525000"));
+	CHECK_EQUAL(1, module.countCommands("mac save"));
+	std::string rx2 = module.get("mac rx2");
+	CHECK_STRING("0 869525000", rx2.c_str());
+
+	// without the cache, the write-only settings are sent again by each call
+	CHECK_EQUAL(sets + (cache ? 2 : 6), module.countCommands("mac set"));
+}
+
+int main()
+{
+	testUnchangedCached();
+	testUnchangedUncached();
+	testSaveOnRx2Change(true);
+	testSaveOnRx2Change(false);
+	return TEST_RESULT();
+}
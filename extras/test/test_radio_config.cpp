@@ -0,0 +1,161 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// RadioCmdsClass::snapshot(): fields parsed from the responses of the simulated module, fields refused or
+// malformed, and the round trip of the RADIO_CONFIG_SIZE bytes of serializeConfig() and deserializeConfig()
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "HexCodec.h"
+
+#define ALL_FIELDS			((1 << COUNT_RADIO_CFG) - 1)
+
+static void checkDefault(const sRadioConfig& config)
+{
+	CHECK_EQUAL(LORA_MODULATION, config.modulation);
+	CHECK_EQUAL(868100000, config.frequency);
+	CHECK_EQUAL(1, config.power);
+	CHECK_EQUAL(SF12, config.spreadingFactor);
+	CHECK_EQUAL(125, config.bandwidth);
+	CHECK_EQUAL(CR_4_5, config.codingRate);
+	CHECK_EQUAL(BOOL_TRUE, config.crc);
+	CHECK_EQUAL(BOOL_FALSE, config.iqInversion);
+	CHECK_EQUAL(0x34, config.sync);
+	CHECK_EQUAL(8, config.preambleLength);
+	CHECK_EQUAL(15000, config.watchdog);
+	CHECK_EQUAL(-128, config.snr);
+}
+
+static void testSnapshot(uint8_t window)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	sRadioConfig config;
+	size_t sent = module.countCommands("radio get");
+	CHECK(orange.getRadioCmds()->snapshot(&config, window));
+	CHECK_EQUAL(ALL_FIELDS, config.valid);
+	CHECK_EQUAL(sent + COUNT_RADIO_CFG, module.countCommands("radio get"));
+	checkDefault(config);
+}
+
+static void testMissingFields()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	// refused by the module, or not understood
+	module.script("radio get sf", "invalid_param");
+	module.set("radio cr", "4/9");
+	module.set("radio bw", "wide");
+	module.set("radio snr", "-200");
+
+	sRadioConfig config;
+	CHECK(!orange.getRadioCmds()->snapshot(&config));
+	CHECK_EQUAL(ALL_FIELDS & ~((1 << RADIO_CFG_SF) | (1 << RADIO_CFG_CR) | (1 << RADIO_CFG_BW) | (1 << RADIO_CFG_SNR)), config.valid);
+	CHECK_EQUAL(SF_ERROR, config.spreadingFactor);
+	CHECK_EQUAL(CR_ERROR, config.codingRate);
+	CHECK_EQUAL(0, config.bandwidth);
+	CHECK_EQUAL(868100000, config.frequency);
+	CHECK_EQUAL(BOOL_TRUE, config.crc);
+
+	// the other settings
+	module.set("radio cr", "4/8");
+	module.set("radio bw", "500");
+	module.set("radio mod", "fsk");
+	module.set("radio iqi", "on");
+	module.set("radio sf", "sf7");
+	module.set("radio snr", "-7");
+	CHECK(orange.getRadioCmds()->snapshot(&config));
+	CHECK_EQUAL(CR_4_8, config.codingRate);
+	CHECK_EQUAL(500, config.bandwidth);
+	CHECK_EQUAL(FSK_MODULATION, config.modulation);
+	CHECK_EQUAL(BOOL_TRUE, config.iqInversion);
+	CHECK_EQUAL(SF7, config.spreadingFactor);
+	CHECK_EQUAL(-7, config.snr);
+}
+
+static void testRoundTrip()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	sRadioConfig config;
+	CHECK(orange.getRadioCmds()->snapshot(&config));
+
+	// network byte order, as documented
+	uint8_t buffer[RADIO_CONFIG_SIZE];
+	CHECK_EQUAL(RADIO_CONFIG_SIZE, RadioCmdsClass::serializeConfig(config, buffer));
+	char hex[(2 * RADIO_CONFIG_SIZE) + 1];
+	hex[HexCodec::encode(buffer, sizeof(buffer), hex)] = '\0';
+	CHECK_STRING("0FFF" "C5" "33BE27A0" "01" "00" "34" "0008" "00003A98" "80", hex);
+
+	sRadioConfig decoded;
+	CHECK(RadioCmdsClass::deserializeConfig(buffer, sizeof(buffer), &decoded));
+	CHECK_EQUAL(ALL_FIELDS, decoded.valid);
+	checkDefault(decoded);
+
+	CHECK(!RadioCmdsClass::deserializeConfig(buffer, RADIO_CONFIG_SIZE - 1, &decoded));
+}
+
+static void testRoundTripPartial()
+{
+	// the packed fields which were not received come back as errors, not as the value of bit 0
+	sRadioConfig config;
+	memset(&config, 0, sizeof(config));
+	config.valid = (1 << RADIO_CFG_FREQ) | (1 << RADIO_CFG_BW) | (1 << RADIO_CFG_CR) | (1 << RADIO_CFG_SNR);
+	config.frequency = 869525000;
+	config.bandwidth = 250;
+	config.codingRate = CR_4_7;
+	config.snr = -12;
+	config.modulation = GET_MODULATION_ERROR;
+	config.spreadingFactor = SF_ERROR;
+	config.crc = BOOL_ERROR;
+	config.iqInversion = BOOL_ERROR;
+
+	uint8_t buffer[RADIO_CONFIG_SIZE];
+	RadioCmdsClass::serializeConfig(config, buffer);
+	sRadioConfig decoded;
+	CHECK(RadioCmdsClass::deserializeConfig(buffer, sizeof(buffer), &decoded));
+	CHECK_EQUAL(config.valid, decoded.valid);
+	CHECK_EQUAL(869525000, decoded.frequency);
+	CHECK_EQUAL(250, decoded.bandwidth);
+	CHECK_EQUAL(CR_4_7, decoded.codingRate);
+	CHECK_EQUAL(-12, decoded.snr);
+	CHECK_EQUAL(GET_MODULATION_ERROR, decoded.modulation);
+	CHECK_EQUAL(SF_ERROR, decoded.spreadingFactor);
+	CHECK_EQUAL(BOOL_ERROR, decoded.crc);
+	CHECK_EQUAL(BOOL_ERROR, decoded.iqInversion);
+
+	// a bandwidth which is not 125, 250 or 500 kHz is not encoded
+	config.bandwidth = 100;
+	RadioCmdsClass::serializeConfig(config, buffer);
+	CHECK(RadioCmdsClass::deserializeConfig(buffer, sizeof(buffer), &decoded));
+	CHECK_EQUAL(0, decoded.bandwidth);
+}
+
+int main()
+{
+	testSnapshot(1);
+	testSnapshot(MAX_PENDING_COMMANDS);
+	testMissingFields();
+	testRoundTrip();
+	testRoundTripPartial();
+	return TEST_RESULT();
+}
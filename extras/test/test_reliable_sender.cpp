@@ -0,0 +1,208 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// ReliableSender against the simulated module: backoff on "busy", wait for the next transmission opportunity
+// on "no_free_ch", data rate lowered after missed acknowledgements, rejoin on a frame counter error, and giving
+// up at the deadline, with the attempt and time to acknowledgement histograms
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "ReliableSender.h"
+
+#define UPLINK				"mac tx cnf 1 01"
+
+typedef struct _sEnd {
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange;
+	ReliableSender sender;
+
+	_sEnd() : orange(&request), sender(&orange)
+	{
+		module.setBaudrate(0);
+		orange.init(&module);
+		orange.setDataRate(DATA_RATE_5);
+		orange.rejoin();
+		orange.getDutyCycle()->reset();
+	}
+}sEnd;
+
+// bucket of a time to acknowledgement, [2^(i-1), 2^i[ ms
+static uint8_t bucketOf(uint32_t duration)
+{
+	uint8_t bucket = 0;
+	while ((bucket < ACK_TIME_BUCKETS - 1) && (duration >= (1UL << bucket))) bucket++;
+	return bucket;
+}
+
+static uint32_t total(const uint32_t* histogram, uint8_t count)
+{
+	uint32_t sum = 0;
+	for (uint8_t i = 0; i < count; i++) sum += histogram[i];
+	return sum;
+}
+
+static void testBusy()
+{
+	sEnd end;
+	end.module.script(UPLINK, "busy");
+	end.module.script(UPLINK, "busy");
+
+	// 1 to 2 s, then 2 to 4 s with the default policy, and the acknowledged attempt
+	uint8_t payload[] = { 0x01 };
+	uint32_t start = millis();
+	CHECK(end.sender.send(payload, sizeof(payload), 1, 60000));
+	uint32_t elapsed = millis() - start;
+	CHECK((elapsed >= 3000) && (elapsed < 6000 + 2000));
+	CHECK_EQUAL(3, end.sender.getLastAttempts());
+	CHECK_EQUAL(3, end.module.countCommands(UPLINK));
+
+	sReliableStats stats;
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(2, stats.failures[FAILURE_BUSY]);
+	CHECK_EQUAL(1, stats.delivered);
+	CHECK_EQUAL(3, stats.attempts);
+	CHECK_EQUAL(1, stats.attemptHistogram[2]);
+	CHECK_EQUAL(1, total(stats.attemptHistogram, ATTEMPT_BUCKETS));
+
+	// acknowledged after the backoffs, counted in the bucket of its duration
+	uint8_t bucket = 0;
+	while ((bucket < ACK_TIME_BUCKETS - 1) && (stats.timeToAck[bucket] == 0)) bucket++;
+	CHECK_EQUAL(1, total(stats.timeToAck, ACK_TIME_BUCKETS));
+	CHECK((bucket >= bucketOf(3000)) && (bucket <= bucketOf(elapsed)));
+}
+
+static void testNoFreeChannel()
+{
+	sEnd end;
+	end.module.enforceDutyCycle(true);
+
+	// refused by the local accounting, sent once a channel is free
+	uint8_t payload[] = { 0x01 };
+	while (end.orange.nextTxOpportunity() == 0) CHECK(end.orange.sendMessage(payload, sizeof(payload), 2));
+	uint32_t wait = end.orange.nextTxOpportunity();
+	uint32_t start = millis();
+	CHECK(end.sender.send(payload, sizeof(payload), 1, 600000));
+	CHECK(millis() - start >= wait);
+	CHECK_EQUAL(2, end.sender.getLastAttempts());
+	CHECK_EQUAL(1, end.module.countCommands(UPLINK));
+	CHECK_EQUAL(0, end.module.noFreeChannel);
+
+	// refused by the module while the library saw a free channel: backoff
+	delay(end.orange.nextTxOpportunity());
+	end.module.script(UPLINK, "no_free_ch");
+	start = millis();
+	CHECK(end.sender.send(payload, sizeof(payload), 1, 600000));
+	CHECK(millis() - start >= DEFAULT_RETRY_DELAY / 2);
+	CHECK_EQUAL(2, end.sender.getLastAttempts());
+
+	sReliableStats stats;
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(2, stats.failures[FAILURE_NO_FREE_CH]);
+	CHECK_EQUAL(2, stats.delivered);
+}
+
+static void testDataRateStep()
+{
+	sEnd end;
+	end.module.script(UPLINK, "ok", "mac_err", 1500);
+	end.module.script(UPLINK, "ok", "mac_err", 1500);
+
+	// lowered after the 2 misses of the default policy
+	uint8_t payload[] = { 0x01 };
+	CHECK(end.sender.send(payload, sizeof(payload), 1, 600000));
+	CHECK_EQUAL(3, end.sender.getLastAttempts());
+	CHECK_EQUAL(1, end.module.countCommands("mac set dr 4"));
+	std::string dataRate = end.module.get("mac dr");
+	CHECK_STRING("4", dataRate.c_str());
+
+	sReliableStats stats;
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(2, stats.failures[FAILURE_MAC_ERR]);
+	CHECK_EQUAL(1, stats.drSteps);
+
+	// never lowered with ADR, the network manages the data rate
+	CHECK(end.orange.enableAdr(true));
+	end.module.script(UPLINK, "ok", "mac_err", 1500);
+	end.module.script(UPLINK, "ok", "mac_err", 1500);
+	CHECK(end.sender.send(payload, sizeof(payload), 1, 600000));
+	CHECK_EQUAL(0, end.module.countCommands("mac set dr 3"));
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(1, stats.drSteps);
+}
+
+static void testRejoin()
+{
+	sEnd end;
+	size_t joins = end.module.countCommands("mac join otaa");
+	end.module.script(UPLINK, "frame_counter_err_rejoin_needed");
+
+	uint8_t payload[] = { 0x01 };
+	CHECK(end.sender.send(payload, sizeof(payload), 1, 600000));
+	CHECK_EQUAL(joins + 1, end.module.countCommands("mac join otaa"));
+	CHECK_EQUAL(2, end.sender.getLastAttempts());
+
+	sReliableStats stats;
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(1, stats.rejoins);
+	CHECK_EQUAL(1, stats.failures[FAILURE_REJOIN_NEEDED]);
+
+	// one rejoin allowed per send by the default policy
+	delay(end.orange.nextTxOpportunity());
+	end.module.script(UPLINK, "frame_counter_err_rejoin_needed");
+	end.module.script(UPLINK, "frame_counter_err_rejoin_needed");
+	CHECK(!end.sender.send(payload, sizeof(payload), 1, 600000));
+	CHECK_EQUAL(LORA_ERR_FRAME_CNTR_ERR_REJOIN_NEEDED, end.orange.getLastError());
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(2, stats.rejoins);
+	CHECK_EQUAL(1, stats.givenUp);
+}
+
+static void testDeadline()
+{
+	sEnd end;
+	for (int i = 0; i < 20; i++) end.module.script(UPLINK, "ok", "mac_err", 1500);
+
+	// no attempt started which could not end before the deadline
+	uint8_t payload[] = { 0x01 };
+	uint32_t start = millis();
+	CHECK(!end.sender.send(payload, sizeof(payload), 1, 30000));
+	CHECK(millis() - start <= 30000);
+	CHECK_EQUAL(LORA_MAC_ERR, end.orange.getLastError());
+	CHECK(end.sender.getLastAttempts() >= 2);
+
+	// nothing counted in the histograms of the delivered messages
+	sReliableStats stats;
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(1, stats.messages);
+	CHECK_EQUAL(1, stats.givenUp);
+	CHECK_EQUAL(0, stats.delivered);
+	CHECK_EQUAL(end.sender.getLastAttempts(), stats.attempts);
+	CHECK_EQUAL(0, total(stats.attemptHistogram, ATTEMPT_BUCKETS));
+	CHECK_EQUAL(0, total(stats.timeToAck, ACK_TIME_BUCKETS));
+
+	end.sender.resetStats();
+	end.sender.getStats(&stats);
+	CHECK_EQUAL(0, stats.givenUp);
+}
+
+int main()
+{
+	testBusy();
+	testNoFreeChannel();
+	testDataRateStep();
+	testRejoin();
+	testDeadline();
+	return TEST_RESULT();
+}
@@ -0,0 +1,127 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Module sleep tracked with a deadline: no probe of a sleeping module, a break only before the deadline
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+#define SLEEP_DURATION		10000
+
+static void testEnterSleep()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+
+	// returns at once, the module answers when it wakes up
+	uint32_t start = hostClock();
+	CHECK(orange.getSysCmds()->sleep(SLEEP_DURATION));
+	CHECK(hostClock() - start < 10);
+	CHECK(module.isAsleep());
+	CHECK(orange.getSysCmds()->isAsleep());
+
+	// nothing is written to a sleeping module by the asynchronous API
+	size_t commands = module.commands.size();
+	CHECK_EQUAL(RN_INVALID_HANDLE, request.submit(MAC, GET, "dr", (const char*)NULL));
+	CHECK_EQUAL(LORA_SLEEP, orange.getLastError());
+	CHECK_EQUAL(commands, module.commands.size());
+	CHECK_EQUAL(0, module.getBreakCount());
+	CHECK(!orange.getSysCmds()->sleep(SLEEP_DURATION));
+}
+
+static void testWakeBeforeDeadline()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+
+	CHECK(orange.getSysCmds()->sleep(SLEEP_DURATION));
+	delay(SLEEP_DURATION / 2);
+
+	// the blocking API wakes the module up with a break
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK_EQUAL(1, module.getBreakCount());
+	CHECK(!module.isAsleep());
+	CHECK(!orange.getSysCmds()->isAsleep());
+	CHECK_STRING("mac get dr", module.commands.back().c_str());
+}
+
+static void testWakeAfterDeadline()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	orange.enableCache(false);
+
+	// awake before the deadline of the library, which relies on the "ok" of the module
+	CHECK(orange.getSysCmds()->sleep(SLEEP_DURATION));
+	delay(SLEEP_DURATION + 100);
+	CHECK(!module.isAsleep());
+
+	// no break, no probe
+	uint32_t start = hostClock();
+	CHECK_EQUAL(DATA_RATE_5, orange.getDataRate());
+	CHECK(hostClock() - start < DEFAULT_TIMEOUT);
+	CHECK_EQUAL(0, module.getBreakCount());
+	CHECK_STRING("mac get dr", module.commands.back().c_str());
+}
+
+static void testMissedAnswer()
+{
+	// the "ok" is lost: the module is taken as awake once the deadline is over
+	LoopbackTransport silent;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&silent);
+
+	CHECK(orange.getSysCmds()->sleep(SLEEP_DURATION));
+	CHECK(orange.getSysCmds()->isAsleep());
+	delay(SLEEP_DURATION);
+	CHECK(orange.getSysCmds()->isAsleep());
+	delay((SLEEP_DURATION / 32) + SLEEP_WAKE_MARGIN);
+	CHECK(!orange.getSysCmds()->isAsleep());
+
+	orange.getSysCmds()->wakeUp();
+	CHECK_EQUAL(0, silent.getBreakCount());
+}
+
+static void testRefused()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange(&request);
+	orange.init(&module);
+	module.script("sys sleep 50", "invalid_param");
+
+	// the error comes right away instead of the "ok" at the end
+	CHECK(orange.getSysCmds()->sleep(50));
+	delay(10);
+	CHECK(!orange.getSysCmds()->isAsleep());
+	CHECK_EQUAL(LORA_INVALID_PARAM, orange.getLastError());
+}
+
+int main()
+{
+	testEnterSleep();
+	testWakeBeforeDeadline();
+	testWakeAfterDeadline();
+	testMissedAnswer();
+	testRefused();
+	return TEST_RESULT();
+}
@@ -0,0 +1,145 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Statistics of the command engine: latency buckets of mac tx, sys sleep and radio get, counts of the
+// responses and bytes actually written on the UART
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+
+// UART accepting a limited number of bytes per write
+class ShortWriteModule : public SimulatedModule
+{
+public:
+	uint16_t limit;
+
+	ShortWriteModule() : limit(0xFFFF) {}
+
+	virtual uint16_t write(const uint8_t* data, uint16_t len)
+	{
+		return LoopbackTransport::write(data, (len < this->limit) ? len : this->limit);
+	}
+};
+
+static void run(RnRequestClass* request, RnHandle handle)
+{
+	CHECK(handle != RN_INVALID_HANDLE);
+	while (request->isBusy()) request->poll();
+}
+
+// bucket of a latency, [2^(i-1), 2^i[ ms
+static uint8_t bucketOf(uint32_t latency)
+{
+	uint8_t bucket = 0;
+	while ((bucket < LATENCY_BUCKETS - 1) && (latency >= (1UL << bucket))) bucket++;
+	return bucket;
+}
+
+static uint32_t total(const sRnStats* stats, eCommandStat stat)
+{
+	uint32_t count = 0;
+	for (uint8_t i = 0; i < LATENCY_BUCKETS; i++) count += stats->latency[stat][i];
+	return count;
+}
+
+// runs a command, checking it is counted once in the bucket of its latency, returned
+static uint8_t checkLatency(RnRequestClass* request, eCommandStat stat, uint32_t minLatency, RnHandle handle)
+{
+	uint32_t start = millis();
+	run(request, handle);
+	uint32_t elapsed = millis() - start;
+
+	sRnStats stats;
+	request->getStats(&stats);
+	CHECK_EQUAL(1, total(&stats, stat));
+
+	uint8_t bucket = 0;
+	while ((bucket < LATENCY_BUCKETS - 1) && (stats.latency[stat][bucket] == 0)) bucket++;
+	CHECK((bucket >= bucketOf(minLatency)) && (bucket <= bucketOf(elapsed)));
+	return bucket;
+}
+
+static void testLatencyBuckets()
+{
+	SimulatedModule module;
+	module.setBaudrate(0);
+	RnRequestClass request;
+	request.init(&module);
+
+	request.resetStats();
+	module.script("mac tx cnf 1 01", "ok", "mac_tx_ok", 300);
+	const uint8_t payload[] = { 0x01 };
+	CHECK_EQUAL(9, checkLatency(&request, STAT_MAC_TX, 300, request.submitUplink(STR_CNF, payload, sizeof(payload), 1)));
+
+	request.resetStats();
+	CHECK_EQUAL(8, checkLatency(&request, STAT_SYS_SLEEP, 150, request.submit(SYS, CommandTable::name(SLEEP), NULL, "150")));
+
+	request.resetStats();
+	// answered right away, within a few ms of the virtual clock
+	CHECK(checkLatency(&request, STAT_RADIO_GET, 0, request.submit(RADIO, GET, "sf", (const char*)NULL)) <= 4);
+
+	// the other kinds are left untouched
+	sRnStats stats;
+	request.getStats(&stats);
+	CHECK_EQUAL(0, total(&stats, STAT_MAC_TX));
+	CHECK_EQUAL(0, total(&stats, STAT_SYS_SLEEP));
+	CHECK_EQUAL(0, total(&stats, STAT_MAC_OTHER));
+}
+
+static void testResponseCounts()
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	request.init(&module);
+	request.resetStats();
+
+	module.script("mac get dr", "invalid_param");
+	run(&request, request.submit(MAC, GET, "dr", (const char*)NULL));
+	run(&request, request.submit(MAC, GET, "dr", (const char*)NULL));
+
+	sRnStats stats;
+	request.getStats(&stats);
+	CHECK_EQUAL(1, stats.errorCount[LORA_INVALID_PARAM]);
+	CHECK_EQUAL(2, total(&stats, STAT_MAC_OTHER));
+	CHECK_EQUAL(0, stats.timeoutCount);
+}
+
+static void testBytesWritten()
+{
+	ShortWriteModule module;
+	RnRequestClass request;
+	request.init(&module);
+
+	request.resetStats();
+	run(&request, request.submit(RADIO, GET, "sf", (const char*)NULL));
+	sRnStats stats;
+	request.getStats(&stats);
+	CHECK_EQUAL(strlen("radio get sf\r\n"), stats.bytesWritten);
+	CHECK(stats.bytesRead > 0);
+
+	// only the bytes taken by the UART are counted
+	request.resetStats();
+	module.limit = 5;
+	request.submit(RADIO, GET, "sf", (const char*)NULL);
+	request.getStats(&stats);
+	CHECK_EQUAL(5, stats.bytesWritten);
+}
+
+int main()
+{
+	testLatencyBuckets();
+	testResponseCounts();
+	testBytesWritten();
+	return TEST_RESULT();
+}
@@ -0,0 +1,124 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Serial port of a Linux host, over a pseudo terminal: baudrates and writes larger than the output queue
+
+#include "TestSupport.h"
+#include "TermiosTransport.h"
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+static int openMaster(char* slaveName, size_t size)
+{
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0) || (ptsname_r(master, slaveName, size) != 0)) return -1;
+	return master;
+}
+
+static speed_t getSpeed(const char* device)
+{
+	struct termios tty;
+	int fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	speed_t speed = ((fd >= 0) && (tcgetattr(fd, &tty) == 0)) ? cfgetospeed(&tty) : B0;
+	if (fd >= 0) close(fd);
+	return speed;
+}
+
+static void testBaudrates()
+{
+	char slave[64];
+	int master = openMaster(slave, sizeof(slave));
+	CHECK(master >= 0);
+
+	TermiosTransport transport;
+	CHECK(transport.open(slave, 57600));
+	CHECK_EQUAL(B57600, getSpeed(slave));
+	CHECK(transport.open(slave, 115200));
+	CHECK_EQUAL(B115200, getSpeed(slave));
+	CHECK(transport.open(slave, 9600));
+	CHECK_EQUAL(B9600, getSpeed(slave));
+	CHECK(transport.open(slave, 921600));
+	CHECK_EQUAL(B921600, getSpeed(slave));
+
+	// rejected instead of silently falling back to another rate
+	CHECK(!transport.open(slave, 12345));
+	CHECK(!transport.open(slave, 0));
+	const uint8_t byte = 0x55;
+	CHECK_EQUAL(0, transport.write(&byte, 1));
+
+	CHECK(!transport.open("/nonexistent/tty", 57600));
+	close(master);
+}
+
+static void testLargeWrite()
+{
+	char slave[64];
+	int master = openMaster(slave, sizeof(slave));
+	CHECK(master >= 0);
+
+	TermiosTransport transport;
+	CHECK(transport.open(slave, 57600));
+
+	// far more than the queue of the pseudo terminal, read late and slowly on the other side
+	std::vector<uint8_t> sent(60000);
+	for (size_t i = 0; i < sent.size(); i++) sent[i] = (uint8_t)(i * 7);
+	std::vector<uint8_t> received;
+
+	std::thread reader([&]() {
+		usleep(50000);
+		uint8_t buffer[512];
+		while (received.size() < sent.size())
+		{
+			ssize_t len = read(master, buffer, sizeof(buffer));
+			if (len <= 0) break;
+			received.insert(received.end(), buffer, buffer + len);
+			usleep(100);
+		}
+	});
+
+	CHECK_EQUAL(sent.size(), transport.write(sent.data(), sent.size()));
+	reader.join();
+	CHECK(received == sent);
+	close(master);
+}
+
+static void testWriteTimeout()
+{
+	char slave[64];
+	int master = openMaster(slave, sizeof(slave));
+	CHECK(master >= 0);
+
+	TermiosTransport transport;
+	CHECK(transport.open(slave, 57600));
+
+	// nobody reads: the bytes that fitted are reported
+	std::vector<uint8_t> sent(60000, 0x41);
+	uint16_t written = transport.write(sent.data(), sent.size());
+	CHECK(written > 0);
+	CHECK(written < sent.size());
+	close(master);
+}
+
+int main()
+{
+	testBaudrates();
+	testLargeWrite();
+	testWriteTimeout();
+	return TEST_RESULT();
+}
@@ -0,0 +1,153 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// Trace recording and playback, including a session longer than the 71 minutes of a 32 bits µs clock
+// and a gap of more than 71 minutes between two records
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "TraceReplayer.h"
+
+#include <vector>
+
+#define SESSION_GAP			(40UL * 60 * 1000)	// ms between two commands
+#define LONG_GAP			(75UL * 60 * 1000)
+#define SESSION_COMMANDS	4
+
+class TraceSink : public Print
+{
+public:
+	std::vector<uint8_t> bytes;
+
+	virtual size_t write(uint8_t c)
+	{
+		bytes.push_back(c);
+		return 1;
+	}
+};
+
+static eErrorType lastError;
+static char lastResponse[DEFAULT_INPUT_BUFFER_SIZE];
+
+static void onDone(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context)
+{
+	lastError = errorType;
+	strcpy(lastResponse, (response != NULL) ? (char*)response : "");
+}
+
+static eErrorType getDr(RnRequestClass& request)
+{
+	lastError = LORA_NOT_INIT;
+	request.submit(MAC, GET, "dr", (const char*)NULL, onDone);
+	while (request.isBusy()) request.poll();
+	return lastError;
+}
+
+static void record(TraceSink& sink, uint32_t gap)
+{
+	SimulatedModule module;
+	RnRequestClass request;
+	request.init(&module);
+	CHECK(request.startRecording(&sink));
+
+	for (int i = 0; i < SESSION_COMMANDS; i++)
+	{
+		module.set("mac dr", std::to_string(i));
+		CHECK_EQUAL(LORA_SUCCESS, getDr(request));
+		CHECK_EQUAL(i, atoi(lastResponse));
+		delay(gap);
+	}
+	CHECK(request.stopRecording() == sink.bytes.size());
+}
+
+static void testLongSession()
+{
+	TraceSink sink;
+	record(sink, SESSION_GAP);
+
+	TraceReplayer replayer;
+	RnRequestClass request;
+	CHECK(replayer.begin(sink.bytes.data(), sink.bytes.size()));
+	request.init(&replayer);
+	request.setClock(TraceReplayer::clock, &replayer);
+
+	uint32_t previous = 0;
+	for (int i = 0; i < SESSION_COMMANDS; i++)
+	{
+		CHECK_EQUAL(LORA_SUCCESS, getDr(request));
+		CHECK_EQUAL(i, atoi(lastResponse));
+
+		// the virtual clock goes on past 71 minutes
+		uint32_t now = TraceReplayer::clock(&replayer);
+		CHECK(now >= previous);
+		CHECK(now >= i * SESSION_GAP);
+		previous = now;
+	}
+
+	CHECK(TraceReplayer::clock(&replayer) > 72UL * 60 * 1000);
+	CHECK(replayer.isFinished());
+	CHECK_EQUAL(0, replayer.getMismatchCount());
+	CHECK_EQUAL(2 * SESSION_COMMANDS, replayer.getRecordCount());
+}
+
+static void testLongGap()
+{
+	TraceSink sink;
+	record(sink, LONG_GAP);
+
+	TraceReplayer replayer;
+	RnRequestClass request;
+	CHECK(replayer.begin(sink.bytes.data(), sink.bytes.size()));
+	request.init(&replayer);
+	request.setClock(TraceReplayer::clock, &replayer);
+
+	// each gap is replayed whole, not modulo the 71.6 minutes of micros()
+	for (int i = 0; i < SESSION_COMMANDS; i++)
+	{
+		uint32_t now = TraceReplayer::clock(&replayer);
+		CHECK(now >= i * LONG_GAP);
+		CHECK(now < (i * LONG_GAP) + 1000);
+		CHECK_EQUAL(LORA_SUCCESS, getDr(request));
+		CHECK_EQUAL(i, atoi(lastResponse));
+	}
+	CHECK(replayer.isFinished());
+	CHECK_EQUAL(0, replayer.getMismatchCount());
+}
+
+static void testMismatch()
+{
+	TraceSink sink;
+	record(sink, SESSION_GAP);
+
+	TraceReplayer replayer;
+	RnRequestClass request;
+	CHECK(replayer.begin(sink.bytes.data(), sink.bytes.size()));
+	request.init(&replayer);
+	request.setClock(TraceReplayer::clock, &replayer);
+
+	CHECK(request.submit(MAC, GET, "adr", (const char*)NULL) != RN_INVALID_HANDLE);
+	while (request.isBusy()) request.poll();
+	CHECK_EQUAL(1, replayer.getMismatchCount());
+
+	const uint8_t invalid[] = "RNTX";
+	CHECK(!replayer.begin(invalid, sizeof(invalid)));
+}
+
+int main()
+{
+	testLongSession();
+	testLongGap();
+	testMismatch();
+	return TEST_RESULT();
+}
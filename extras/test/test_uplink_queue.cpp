@@ -0,0 +1,206 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+// UplinkQueue: layout of the packed frames, flush when the next record does not fit, when the oldest record
+// reaches the maximum age and after an urgent record, records kept while the duty cycle is off, and the
+// packing statistics
+
+#include "TestSupport.h"
+#include "SimulatedModule.h"
+#include "OrangeForRN2483.h"
+#include "UplinkQueue.h"
+#include "TimeOnAir.h"
+
+#define UPLINK_PREFIX		"mac tx uncnf 9 "
+
+typedef struct _sEnd {
+	SimulatedModule module;
+	RnRequestClass request;
+	OrangeForRN2483Class orange;
+	UplinkQueue queue;
+
+	_sEnd(eDataRate dataRate) : orange(&request), queue(9, &orange, 60000)
+	{
+		orange.init(&module);
+		orange.setDataRate(dataRate);
+		orange.rejoin();
+	}
+}sEnd;
+
+// hexadecimal payload of the n-th uplink of the queue
+static std::string uplink(SimulatedModule& module, size_t n)
+{
+	for (size_t i = 0; i < module.commands.size(); i++)
+	{
+		const std::string& command = module.commands[i];
+		if ((command.compare(0, strlen(UPLINK_PREFIX), UPLINK_PREFIX) == 0) && (n-- == 0)) return command.substr(strlen(UPLINK_PREFIX));
+	}
+	return "";
+}
+
+static void testPacking()
+{
+	sEnd end(DATA_RATE_5);
+
+	const uint8_t first[] = { 0x01, 0x02, 0x03 };
+	const uint8_t second[] = { 0xAB };
+	CHECK(end.queue.add(first, sizeof(first)));
+	CHECK(end.queue.add(second, sizeof(second)));
+	CHECK_EQUAL(2, end.queue.getPendingRecords());
+	CHECK_EQUAL(0, end.module.countCommands(UPLINK_PREFIX));
+
+	// each record preceded by its length
+	CHECK(end.queue.flush());
+	CHECK_EQUAL(0, end.queue.getPendingRecords());
+	std::string payload = uplink(end.module, 0);
+	CHECK_STRING("03010203" "01AB", payload.c_str());
+
+	// nothing queued, nothing sent
+	CHECK(end.queue.flush());
+	CHECK_EQUAL(1, end.module.countCommands(UPLINK_PREFIX));
+
+	// too long for the data rate
+	uint8_t record[222] = { 0 };
+	CHECK(!end.queue.add(record, 222));
+	CHECK(!end.queue.add((const uint8_t*)NULL, 1));
+	sUplinkQueueStats stats;
+	end.queue.getStats(&stats);
+	CHECK_EQUAL(2, stats.droppedRecords);
+}
+
+static void testFlushOnSize()
+{
+	sEnd end(DATA_RATE_0);
+
+	// 51 bytes at DR0: 2 records of 20 bytes, the third one goes in the next frame
+	uint8_t record[28];
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		memset(record, i, sizeof(record));
+		CHECK(end.queue.add(record, 20));
+	}
+	CHECK_EQUAL(1, end.module.countCommands(UPLINK_PREFIX));
+	CHECK_EQUAL(2 * 2 * (1 + 20), uplink(end.module, 0).size());
+	CHECK_EQUAL(1, end.queue.getPendingRecords());
+
+	// sent as soon as nothing else fits
+	delay(end.orange.nextTxOpportunity());
+	CHECK(end.queue.add(record, 28));
+	CHECK_EQUAL(2, end.module.countCommands(UPLINK_PREFIX));
+	CHECK_EQUAL(0, end.queue.getPendingRecords());
+}
+
+static void testFlushOnAge()
+{
+	sEnd end(DATA_RATE_5);
+
+	const uint8_t record[] = { 0x42 };
+	CHECK(end.queue.add(record, sizeof(record)));
+	delay(30000);
+	CHECK(end.queue.poll());
+	CHECK_EQUAL(0, end.module.countCommands(UPLINK_PREFIX));
+
+	// the age counts from the oldest record
+	CHECK(end.queue.add(record, sizeof(record)));
+	delay(30000);
+	CHECK(end.queue.poll());
+	CHECK_EQUAL(1, end.module.countCommands(UPLINK_PREFIX));
+	std::string payload = uplink(end.module, 0);
+	CHECK_STRING("0142" "0142", payload.c_str());
+}
+
+static void testUrgent()
+{
+	sEnd end(DATA_RATE_5);
+
+	const uint8_t record[] = { 0x01 };
+	const uint8_t alarm[] = { 0xFF };
+	CHECK(end.queue.add(record, sizeof(record)));
+	CHECK(end.queue.add(alarm, sizeof(alarm), true));
+	CHECK_EQUAL(1, end.module.countCommands(UPLINK_PREFIX));
+	std::string payload = uplink(end.module, 0);
+	CHECK_STRING("0101" "01FF", payload.c_str());
+}
+
+static void testDutyCycleOff()
+{
+	sEnd end(DATA_RATE_0);
+	end.orange.getDutyCycle()->reset();
+
+	// the records are kept while the 3 channels are off, then sent together
+	uint8_t record[8] = { 0 };
+	for (int i = 0; i < 3; i++) CHECK(end.queue.add(record, sizeof(record), true));
+	CHECK_EQUAL(3, end.module.countCommands(UPLINK_PREFIX));
+	CHECK(!end.queue.add(record, sizeof(record), true));
+	CHECK(!end.queue.add(record, sizeof(record), true));
+	CHECK_EQUAL(2, end.queue.getPendingRecords());
+	CHECK_EQUAL(3, end.module.countCommands(UPLINK_PREFIX));
+
+	delay(end.orange.nextTxOpportunity());
+	CHECK(end.queue.flush());
+	CHECK_EQUAL(4, end.module.countCommands(UPLINK_PREFIX));
+
+	sUplinkQueueStats stats;
+	end.queue.getStats(&stats);
+	CHECK_EQUAL(5, stats.records);
+	CHECK_EQUAL(4, stats.frames);
+	CHECK_EQUAL(0, stats.failedFrames);
+}
+
+static void testEfficiency()
+{
+	sEnd end(DATA_RATE_5);
+	CHECK_EQUAL(0, end.queue.getPackingEfficiency());
+
+	// 20 records of 4 bytes in one frame of 100 bytes
+	uint8_t record[4] = { 0 };
+	for (int i = 0; i < 20; i++) CHECK(end.queue.add(record, sizeof(record)));
+	CHECK(end.queue.flush());
+
+	sUplinkQueueStats stats;
+	end.queue.getStats(&stats);
+	CHECK_EQUAL(20, stats.records);
+	CHECK_EQUAL(1, stats.frames);
+	CHECK_EQUAL(80, stats.recordBytes);
+	CHECK_EQUAL(100, stats.frameBytes);
+	CHECK_EQUAL(TimeOnAir::dataFrame(DATA_RATE_5, 100), stats.airtime);
+	CHECK_EQUAL((80 * 100) / (100 + LORAWAN_OVERHEAD), end.queue.getPackingEfficiency());
+
+	// one record per uplink, mostly overhead
+	end.queue.resetStats();
+	for (int i = 0; i < 4; i++)
+	{
+		delay(end.orange.nextTxOpportunity());
+		CHECK(end.queue.add(record, sizeof(record), true));
+	}
+	CHECK_EQUAL((16 * 100) / (20 + (4 * LORAWAN_OVERHEAD)), end.queue.getPackingEfficiency());
+
+	// a refused uplink keeps its records
+	end.module.script("mac tx uncnf 9 0400000000", "invalid_param");
+	delay(end.orange.nextTxOpportunity());
+	CHECK(!end.queue.add(record, sizeof(record), true));
+	end.queue.getStats(&stats);
+	CHECK_EQUAL(1, stats.failedFrames);
+	CHECK_EQUAL(1, end.queue.getPendingRecords());
+}
+
+int main()
+{
+	testPacking();
+	testFlushOnSize();
+	testFlushOnAge();
+	testUrgent();
+	testDutyCycleOff();
+	testEfficiency();
+	return TEST_RESULT();
+}
@@ -0,0 +1,108 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "CommandTable.h"
+
+// constant tables of constant pointers: placed in flash instead of being copied in each object
+static const char* const commandTypes[COUNT_TYPE] PROGMEM = { "mac", "sys", "radio" };
+
+static const char* const macParams[COUNT_PARAM_MAC] PROGMEM = {
+	"devaddr",
+	"deveui",
+	"appeui",
+	"band",
+	"dr",
+	"pwridx",
+	"adr",
+	"retx",
+	"rxdelay1",
+	"rxdelay2",
+	"ar",
+	"rx2",
+	"dcycleps",
+	"mrgn",
+	"gwnb",
+	"status",
+	"sync",
+	"upctr",
+	"dnctr",
+	"nwkskey",
+	"appskey",
+	"appkey",
+	"join",
+	"tx",
+	"bat",
+	"linkchk",
+	"save",
+	"pause",
+	"resume",
+	"ch"
+};
+
+static const char* const radioParams[COUNT_PARAM_RAD] PROGMEM = {
+	"rx",
+	"tx",
+	"cw",
+	"bt",
+	"mod",
+	"freq",
+	"pwr",
+	"sf",
+	"afcbw",
+	"rxbw",
+	"bitrate",
+	"fdev",
+	"prlen",
+	"crc",
+	"iqi",
+	"cr",
+	"wdt",
+	"bw",
+	"snr",
+	"sync",
+	"rxstop"
+};
+
+static const char* const sysParams[COUNT_PARAM_SYS] PROGMEM = {
+	"ver",
+	"nvm",
+	"vdd",
+	"pindig",
+	"pinana",
+	"pinmode",
+	"hweui",
+	"sleep",
+	"reset"
+};
+
+#define READ_TOKEN(table, index)		((const char*)pgm_read_ptr(&table[index]))
+
+const char* CommandTable::name(eTypeCommand type)
+{
+	return READ_TOKEN(commandTypes, type);
+}
+
+const char* CommandTable::name(eParamMac param)
+{
+	return READ_TOKEN(macParams, param);
+}
+
+const char* CommandTable::name(eParamRad param)
+{
+	return READ_TOKEN(radioParams, param);
+}
+
+const char* CommandTable::name(eParamSys param)
+{
+	return READ_TOKEN(sysParams, param);
+}
@@ -0,0 +1,153 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			CommandTable.h
+* @brief		Tokens of the commands understood by the module
+* @details		The tokens of the MAC, SYS and RADIO commands are stored once for the whole library in constant
+*				tables placed in flash, and are looked up from the typed command identifiers below.
+*/
+
+#ifndef _COMMAND_TABLE_H
+#define _COMMAND_TABLE_H
+
+#include <Arduino.h>
+
+/**
+* \brief     Different kind of commands which could be sent to the Rn2483 module
+* \details   Each of these values is used to find the corresponding token with \e CommandTable::name()
+*/
+typedef enum _typecmd {
+	MAC = 0,
+	SYS,
+	RADIO,
+	COUNT_TYPE
+}eTypeCommand;
+
+/**
+* \brief     Different kind of MAC commands
+* \details   Each of these values is used to find the corresponding token with \e CommandTable::name()
+*/
+typedef enum _paramMac {
+	DEVADDR = 0,
+	DEVEUI,
+	APPEUI,
+	BAND,
+	DATARATE,
+	PWR_IND_VAL,
+	ADR,
+	RETRANS_NB,
+	RX_DELAY_1,
+	RX_DELAY_2,
+	AUTO_REPLY,
+	RX2,
+	D_CYCLE_PS,
+	DEMOD_MARGIN,
+	GATEWAY_NB,
+	STATUS,
+	SYNC,
+	UP_CTR,
+	DWN_CTR,
+	NWKS_KEY,
+	APPS_KEY,
+	APP_KEY,
+	JOIN,
+	TX_MAC,
+	BAT_LVL,
+	LINK_CHECK,
+	SAVE,
+	PAUSE,
+	RESUME,
+	CHANNEL,
+	COUNT_PARAM_MAC
+}eParamMac;
+
+/**
+* \brief     Different kind of RADIO commands
+* \details   Each of these values is used to find the corresponding token with \e CommandTable::name()
+*/
+typedef enum _paramRad {
+	RX = 0,
+	TX_RADIO,
+	CW,
+	BT,
+	MOD,
+	FREQ,
+	PWR,
+	SPR_FACTOR,
+	AUTO_FREQ_CORR_BW,
+	RECEIVE_BW,
+	BIT_RATE,
+	FREQ_DEVIATION,
+	PREAMBLE_LENGTH,
+	CRC,
+	IQ_INVERS,
+	CODING_RATE,
+	WATCHDOG_TIMER,
+	BANDWIDTH,
+	SIG_NOISE_RATIO,
+	SYNC_RADIO,
+	RX_STOP,
+	COUNT_PARAM_RAD
+}eParamRad;
+
+/**
+* @brief     Different kind of SYS commands
+* @details   Each of these values is used to find the corresponding token with \e CommandTable::name()
+*/
+typedef enum _paramSys {
+	VERSION = 0,
+	NVM,
+	VDD,
+	PIN_DIG,
+	PIN_ANA,
+	PIN_MODE,
+	HWEUI,
+	SLEEP,
+	RESET,
+	COUNT_PARAM_SYS
+}eParamSys;
+
+class CommandTable
+{
+public:
+	/**
+	* @brief		Getter on the token of a kind of command
+	* @param		type		eTypeCommand value
+	* @return		The token ("mac", "sys" or "radio")
+	*/
+	static const char* name(eTypeCommand type);
+
+	/**
+	* @brief		Getter on the token of a MAC command or parameter
+	* @param		param		eParamMac value
+	* @return		The token, such as "dr" for \e DATARATE
+	*/
+	static const char* name(eParamMac param);
+
+	/**
+	* @brief		Getter on the token of a RADIO parameter
+	* @param		param		eParamRad value
+	* @return		The token, such as "sf" for \e SPR_FACTOR
+	*/
+	static const char* name(eParamRad param);
+
+	/**
+	* @brief		Getter on the token of a SYS command or parameter
+	* @param		param		eParamSys value
+	* @return		The token, such as "hweui" for \e HWEUI
+	*/
+	static const char* name(eParamSys param);
+};
+
+#endif
@@ -52,6 +52,17 @@ typedef enum _dataRate {
 	DATA_RATE_ERROR = -1
 }eDataRate;
 
+/**
+* @brief     Different values for the \b region setting
+* @details   Each of these values selects the regional parameters of the network, such as the maximum
+*			 application payload of each data rate
+*/
+typedef enum _eRegion {
+	REGION_EU868 = 0,
+	REGION_EU433,
+	COUNT_REGION
+}eRegion;
+
 /**
 * @brief     Different values for the \b power \b index attribute
 * @details   Each of these values is used to guide the user when trying to set the power index value
@@ -134,10 +145,25 @@ typedef enum _eSpreadingFactor
 }eSpreadingFactor;
 
 
+/**
+* @brief     Different kind of success message
+* @details   Each of these values corresponds to a success keyword recognized by the ResponseClassifier class
+*/
+typedef enum _eSuccessType {
+	LORA_OK = 0,
+	LORA_MAC_TX_OK,
+	LORA_ACCEPTED,
+	LORA_RX,
+	LORA_RADIO_TX_OK,
+	LORA_RADIO_RX,
+	LORA_COUNT_SUCCESS,
+	LORA_FAILED,
+}eSuccessType;
+
 /**
 * @brief     Different kind of error which could be encountered
-* @details   Each of these values is used to find the correct string value in the \e possibleResponses attribute of the OrangeForRn2483 class
-*			 and other error cases
+* @details   The values up to \e LORA_COUNT_ERRORS correspond to the error keywords sent by the module,
+*			 the other ones to the errors detected by the library
 */
 typedef enum _eErrorType {		
 	LORA_SUCCESS = 0,
@@ -155,6 +181,9 @@ typedef enum _eErrorType {
 	LORA_NETWORK_NOT_JOINED,				// Failed to join the network
 	LORA_TIMEOUT,							// A timeout occured while waiting a response
 	LORA_SLEEP,								// The LoRa module is currently sleeping
+	LORA_MAC_ERR,							// The transmission was interrupted or no acknowledgement was received for a confirmed uplink
+	LORA_RADIO_ERR,							// The radio reception timed out or the radio transmission was interrupted
+	LORA_TRANSPORT_ERR,						// The command could not be written entirely to the module
 }eErrorType;
 
 #endif
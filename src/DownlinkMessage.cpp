@@ -18,71 +18,140 @@
 
 
 #include "DownlinkMessage.h"
+#include "HexCodec.h"
 
-DownlinkMessage::DownlinkMessage() {
-	this->port = 0;
-	this->receiveBuffer[0] = '\0';
+#define NIBBLE_NONE						0xFF
+
+DownlinkSink::DownlinkSink(uint8_t* payload, uint16_t capacity) {
+	this->payload = payload;
+	this->capacity = capacity;
+	begin(0);
 }
 
-DownlinkMessage::~DownlinkMessage()
+DownlinkSink::~DownlinkSink()
 {
 
 }
 
-void DownlinkMessage::setPort(uint8_t port)
+void DownlinkSink::setPort(uint8_t port)
+{
+	this->port = port;
+}
+
+void DownlinkSink::begin(uint8_t port)
 {
 	this->port = port;
+	this->length = 0;
+	this->highNibble = NIBBLE_NONE;
+	this->valid = true;
+	this->truncated = false;
+}
+
+void DownlinkSink::write(char digit)
+{
+	int8_t nibble = HexCodec::digitValue(digit);
+	if (nibble == HEX_ERROR)
+	{
+		this->valid = false;
+		return;
+	}
+
+	if (this->highNibble == NIBBLE_NONE)
+	{
+		this->highNibble = nibble;
+		return;
+	}
+
+	if (this->length < this->capacity) this->payload[this->length++] = (this->highNibble << 4) | nibble;
+	else this->truncated = true;
+	this->highNibble = NIBBLE_NONE;
+}
+
+void DownlinkSink::end()
+{
+	// an odd number of digits is not valid hexadecimal
+	if (this->highNibble != NIBBLE_NONE) this->valid = false;
+	if (!this->valid) this->length = 0;
 }
 
-void DownlinkMessage::setResponseMessage(uint8_t* message)
+void DownlinkSink::setResponseMessage(uint8_t* message)
 {
 	if (message == NULL)
 	{
-		receiveBuffer[0] = '\0';
-		this->port = 0;
+		begin(0);
 		return;
 	}
 
-	String msg_str = String((char*)message);
-	int first_idx = msg_str.indexOf(" ");
-	String msgType = msg_str.substring(0, first_idx);
-	int second_idx = msg_str.indexOf(" ", first_idx+1);
-	String port = msg_str.substring(first_idx+1, second_idx);
-	String msg = msg_str.substring(second_idx+1, msg_str.length());
+	// "mac_rx <port> [data]", the keyword is skipped
+	const char* p = (const char*)message;
+	while ((*p != '\0') && (*p != ' ')) p++;
+	if (*p == ' ') p++;
 
-	setPort(port.toInt());
-	strcpy((char*)receiveBuffer, msg.c_str());
+	uint16_t port = 0;
+	while ((*p >= '0') && (*p <= '9')) port = (port * 10) + (*p++ - '0');
+	if (*p == ' ') p++;
+
+	// without data, it was decoded by RnRequestClass as it was received
+	if (*p == '\0')
+	{
+		setPort((uint8_t)port);
+		return;
+	}
+
+	begin((uint8_t)port);
+	while (*p != '\0') write(*p++);
+	end();
 }
 
-uint8_t DownlinkMessage::getPort(){
+uint8_t DownlinkSink::getPort(){
 	return this->port;
 }
 
-const String DownlinkMessage::getMessage() {
-	const String msg = String((char*)receiveBuffer);
-	if (msg == NULL) {
+const String DownlinkSink::getMessage() {
+	String msg = String("");
+	if (this->length == 0) {
 		SerialUSB.println("Response with empty payload");
+		return msg;
+	}
+
+	char hex[33];
+	for (uint16_t i = 0; i < this->length; i += 16)
+	{
+		uint16_t len = ((this->length - i) < 16) ? (this->length - i) : 16;
+		hex[HexCodec::encode(&this->payload[i], len, hex)] = '\0';
+		msg += hex;
 	}
 	return msg;
 }
 
-const uint8_t* DownlinkMessage::getMessageByteArray(int8_t* len) {
-	*len = (int8_t) strlen((char*)receiveBuffer);
+const uint8_t* DownlinkSink::getMessageByteArray(int8_t* len) {
+	*len = 0;
 
-	if (*len == 0) {
+	if (this->length == 0) {
 		SerialUSB.println("Response with empty payload");
 		return NULL;
 	}
 
-	for (int i = 0; i < *len; i++)
-	{
-		char highNibbleStr = receiveBuffer[i * 2];
-		char lowNibbleStr = receiveBuffer[(i * 2) + 1];
+	*len = (this->length > 127) ? 127 : (int8_t)this->length;
+	return this->payload;
+}
 
-		arrayMessage[i] = HEX_CHAR_TO_HIGH_NIBBLE(highNibbleStr) + HEX_CHAR_TO_LOW_NIBBLE(lowNibbleStr);
+uint16_t DownlinkSink::getHexMessage(char* hex, uint16_t size)
+{
+	if ((hex == NULL) || (size < (this->length * 2) + 1)) return 0;
 
-		loraDebugInt((int)arrayMessage[i]); loraDebugPrint(" ");
-	}
-	*len /= 2;
-	return arrayMessage;
-}
\ No newline at end of file
+	uint16_t len = HexCodec::encode(this->payload, this->length, hex);
+	hex[len] = '\0';
+	return len;
+}
+
+const uint8_t* DownlinkSink::getPayload(uint16_t* len)
+{
+	*len = this->length;
+	return (this->length == 0) ? NULL : this->payload;
+}
+
+bool DownlinkSink::isTruncated()
+{
+	return this->truncated;
+}
@@ -28,29 +28,44 @@
 #include "InternalConstForRN2483.h"
 #include <Arduino.h>
 
-class DownlinkMessage
+/**
+* \brief     Decoding of the received data into a buffer given by the owner
+* \details   The data is decoded from the module line as it is received, use DownlinkMessage
+*            or DownlinkMessageBuffer which hold their buffer
+*/
+class DownlinkSink
 {
-private:
-	uint8_t port;
-	uint8_t receiveBuffer[DEFAULT_INPUT_BUFFER_SIZE];	
-	uint8_t arrayMessage[DEFAULT_INPUT_BUFFER_SIZE / 2];
 protected:
+	uint8_t port;
+	uint8_t* payload;
+	uint16_t capacity;
+	uint16_t length;
+	uint8_t highNibble;						// first digit of the byte being decoded, NIBBLE_NONE if none
+	bool valid;
+	bool truncated;
+
+	/**
+	* @brief		Constructor for the DownlinkSink class
+	* @param		payload		Buffer receiving the decoded data
+	* @param		capacity	Size of the buffer
+	*/
+	DownlinkSink(uint8_t* payload, uint16_t capacity);
+
 	void setPort(uint8_t port);
 	void setResponseMessage(uint8_t* message);
+
+	void begin(uint8_t port);
+	void write(char digit);
+	void end();
 public:
 	friend class OrangeForRN2483Class;
+	friend class RnRequestClass;
 
 	/**
-	* @brief		Constructor for the DownlinkMessage class
-	* @details		Used to instanciate a new DownlinkMessage object
+	* @brief		Destructor for the DownlinkSink class
+	* @details		Used to delete an DownlinkSink instance
 	*/
-	DownlinkMessage();
-
-	/**
-	* @brief		Destructor for the DownlinkMessage class
-	* @details		Used to delete an DownlinkMessage instance
-	*/
-	~DownlinkMessage();
+	~DownlinkSink();
 
 	/**
 	* @brief		Getter for the \e port class attribute
@@ -60,20 +75,77 @@ public:
 	uint8_t getPort();
 
 	/**
-	* @brief		Getter for the \e receiveBuffer class attribute as a string value
-	* @details		This function allows the user to have access to the receiveBuffer attribute
-	*				corresponding to the data sent by the server as a string value
-	* @return		String value corresponding to the receiveBuffer attribute value
+	* @brief		Getter on the data sent by the server as a string value
+	* @details		This function allows the user to have access to the data sent by the server as an
+	*				hexadecimal string. The string is built by each call, prefer getPayload()
+	* @return		String value corresponding to the data
 	*/
 	const String getMessage();
 
 	/**
-	* @brief		Getter for the \e receiveBuffer class attribute as a byte array
-	* @details		This function allows the user to have access to the receiveBuffer attribute
-	*				corresponding to the data sent by the server as a byte array
+	* @brief		Getter on the data sent by the server as a byte array
+	* @details		This function allows the user to have access to the data sent by the server as a
+	*				byte array, at most 127 bytes are reported
 	* @param		len		Pointer on an uint8_t value to receive the message length value
-	* @return		Byte array corresponding to the receiveBuffer attribute value
+	* @return		Byte array corresponding to the data
 	*/
 	const uint8_t* getMessageByteArray(int8_t* len);
+
+	/**
+	* @brief		Writing the data sent by the server as an hexadecimal string
+	* @param		hex		Buffer receiving the string, NUL terminated
+	* @param		size	Size of the buffer
+	* @return		Decimal number representing the number of characters written, 0 if the buffer is too small
+	*/
+	uint16_t getHexMessage(char* hex, uint16_t size);
+
+	/**
+	* @brief		Getter on the data sent by the server as bytes, without allocation
+	* @details		The data is decoded from the module line as it is received
+	* @param		len		Pointer on an uint16_t value to receive the number of bytes
+	* @return		Pointer on the bytes, NULL if the message is empty or not valid hexadecimal
+	*/
+	const uint8_t* getPayload(uint16_t* len);
+
+	/**
+	* @brief		Getter on the truncation of the last message
+	* @return		Boolean value, true if the data did not fit in the buffer and its end was lost
+	*/
+	bool isTruncated();
 };
-#endif
\ No newline at end of file
+
+/**
+* \brief     Received data, holding a buffer of DOWNLINK_BUFFER_SIZE bytes
+*/
+class DownlinkMessage : public DownlinkSink
+{
+protected:
+	uint8_t storage[DOWNLINK_BUFFER_SIZE];
+
+public:
+	/**
+	* @brief		Constructor for the DownlinkMessage class
+	*/
+	DownlinkMessage() : DownlinkSink(storage, DOWNLINK_BUFFER_SIZE) {}
+};
+
+/**
+* \brief     Received data, holding a buffer of SIZE bytes
+* \details   SIZE is the largest data kept, up to MAX_DOWNLINK_SIZE
+*/
+template<uint16_t SIZE>
+class DownlinkMessageBuffer : public DownlinkSink
+{
+	static_assert((SIZE > 0) && (SIZE <= MAX_DOWNLINK_SIZE), "SIZE must be from 1 to MAX_DOWNLINK_SIZE");
+
+protected:
+	uint8_t storage[SIZE];
+
+public:
+	/**
+	* @brief		Constructor for the DownlinkMessageBuffer class
+	*/
+	DownlinkMessageBuffer() : DownlinkSink(storage, SIZE) {}
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "DownlinkQueue.h"
+
+DownlinkQueue::DownlinkQueue()
+{
+	this->head = 0;
+	this->count = 0;
+}
+
+bool DownlinkQueue::overlaps(uint16_t offset, uint16_t length)
+{
+	for (uint8_t i = 0; i < this->count; i++)
+	{
+		const sQueuedDownlink* entry = &this->entries[(this->head + i) % DOWNLINK_QUEUE_ENTRIES];
+		if ((offset < entry->offset + entry->length) && (entry->offset < offset + length)) return true;
+	}
+	return false;
+}
+
+bool DownlinkQueue::push(uint8_t port, const uint8_t* payload, uint16_t length)
+{
+	if ((this->count >= DOWNLINK_QUEUE_ENTRIES) || (length > DOWNLINK_QUEUE_BYTES)) return false;
+
+	// right after the newest payload, or back to the start of the pool
+	uint16_t offset = 0;
+	if (this->count > 0)
+	{
+		const sQueuedDownlink* newest = &this->entries[(this->head + this->count - 1) % DOWNLINK_QUEUE_ENTRIES];
+		offset = newest->offset + newest->length;
+		if (offset + length > DOWNLINK_QUEUE_BYTES) offset = 0;
+	}
+	if ((length > 0) && overlaps(offset, length)) return false;
+
+	sQueuedDownlink* entry = &this->entries[(this->head + this->count) % DOWNLINK_QUEUE_ENTRIES];
+	entry->port = port;
+	entry->offset = offset;
+	entry->length = length;
+	if (length > 0) memcpy(&this->data[offset], payload, length);
+	this->count++;
+	return true;
+}
+
+const sQueuedDownlink* DownlinkQueue::peek(const uint8_t** payload)
+{
+	if (this->count == 0) return NULL;
+
+	const sQueuedDownlink* entry = &this->entries[this->head];
+	*payload = &this->data[entry->offset];
+	return entry;
+}
+
+void DownlinkQueue::pop()
+{
+	if (this->count == 0) return;
+
+	this->head = (this->head + 1) % DOWNLINK_QUEUE_ENTRIES;
+	this->count--;
+}
+
+uint8_t DownlinkQueue::getCount()
+{
+	return this->count;
+}
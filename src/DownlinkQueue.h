@@ -0,0 +1,82 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			DownlinkQueue.h
+* @brief		Downlinks waiting to be handed over to the application
+* @details		A fixed number of entries share a byte pool, each payload being kept contiguous so that the
+*				handlers read it in place. The pool is used as a ring: a payload which does not fit at the end
+*				goes back to its start.
+*/
+
+#ifndef _DOWNLINK_QUEUE_H
+#define _DOWNLINK_QUEUE_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+
+/**
+* \brief     Downlink kept by a DownlinkQueue
+*/
+typedef struct _sQueuedDownlink {
+	uint8_t port;
+	uint16_t offset;						// Position of the payload in the byte pool
+	uint16_t length;
+}sQueuedDownlink;
+
+class DownlinkQueue
+{
+protected:
+	uint8_t data[DOWNLINK_QUEUE_BYTES];
+	sQueuedDownlink entries[DOWNLINK_QUEUE_ENTRIES];
+	uint8_t head;
+	uint8_t count;
+
+	bool overlaps(uint16_t offset, uint16_t length);
+
+public:
+	/**
+	* @brief		Constructor for the DownlinkQueue class, the queue is empty
+	*/
+	DownlinkQueue();
+
+	/**
+	* @brief		Queuing a copy of a downlink
+	* @param		port		Port of the downlink
+	* @param		payload		Decoded data
+	* @param		length		Number of bytes
+	* @return		Boolean value, false if there is no room left
+	*/
+	bool push(uint8_t port, const uint8_t* payload, uint16_t length);
+
+	/**
+	* @brief		Getter on the oldest downlink
+	* @param		payload		Pointer receiving the position of its data in the queue
+	* @return		Pointer on the downlink, NULL if the queue is empty
+	*/
+	const sQueuedDownlink* peek(const uint8_t** payload);
+
+	/**
+	* @brief		Removing the oldest downlink, its data is no longer valid
+	*/
+	void pop();
+
+	/**
+	* @brief		Getter on the number of queued downlinks
+	* @return		Decimal number
+	*/
+	uint8_t getCount();
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "DutyCycle.h"
+
+typedef struct _sSubBand {
+	uint32_t minFrequency;					// Hz
+	uint32_t maxFrequency;					// Hz
+	uint16_t inverseDutyCycle;				// 100 for 1%
+}sSubBand;
+
+static const sSubBand subBands[SUB_BANDS] PROGMEM = {
+	{ 863000000, 865000000, 1000 },
+	{ 865000000, 868000000, 100 },
+	{ 868000000, 868600000, 100 },
+	{ 868700000, 869200000, 1000 },
+	{ 869400000, 869650000, 10 },
+	{ 869700000, 870000000, 100 }
+};
+
+DutyCycle::DutyCycle()
+{
+	clearChannels();
+	addChannel(868100000);
+	addChannel(868300000);
+	addChannel(868500000);
+	reset();
+}
+
+int8_t DutyCycle::findSubBand(uint32_t frequency)
+{
+	for (uint8_t i = 0; i < SUB_BANDS; i++)
+	{
+		if ((frequency >= pgm_read_dword(&subBands[i].minFrequency)) && (frequency < pgm_read_dword(&subBands[i].maxFrequency))) return i;
+	}
+	return -1;
+}
+
+bool DutyCycle::addChannel(uint32_t frequency, uint16_t dcycle)
+{
+	int8_t subBand = findSubBand(frequency);
+	if ((this->channelCount >= MAX_CHANNELS) || (subBand < 0)) return false;
+
+	sDutyChannel* channel = &this->channels[this->channelCount++];
+	channel->subBand = (uint8_t)subBand;
+	channel->dcycle = dcycle;
+	channel->blockedUntil = 0;
+	channel->blocked = false;
+	return true;
+}
+
+bool DutyCycle::setChannelDutyCycle(uint8_t channel, uint16_t dcycle)
+{
+	if (channel >= this->channelCount) return false;
+
+	this->channels[channel].dcycle = dcycle;
+	return true;
+}
+
+uint8_t DutyCycle::getChannelCount()
+{
+	return this->channelCount;
+}
+
+void DutyCycle::clearChannels()
+{
+	this->channelCount = 0;
+}
+
+uint32_t DutyCycle::getWait(uint8_t subBand, uint32_t now)
+{
+	if ((this->blocked & (1 << subBand)) == 0) return 0;
+
+	int32_t wait = (int32_t)(this->blockedUntil[subBand] - now);
+	if (wait > 0) return wait;
+
+	this->blocked &= ~(1 << subBand);
+	return 0;
+}
+
+uint32_t DutyCycle::getChannelWait(uint8_t channel, uint32_t now)
+{
+	sDutyChannel* c = &this->channels[channel];
+	if (!c->blocked) return 0;
+
+	int32_t wait = (int32_t)(c->blockedUntil - now);
+	if (wait > 0) return wait;
+
+	c->blocked = false;
+	return 0;
+}
+
+void DutyCycle::record(uint32_t start, uint32_t duration)
+{
+	// first free channel, or the first one to be free again when the module transmitted anyway
+	int8_t channel = -1;
+	uint32_t minWait = 0;
+	for (uint8_t i = 0; i < this->channelCount; i++)
+	{
+		uint32_t wait = getChannelWait(i, start);
+		if ((channel < 0) || (wait < minWait))
+		{
+			channel = i;
+			minWait = wait;
+		}
+		if (wait == 0) break;
+	}
+	if (channel < 0) return;
+
+	sDutyChannel* c = &this->channels[channel];
+	c->blockedUntil = start + (duration * ((uint32_t)c->dcycle + 1));
+	c->blocked = true;
+
+	// the raw radio transmissions in the same sub-band wait for it as well
+	charge(c->subBand, start, duration);
+}
+
+void DutyCycle::record(uint32_t frequency, uint32_t start, uint32_t duration)
+{
+	int8_t subBand = findSubBand(frequency);
+	if (subBand >= 0) charge(subBand, start, duration);
+}
+
+void DutyCycle::charge(uint8_t subBand, uint32_t start, uint32_t duration)
+{
+	this->airtime[subBand] += duration;
+	this->blockedUntil[subBand] = start + (duration * pgm_read_word(&subBands[subBand].inverseDutyCycle));
+	this->blocked |= (1 << subBand);
+}
+
+uint32_t DutyCycle::nextTxOpportunity(uint32_t now)
+{
+	uint32_t minWait = 0xFFFFFFFF;
+	for (uint8_t i = 0; (i < this->channelCount) && (minWait > 0); i++)
+	{
+		uint32_t wait = getChannelWait(i, now);
+		if (wait < minWait) minWait = wait;
+	}
+	return (this->channelCount == 0) ? 0 : minWait;
+}
+
+uint32_t DutyCycle::nextTxOpportunity(uint32_t frequency, uint32_t now)
+{
+	int8_t subBand = findSubBand(frequency);
+	return (subBand < 0) ? 0 : getWait(subBand, now);
+}
+
+uint32_t DutyCycle::getAirtime(uint8_t subBand)
+{
+	return (subBand < SUB_BANDS) ? this->airtime[subBand] : 0;
+}
+
+void DutyCycle::reset()
+{
+	for (uint8_t i = 0; i < this->channelCount; i++) this->channels[i].blocked = false;
+	this->blocked = 0;
+	for (uint8_t i = 0; i < SUB_BANDS; i++)
+	{
+		this->blockedUntil[i] = 0;
+		this->airtime[i] = 0;
+	}
+}
@@ -0,0 +1,136 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			DutyCycle.h
+* @brief		Accounting of the time on air, as the RN2483 enforces it
+* @details		The module enforces the duty cycle per channel: after a transmission of T ms on a channel, the
+*				channel is off until T * (dcycle + 1) ms after the start of the transmission, dcycle being the value of
+*				"mac set ch dcycle", 302 for the 3 default channels (1% shared by the 3 channels of the sub-band).
+*				The module picks a free channel itself: an uplink or a join request is charged to the first free
+*				channel, which gives the same off-times as long as the channels have the same dcycle. The raw radio
+*				transmissions, which the module does not limit, follow the EU868 sub-band of their frequency: after
+*				T ms in a sub-band with a duty cycle of 1/N, uplinks included, the sub-band is off until T * N ms after
+*				the start.
+*/
+
+#ifndef _DUTY_CYCLE_H
+#define _DUTY_CYCLE_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+
+/**
+* \brief     Channel of the module, numbered as on the module in the order of declaration
+*/
+typedef struct _sDutyChannel {
+	uint32_t blockedUntil;
+	uint16_t dcycle;						// off-time of dcycle + 1 times the time on air
+	uint8_t subBand;						// EU868 sub-band of the frequency of the channel
+	bool blocked;
+}sDutyChannel;
+
+class DutyCycle
+{
+protected:
+	sDutyChannel channels[MAX_CHANNELS];
+	uint8_t channelCount;
+
+	uint32_t blockedUntil[SUB_BANDS];		// for the raw radio transmissions
+	uint8_t blocked;						// bit set while the sub-band is off
+	uint32_t airtime[SUB_BANDS];
+
+	static int8_t findSubBand(uint32_t frequency);
+	uint32_t getWait(uint8_t subBand, uint32_t now);
+	uint32_t getChannelWait(uint8_t channel, uint32_t now);
+	void charge(uint8_t subBand, uint32_t start, uint32_t duration);
+
+public:
+	/**
+	* @brief		Constructor for the DutyCycle class, with the 3 default EU868 channels
+	*/
+	DutyCycle();
+
+	/**
+	* @brief		Declaring a channel enabled on the module
+	* @param		frequency	Frequency of the channel in Hz
+	* @param		dcycle		Duty cycle of the channel, as "mac set ch dcycle": 100 / (dcycle + 1) %
+	* @return		Boolean value, false if the frequency is out of the EU868 band or there are too many channels
+	*/
+	bool addChannel(uint32_t frequency, uint16_t dcycle = DEFAULT_CHANNEL_DCYCLE);
+
+	/**
+	* @brief		Changing the duty cycle of a declared channel
+	* @param		channel		Channel number, from 0 to the number of declared channels - 1
+	* @param		dcycle		Duty cycle of the channel, as "mac set ch dcycle": 100 / (dcycle + 1) %
+	* @return		Boolean value, false if the channel is not declared
+	*/
+	bool setChannelDutyCycle(uint8_t channel, uint16_t dcycle);
+
+	/**
+	* @brief		Getter on the number of declared channels
+	* @return		Decimal number
+	*/
+	uint8_t getChannelCount();
+
+	/**
+	* @brief		Removing all the channels, before declaring the ones of a new channel plan
+	*/
+	void clearChannels();
+
+	/**
+	* @brief		Charging an uplink or a join request
+	* @param		start		Time in ms when the transmission started
+	* @param		duration	Time on air in ms
+	*/
+	void record(uint32_t start, uint32_t duration);
+
+	/**
+	* @brief		Charging a transmission on a given frequency, as "radio tx" does
+	* @details		Frequencies out of the EU868 sub-bands are not charged
+	* @param		frequency	Frequency of the transmission in Hz
+	* @param		start		Time in ms when the transmission started
+	* @param		duration	Time on air in ms
+	*/
+	void record(uint32_t frequency, uint32_t start, uint32_t duration);
+
+	/**
+	* @brief		Getter on the delay before the next uplink or join request is allowed
+	* @param		now			Current time in ms
+	* @return		Duration in ms, 0 if a channel is free now
+	*/
+	uint32_t nextTxOpportunity(uint32_t now);
+
+	/**
+	* @brief		Getter on the delay before the next transmission is allowed on a given frequency
+	* @param		frequency	Frequency of the transmission in Hz
+	* @param		now			Current time in ms
+	* @return		Duration in ms, 0 if a transmission is allowed now or the frequency is out of the EU868 sub-bands
+	*/
+	uint32_t nextTxOpportunity(uint32_t frequency, uint32_t now);
+
+	/**
+	* @brief		Getter on the time on air charged to a sub-band
+	* @param		subBand		Position of the sub-band, from 0 to SUB_BANDS - 1
+	* @return		Duration in ms
+	*/
+	uint32_t getAirtime(uint8_t subBand);
+
+	/**
+	* @brief		Forgetting the past transmissions, all the sub-bands are available
+	*/
+	void reset();
+};
+
+#endif
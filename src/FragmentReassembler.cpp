@@ -0,0 +1,80 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "FragmentReassembler.h"
+
+FragmentReassembler::FragmentReassembler()
+{
+	this->messageLength = 0;
+	this->messageNumber = 0;
+	this->nextIndex = MAX_FRAGMENTS;
+	this->droppedMessages = 0;
+}
+
+eReassemblyState FragmentReassembler::accept(const uint8_t* frame, uint16_t len)
+{
+	if ((frame == NULL) || (len < FRAGMENT_HEADER_SIZE)) return REASSEMBLY_DROPPED;
+
+	uint8_t number = frame[0];
+	uint8_t index = frame[1] & ~FRAGMENT_LAST;
+	bool last = (frame[1] & FRAGMENT_LAST) != 0;
+
+	if (index == 0)
+	{
+		if (this->nextIndex < MAX_FRAGMENTS) this->droppedMessages++;
+
+		this->messageNumber = number;
+		this->messageLength = 0;
+		this->nextIndex = 0;
+	}
+	else if ((this->nextIndex >= MAX_FRAGMENTS) || (number != this->messageNumber) || (index != this->nextIndex))
+	{
+		// a fragment was lost, the rest of the message is useless
+		if (this->nextIndex < MAX_FRAGMENTS) this->droppedMessages++;
+		this->nextIndex = MAX_FRAGMENTS;
+		this->messageLength = 0;
+		return REASSEMBLY_DROPPED;
+	}
+
+	len -= FRAGMENT_HEADER_SIZE;
+	if (this->messageLength + len > REASSEMBLY_BUFFER_SIZE)
+	{
+		this->droppedMessages++;
+		this->nextIndex = MAX_FRAGMENTS;
+		this->messageLength = 0;
+		return REASSEMBLY_DROPPED;
+	}
+
+	memcpy(&this->message[this->messageLength], &frame[FRAGMENT_HEADER_SIZE], len);
+	this->messageLength += len;
+	this->nextIndex++;
+
+	if (!last) return REASSEMBLY_PENDING;
+
+	this->nextIndex = MAX_FRAGMENTS;
+	return REASSEMBLY_COMPLETE;
+}
+
+const uint8_t* FragmentReassembler::getMessage(uint16_t* len)
+{
+	// the message stays available until the next first fragment
+	if ((this->nextIndex < MAX_FRAGMENTS) || (this->messageLength == 0)) return NULL;
+
+	*len = this->messageLength;
+	return this->message;
+}
+
+uint32_t FragmentReassembler::getDroppedMessages()
+{
+	return this->droppedMessages;
+}
@@ -0,0 +1,76 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			FragmentReassembler.h
+* @brief		Rebuilding of the messages sent by OrangeForRN2483Class::sendFragmented()
+* @details		Meant for the application server: the uplinks of one device are given in the order of their
+*				frame counter. Each fragment starts with the message number and the fragment index, the last
+*				fragment having the FRAGMENT_LAST flag. A missing fragment drops the whole message.
+*/
+
+#ifndef _FRAGMENT_REASSEMBLER_H
+#define _FRAGMENT_REASSEMBLER_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+
+/**
+* \brief     Result of FragmentReassembler::accept()
+*/
+typedef enum _eReassemblyState {
+	REASSEMBLY_PENDING = 0,					// More fragments are expected
+	REASSEMBLY_COMPLETE,					// The message is available with getMessage()
+	REASSEMBLY_DROPPED						// The fragment is not the expected one or the message is too long
+}eReassemblyState;
+
+class FragmentReassembler
+{
+protected:
+	uint8_t message[REASSEMBLY_BUFFER_SIZE];
+	uint16_t messageLength;
+	uint8_t messageNumber;
+	uint8_t nextIndex;						// MAX_FRAGMENTS when no message is in progress
+	uint32_t droppedMessages;
+
+public:
+	/**
+	* @brief		Constructor for the FragmentReassembler class
+	*/
+	FragmentReassembler();
+
+	/**
+	* @brief		Handing over the payload of an uplink
+	* @details		A first fragment starts a new message, the one in progress being dropped
+	* @param		frame		Application payload of the uplink, header included
+	* @param		len			Number of bytes of the payload
+	* @return		eReassemblyState value
+	*/
+	eReassemblyState accept(const uint8_t* frame, uint16_t len);
+
+	/**
+	* @brief		Getter on the last complete message
+	* @param		len			Pointer on an uint16_t value to receive the message length
+	* @return		Pointer on the message, NULL if no message is complete
+	*/
+	const uint8_t* getMessage(uint16_t* len);
+
+	/**
+	* @brief		Getter on the number of messages dropped because of a missing fragment
+	* @return		Decimal number
+	*/
+	uint32_t getDroppedMessages();
+};
+
+#endif
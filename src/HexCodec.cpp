@@ -0,0 +1,104 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "HexCodec.h"
+
+#define INVALID_DIGIT		0xFF
+
+static const char hexDigits[16] PROGMEM = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+// value of each character, INVALID_DIGIT for the ones which are not hexadecimal digits
+static const uint8_t hexValues[256] PROGMEM = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+#define DIGIT(c)			pgm_read_byte(&hexDigits[(c) & 0x0F])
+#define VALUE(c)			pgm_read_byte(&hexValues[(uint8_t)(c)])
+
+uint16_t HexCodec::encode(const uint8_t* data, uint16_t len, char* hex)
+{
+	uint16_t i = 0;
+
+	// 4 bytes per iteration
+	for (; i + 4 <= len; i += 4)
+	{
+		uint8_t b0 = data[i], b1 = data[i + 1], b2 = data[i + 2], b3 = data[i + 3];
+		char* out = &hex[i * 2];
+
+		out[0] = DIGIT(b0 >> 4); out[1] = DIGIT(b0);
+		out[2] = DIGIT(b1 >> 4); out[3] = DIGIT(b1);
+		out[4] = DIGIT(b2 >> 4); out[5] = DIGIT(b2);
+		out[6] = DIGIT(b3 >> 4); out[7] = DIGIT(b3);
+	}
+
+	for (; i < len; i++)
+	{
+		hex[i * 2] = DIGIT(data[i] >> 4);
+		hex[(i * 2) + 1] = DIGIT(data[i]);
+	}
+	return len * 2;
+}
+
+int16_t HexCodec::decode(const char* hex, uint16_t hexLen, uint8_t* data)
+{
+	if ((hexLen & 1) != 0) return HEX_ERROR;
+
+	uint16_t len = hexLen / 2;
+	uint16_t i = 0;
+
+	// 4 bytes per iteration, invalid digits are detected once per block thanks to their high nibble
+	for (; i + 4 <= len; i += 4)
+	{
+		const char* in = &hex[i * 2];
+		uint8_t v0 = VALUE(in[0]), v1 = VALUE(in[1]), v2 = VALUE(in[2]), v3 = VALUE(in[3]);
+		uint8_t v4 = VALUE(in[4]), v5 = VALUE(in[5]), v6 = VALUE(in[6]), v7 = VALUE(in[7]);
+
+		if (((v0 | v1 | v2 | v3 | v4 | v5 | v6 | v7) & 0xF0) != 0) return HEX_ERROR;
+
+		data[i] = (v0 << 4) | v1;
+		data[i + 1] = (v2 << 4) | v3;
+		data[i + 2] = (v4 << 4) | v5;
+		data[i + 3] = (v6 << 4) | v7;
+	}
+
+	for (; i < len; i++)
+	{
+		uint8_t high = VALUE(hex[i * 2]);
+		uint8_t low = VALUE(hex[(i * 2) + 1]);
+
+		if (((high | low) & 0xF0) != 0) return HEX_ERROR;
+		data[i] = (high << 4) | low;
+	}
+	return len;
+}
+
+int8_t HexCodec::digitValue(char c)
+{
+	uint8_t value = VALUE(c);
+	return (value == INVALID_DIGIT) ? HEX_ERROR : value;
+}
@@ -0,0 +1,60 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			HexCodec.h
+* @brief		Conversions between byte arrays and hexadecimal strings
+* @details		This class gathers the hexadecimal encoding and decoding used to exchange keys,
+*				payloads and identifiers with the module. Decoding is done through a 256 entries
+*				lookup table, accepts upper and lower case characters and reports invalid ones.
+*/
+
+#ifndef _HEX_CODEC_H
+#define _HEX_CODEC_H
+
+#include <Arduino.h>
+
+#define HEX_ERROR						-1
+
+class HexCodec
+{
+public:
+	/**
+	* @brief		Encoding a byte array as an hexadecimal string
+	* @details		Writes \e 2 * \e len upper case characters, without terminating the string
+	* @param		data		Byte array to encode
+	* @param		len			Size of the byte array
+	* @param		hex			Buffer receiving the characters, at least \e 2 * \e len bytes long
+	* @return		Decimal number representing the number of written characters
+	*/
+	static uint16_t encode(const uint8_t* data, uint16_t len, char* hex);
+
+	/**
+	* @brief		Decoding an hexadecimal string into a byte array
+	* @param		hex			Characters to decode, upper or lower case
+	* @param		hexLen		Number of characters to decode, must be even
+	* @param		data		Buffer receiving the bytes, at least \e hexLen / 2 bytes long
+	* @return		Decimal number representing the number of decoded bytes, \e HEX_ERROR if the length is odd
+	*				or a character is not an hexadecimal digit
+	*/
+	static int16_t decode(const char* hex, uint16_t hexLen, uint8_t* data);
+
+	/**
+	* @brief		Getter on the value of an hexadecimal digit
+	* @param		c			Character to convert
+	* @return		Value from 0 to 15, \e HEX_ERROR if the character is not an hexadecimal digit
+	*/
+	static int8_t digitValue(char c);
+};
+
+#endif
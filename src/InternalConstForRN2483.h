@@ -38,21 +38,84 @@
 #define loraDebugIntLn(...)
 #endif
 
-#define HEX_CHAR_TO_HIGH_NIBBLE(X) (((X >= 'A') ? X - 'A' + 10 : X - '0') << 4)
-#define HEX_CHAR_TO_LOW_NIBBLE(X) ((X >= 'A') ? X - 'A' + 10 : X - '0')
-
-#define NIBBLE_TO_HEX_CHAR(i) ((i <= 9) ? ('0' + i) : ('A' - 10 + i))
-#define HIGH_NIBBLE(i) ((i >> 4) & 0x0F)
-#define LOW_NIBBLE(i) (i & 0x0F)
-
-#define iS_ON(X) X.equals("on") ? BOOL_TRUE : BOOL_FALSE
+#define iS_ON(X) ((strcmp((const char*)(X), STR_ON) == 0) ? BOOL_TRUE : BOOL_FALSE)
 
 #define DEFAULT_TIMEOUT					200
-#define UPLINK_TIMEOUT					7000
 #define SAVE_TIMEOUT					2000
-#define JOIN_TIMEOUT					10000  // TimeOnAir + RX2Window 
+#define SLEEP_WAKE_MARGIN				20		// ms after the end of "sys sleep" before the module is surely awake
+
+#define LORAWAN_OVERHEAD				13		// MHDR + FHDR + FPort + MIC
+#define LORAWAN_PREAMBLE				8
+#define JOIN_REQUEST_SIZE				23
+#define JOIN_ACCEPT_SIZE				33		// with CFList
+#define FSK_FRAME_OVERHEAD				11		// preamble + sync word + length + CRC
+#define FSK_BYTE_TIME					160		// µs at 50 kbps
+#define DEFAULT_RX_DELAY_1				1000
+#define DEFAULT_RETX					7
+#define RX_WINDOW_GAP					1000	// RX2 opens 1 s after RX1
+#define JOIN_ACCEPT_DELAY2				6000
+#define ACK_TIMEOUT_MIN					1000
+#define ACK_TIMEOUT_MAX					3000
+#define AIRTIME_MARGIN					500
+
+#define RN2483_BAUDRATE					57600
+#define BREAK_BAUDRATE					300
+#define TERMIOS_WRITE_TIMEOUT			1000	// ms without room in the output queue of a host serial port
 
 #define DEFAULT_INPUT_BUFFER_SIZE		64 
+#define DEFAULT_OUTPUT_BUFFER_SIZE		464		// "mac tx uncnf 223 " + 222 bytes as hexadecimal string + CRLF + '\0'
+#define MAX_PENDING_COMMANDS			4
+#define MAX_EVENT_HANDLERS				4
+#define RX_RING_SIZE					256		// power of 2
+#define LOOPBACK_BUFFER_SIZE			512		// power of 2
+#define MAX_BATCH_COMMANDS				9		// every field of a device profile
+#define MAX_BATCH_VALUE_SIZE			33		// 16 bytes key as hexadecimal string
+#define DEFAULT_BATCH_WINDOW			2
+#ifndef RN_PARAM_CACHE
+#define RN_PARAM_CACHE					0		// 1 keeps the values of the parameter cache, 490 bytes of RAM
+#endif
+#define CACHED_PARAMS					29		// at most 32
+#define CACHE_VALUE_SIZE				17		// EUI as hexadecimal string
+#ifndef RN_STATS
+#define RN_STATS						0		// 1 keeps the statistics of RnRequestClass, 324 bytes of RAM
+#endif
+#define LATENCY_BUCKETS					16		// log2 of the latency in ms, the last one gathers the longer ones
+#define UPLINK_FRAME_SIZE				222		// largest application payload, DR4 and above
+#define MAX_DOWNLINK_SIZE				222		// largest downlink application payload, DR4 and above
+#ifndef DOWNLINK_BUFFER_SIZE
+#define DOWNLINK_BUFFER_SIZE			MAX_DOWNLINK_SIZE	// can be lowered at compile time to save RAM
+#endif
+#ifndef DOWNLINK_QUEUE_ENTRIES
+#define DOWNLINK_QUEUE_ENTRIES			4
+#endif
+#ifndef DOWNLINK_QUEUE_BYTES
+#define DOWNLINK_QUEUE_BYTES			256		// one downlink of the largest size, more when they are shorter
+#endif
+#define MAX_DOWNLINK_HANDLERS			4
+#define RADIO_CONFIG_SIZE				17		// serialized sRadioConfig, fits in a DR0 uplink
+#define P2P_HEADER_SIZE					2		// sequence number
+#define P2P_MAX_PACKET_SIZE				222		// "radio tx" of the largest packet fits in the output buffer
+#ifndef P2P_TX_BUFFER_SIZE
+#define P2P_TX_BUFFER_SIZE				512		// power of 2
+#endif
+#ifndef P2P_RX_BUFFER_SIZE
+#define P2P_RX_BUFFER_SIZE				1024	// power of 2
+#endif
+#define DEFAULT_P2P_RX_WINDOW			1000	// ms listened before sending the queued data
+#define DEFAULT_UPLINK_MAX_AGE			600000	// 10 minutes
+#define FRAGMENT_HEADER_SIZE			2		// message number, fragment index with the last fragment flag
+#define FRAGMENT_LAST					0x80
+#define MAX_FRAGMENTS					128
+#define REASSEMBLY_BUFFER_SIZE			1024
+#define MAX_CHANNELS					16
+#define SUB_BANDS						6		// EU868 sub-bands of ETSI EN 300 220
+#define DEFAULT_CHANNEL_DCYCLE			302		// 0.33% per default channel, 1% for the 3 of them
+#define ACK_TIME_BUCKETS				20		// log2 of the time to acknowledgement in ms, up to 17 minutes
+#define ATTEMPT_BUCKETS					8		// the last one gathers the longer series
+#define DEFAULT_RETRY_DELAY				2000
+#define DEFAULT_MAX_RETRY_DELAY			60000
+#define DEFAULT_MISSES_BEFORE_DR_STEP	2
+#define DEFAULT_MAX_REJOINS				1
 
 #define SEPARATOR						((char*)" ")
 #define STR_OTAA						"otaa"
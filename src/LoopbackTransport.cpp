@@ -0,0 +1,112 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "LoopbackTransport.h"
+
+LoopbackTransport::LoopbackTransport()
+{
+	this->rxHead = 0;
+	this->rxTail = 0;
+	this->writtenLength = 0;
+	this->lineLength = 0;
+	this->responder = NULL;
+	this->context = NULL;
+	this->breakCount = 0;
+}
+
+int LoopbackTransport::available()
+{
+	return (this->rxHead - this->rxTail) & (LOOPBACK_BUFFER_SIZE - 1);
+}
+
+uint16_t LoopbackTransport::read(uint8_t* buffer, uint16_t size)
+{
+	uint16_t len = 0;
+	while ((len < size) && (this->rxTail != this->rxHead))
+	{
+		buffer[len++] = this->rxRing[this->rxTail];
+		this->rxTail = (this->rxTail + 1) & (LOOPBACK_BUFFER_SIZE - 1);
+	}
+	return len;
+}
+
+uint16_t LoopbackTransport::write(const uint8_t* data, uint16_t len)
+{
+	for (uint16_t i = 0; i < len; i++)
+	{
+		if (this->writtenLength < LOOPBACK_BUFFER_SIZE) this->written[this->writtenLength++] = data[i];
+
+		if (data[i] == '\n')
+		{
+			uint16_t lineLength = this->lineLength;
+			if ((lineLength > 0) && (this->line[lineLength - 1] == '\r')) lineLength--;
+			this->lineLength = 0;
+
+			if (this->responder != NULL) this->responder(this, this->line, lineLength, this->context);
+		}
+		else if (this->lineLength < DEFAULT_OUTPUT_BUFFER_SIZE)
+		{
+			this->line[this->lineLength++] = data[i];
+		}
+	}
+	return len;
+}
+
+void LoopbackTransport::sendBreak()
+{
+	this->breakCount++;
+	this->lineLength = 0;
+}
+
+uint16_t LoopbackTransport::inject(const uint8_t* data, uint16_t len)
+{
+	uint16_t i = 0;
+	for (; i < len; i++)
+	{
+		uint16_t next = (this->rxHead + 1) & (LOOPBACK_BUFFER_SIZE - 1);
+		if (next == this->rxTail) break;
+
+		this->rxRing[this->rxHead] = data[i];
+		this->rxHead = next;
+	}
+	return i;
+}
+
+bool LoopbackTransport::injectLine(const char* response)
+{
+	uint16_t len = strlen(response);
+	if (inject((const uint8_t*)response, len) != len) return false;
+	return (inject((const uint8_t*)CRLF, 2) == 2);
+}
+
+void LoopbackTransport::setResponder(loopbackResponder responder, void* context)
+{
+	this->context = context;
+	this->responder = responder;
+}
+
+const uint8_t* LoopbackTransport::getWritten(uint16_t* len)
+{
+	*len = this->writtenLength;
+	return this->written;
+}
+
+void LoopbackTransport::clearWritten()
+{
+	this->writtenLength = 0;
+}
+
+uint16_t LoopbackTransport::getBreakCount()
+{
+	return this->breakCount;
+}
@@ -0,0 +1,107 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			LoopbackTransport.h
+* @brief		In memory transport standing for the module
+* @details		The bytes written by the library are logged and split into lines handed to a responder,
+*				which plays the module by injecting its responses. Meant for tests and benchmarks
+*/
+
+#ifndef _LOOPBACK_TRANSPORT_H
+#define _LOOPBACK_TRANSPORT_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "RnTransport.h"
+
+class LoopbackTransport;
+
+/**
+* \brief     Function playing the module
+* \details   Called for each command written by the library, \e line being the command without its CRLF
+*/
+typedef void(*loopbackResponder)(LoopbackTransport* loopback, const uint8_t* line, uint16_t len, void* context);
+
+class LoopbackTransport : public RnTransport
+{
+protected:
+	uint8_t rxRing[LOOPBACK_BUFFER_SIZE];
+	uint16_t rxHead;
+	uint16_t rxTail;
+
+	uint8_t written[LOOPBACK_BUFFER_SIZE];
+	uint16_t writtenLength;
+
+	uint8_t line[DEFAULT_OUTPUT_BUFFER_SIZE];
+	uint16_t lineLength;
+
+	loopbackResponder responder;
+	void* context;
+	uint16_t breakCount;
+
+public:
+	/**
+	* @brief		Constructor for the LoopbackTransport class
+	*/
+	LoopbackTransport();
+
+	virtual int available();
+	virtual uint16_t read(uint8_t* buffer, uint16_t size);
+	virtual uint16_t write(const uint8_t* data, uint16_t len);
+	virtual void sendBreak();
+
+	/**
+	* @brief		Queuing bytes to be read by the library, as if sent by the module
+	* @param		data		Bytes to queue
+	* @param		len			Number of bytes to queue
+	* @return		Decimal number representing the number of queued bytes, lower than \e len if the buffer is full
+	*/
+	uint16_t inject(const uint8_t* data, uint16_t len);
+
+	/**
+	* @brief		Queuing a response line, followed by CRLF
+	* @param		response	String value representing the response
+	* @return		Boolean value, true if the whole line was queued
+	*/
+	bool injectLine(const char* response);
+
+	/**
+	* @brief		Setter for the function playing the module
+	* @param		responder	Function called for each written command, or NULL
+	* @param		context		Pointer given back to the responder
+	*/
+	void setResponder(loopbackResponder responder, void* context = NULL);
+
+	/**
+	* @brief		Getter on the bytes written by the library since the last call to \e clearWritten()
+	* @details		Bytes written once the log is full are not kept
+	* @param		len			Pointer on an uint16_t value to receive the number of logged bytes
+	* @return		Pointer on the logged bytes
+	*/
+	const uint8_t* getWritten(uint16_t* len);
+
+	/**
+	* @brief		Emptying the log of the written bytes
+	*/
+	void clearWritten();
+
+	/**
+	* @brief		Getter on the number of break conditions sent by the library
+	* @return		Decimal number
+	*/
+	uint16_t getBreakCount();
+};
+
+#endif
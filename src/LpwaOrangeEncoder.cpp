@@ -20,13 +20,14 @@
 
 #define MAX_LEN_PAYLOAD			64
 
-#define CHECK_COUNTER(X)		if((counter + (X - 1)) >= MAX_LEN_PAYLOAD) return false;  // X = byte length of value
+#define CHECK_COUNTER(X)		if((counter + (X - 1)) >= maxLength) return false;  // X = byte length of value
 
 LpwaOrangeEncoderClass LpwaOrangeEncoder;
 
 LpwaOrangeEncoderClass::LpwaOrangeEncoderClass()
 {
     counter = 0;
+    maxLength = MAX_LEN_PAYLOAD;
     memset(framePayload, 0, MAX_LEN_PAYLOAD);
 }
 
@@ -40,6 +41,11 @@ void LpwaOrangeEncoderClass::flush()
 	memset(framePayload, 0, MAX_LEN_PAYLOAD);
 }
 
+void LpwaOrangeEncoderClass::setMaxLength(uint8_t maxLength)
+{
+	this->maxLength = (maxLength < MAX_LEN_PAYLOAD) ? maxLength : MAX_LEN_PAYLOAD;
+}
+
 uint8_t* LpwaOrangeEncoderClass::getFramePayload(int8_t* len)
 {
 	if (len == 0) return NULL;
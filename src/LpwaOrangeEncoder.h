@@ -32,6 +32,7 @@ class LpwaOrangeEncoderClass
 private:
     char framePayload[64];
     int counter;
+    int maxLength;
  
 public:
 	/**
@@ -52,6 +53,14 @@ public:
 	*/
 	void flush();
 
+	/**
+	* @brief		Setter for the maximal length of a payload
+	* @details		Typically the value of OrangeForRN2483Class::getMaxPayloadSize(), so that a payload built by
+	*				the encoder is never refused for its length. The length is at most 64 bytes
+	* @param		maxLength	Maximal length in bytes
+	*/
+	void setMaxLength(uint8_t maxLength);
+
 	/**
 	* @brief		Getter for a payload and its length
 	* @details		This function allows the user to get a pointer on a frame payload to be able to manipulate it easily
@@ -0,0 +1,139 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "NumberParser.h"
+#include "HexCodec.h"
+
+#define MAX_HEX_DIGITS		8
+
+bool NumberParser::isEnd(char c)
+{
+	return (c == '\0') || (c == ' ');
+}
+
+// Decimal digits up to the first non digit, NULL if there is none or the value exceeds limit
+const char* NumberParser::parseDigits(const char* str, uint32_t limit, uint32_t* value)
+{
+	if ((str == NULL) || (*str < '0') || (*str > '9')) return NULL;
+
+	uint32_t result = 0;
+	for (; (*str >= '0') && (*str <= '9'); str++)
+	{
+		uint8_t digit = *str - '0';
+		if (result > (limit - digit) / 10) return NULL;
+		result = (result * 10) + digit;
+	}
+
+	*value = result;
+	return str;
+}
+
+bool NumberParser::parseInt(const char* str, int32_t* value)
+{
+	if (str == NULL) return false;
+
+	bool negative = (*str == '-');
+	if (negative || (*str == '+')) str++;
+
+	uint32_t magnitude;
+	str = parseDigits(str, negative ? 0x80000000UL : 0x7FFFFFFFUL, &magnitude);
+	if ((str == NULL) || !isEnd(*str)) return false;
+
+	*value = negative ? (int32_t)(0 - magnitude) : (int32_t)magnitude;
+	return true;
+}
+
+bool NumberParser::parseUInt(const char* str, uint32_t* value)
+{
+	uint32_t result;
+	str = parseDigits(str, 0xFFFFFFFFUL, &result);
+	if ((str == NULL) || !isEnd(*str)) return false;
+
+	*value = result;
+	return true;
+}
+
+bool NumberParser::parseUInt64(const char* str, uint64_t* value)
+{
+	if ((str == NULL) || (*str < '0') || (*str > '9')) return false;
+
+	// 64 bits arithmetic is emulated on the target, so it is only used for the digits
+	// which do not fit anymore in 32 bits
+	uint32_t low;
+	const char* p = parseDigits(str, 0xFFFFFFFFUL, &low);
+	if ((p != NULL) && isEnd(*p))
+	{
+		*value = low;
+		return true;
+	}
+
+	uint64_t result = 0;
+	for (p = str; (*p >= '0') && (*p <= '9'); p++)
+	{
+		uint8_t digit = *p - '0';
+		if (result > (0xFFFFFFFFFFFFFFFFULL - digit) / 10) return false;
+		result = (result * 10) + digit;
+	}
+	if (!isEnd(*p)) return false;
+
+	*value = result;
+	return true;
+}
+
+bool NumberParser::parseHex(const char* str, uint32_t* value)
+{
+	if ((str == NULL) || isEnd(*str)) return false;
+
+	uint32_t result = 0;
+	uint8_t count = 0;
+	for (; !isEnd(*str); str++)
+	{
+		int8_t digit = HexCodec::digitValue(*str);
+		if ((digit == HEX_ERROR) || (++count > MAX_HEX_DIGITS)) return false;
+		result = (result << 4) | (uint8_t)digit;
+	}
+
+	*value = result;
+	return true;
+}
+
+bool NumberParser::parseFixed(const char* str, uint8_t decimals, int32_t* value)
+{
+	if (str == NULL) return false;
+
+	bool negative = (*str == '-');
+	if (negative || (*str == '+')) str++;
+
+	uint32_t limit = negative ? 0x80000000UL : 0x7FFFFFFFUL;
+	uint32_t result;
+	str = parseDigits(str, limit, &result);
+	if (str == NULL) return false;
+
+	bool fraction = (*str == '.');
+	if (fraction) str++;
+
+	for (uint8_t i = 0; i < decimals; i++)
+	{
+		uint8_t digit = 0;
+		if (fraction && (*str >= '0') && (*str <= '9')) digit = *str++ - '0';
+		if (result > (limit - digit) / 10) return false;
+		result = (result * 10) + digit;
+	}
+
+	// truncated digits
+	if (fraction) while ((*str >= '0') && (*str <= '9')) str++;
+	if (!isEnd(*str)) return false;
+
+	*value = negative ? (int32_t)(0 - result) : (int32_t)result;
+	return true;
+}
@@ -0,0 +1,85 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			NumberParser.h
+* @brief		Parsing of the numeric values answered by the module
+* @details		This class gathers the conversions of the decimal, hexadecimal and fixed-point answers
+*				of the module into integers. They work in place on the response buffer, never allocate,
+*				and report empty values, invalid characters and overflows instead of returning a
+*				truncated number. A value ends at the end of the string or at the first space, so the
+*				first field of a multi-valued answer such as "mac get rx2" can be parsed directly.
+*/
+
+#ifndef _NUMBER_PARSER_H
+#define _NUMBER_PARSER_H
+
+#include <Arduino.h>
+
+class NumberParser
+{
+public:
+	/**
+	* @brief		Parsing a signed decimal number
+	* @param		str			Characters to parse, with an optional leading sign
+	* @param		value		Variable receiving the number, left unchanged on error
+	* @return		Boolean value, false if the value is empty, contains a non decimal character or
+	*				does not fit in 32 bits
+	*/
+	static bool parseInt(const char* str, int32_t* value);
+
+	/**
+	* @brief		Parsing an unsigned decimal number
+	* @param		str			Characters to parse
+	* @param		value		Variable receiving the number, left unchanged on error
+	* @return		Boolean value, false if the value is empty, contains a non decimal character or
+	*				does not fit in 32 bits
+	*/
+	static bool parseUInt(const char* str, uint32_t* value);
+
+	/**
+	* @brief		Parsing an unsigned decimal number on 64 bits
+	* @param		str			Characters to parse
+	* @param		value		Variable receiving the number, left unchanged on error
+	* @return		Boolean value, false if the value is empty, contains a non decimal character or
+	*				does not fit in 64 bits
+	*/
+	static bool parseUInt64(const char* str, uint64_t* value);
+
+	/**
+	* @brief		Parsing an hexadecimal number
+	* @param		str			Characters to parse, upper or lower case, without prefix
+	* @param		value		Variable receiving the number, left unchanged on error
+	* @return		Boolean value, false if the value is empty, contains a non hexadecimal character or
+	*				is longer than 8 digits
+	*/
+	static bool parseHex(const char* str, uint32_t* value);
+
+	/**
+	* @brief		Parsing a decimal number with a fractional part as a fixed-point integer
+	* @details		"41.7" parsed with 1 decimal gives 417, "125" gives 1250. Extra fractional
+	*				digits are truncated.
+	* @param		str			Characters to parse, with an optional leading sign
+	* @param		decimals	Number of fractional digits kept in the result
+	* @param		value		Variable receiving the scaled number, left unchanged on error
+	* @return		Boolean value, false if the value is empty, contains an invalid character or
+	*				does not fit in 32 bits once scaled
+	*/
+	static bool parseFixed(const char* str, uint8_t decimals, int32_t* value);
+
+protected:
+	static const char* parseDigits(const char* str, uint32_t limit, uint32_t* value);
+	static bool isEnd(char c);
+};
+
+#endif
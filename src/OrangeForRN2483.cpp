@@ -21,22 +21,32 @@
 
 #include "OrangeForRN2483.h"
 #include "RTCZero.h"
+#include "HexCodec.h"
+#include "NumberParser.h"
+#include "RegionTable.h"
 
 OrangeForRN2483Class OrangeForRN2483;
 OrangeForRN2483Class* OrangeForRN2483Class::refOrangeForRN2483 = NULL;
 
-RTCZero rtc;
+// one RTC on the board, shared by all the instances
+static RTCZero rtc;
 
 void alarmMatch()
 {
 	OrangeForRN2483Class::refOrangeForRN2483->onAlarmInterrupt();
 }
 
-OrangeForRN2483Class::OrangeForRN2483Class()
+OrangeForRN2483Class::OrangeForRN2483Class(RnRequestClass* request) : request(request), RadioCmds(request), SysCmds(request)
 {
 	exitSleepMode = false;
 	deepSleeping = false;
-	OrangeForRN2483Class::refOrangeForRN2483 = this;
+	isNetworkJoined = false;
+	region = REGION_EU868;
+	fragmentedMessages = 0;
+	batchCount = 0;
+	dutyCycleEnforced = true;
+	for (int i = 0; i < MAX_DOWNLINK_HANDLERS; i++) downlinkBindings[i].handler = NULL;
+	memset(&downlinkStats, 0, sizeof(sDownlinkStats));
 }
 
 OrangeForRN2483Class::~OrangeForRN2483Class()
@@ -45,10 +55,137 @@ OrangeForRN2483Class::~OrangeForRN2483Class()
 
 void OrangeForRN2483Class::init()
 {
-	RnRequest.init();
+	this->request->init();
+	registerHandlers();
+	resetDevice();
+}
+
+void OrangeForRN2483Class::init(RnTransport* transport)
+{
+	this->request->init(transport);
+	registerHandlers();
 	resetDevice();
 }
 
+void OrangeForRN2483Class::registerHandlers()
+{
+	// init() may be called again, a handler registered twice would queue every downlink twice
+	this->request->removeEventHandler(onModuleEvent);
+	this->request->addEventHandler(onModuleEvent, this);
+	this->request->setDownlinkSink(&this->downlinkMessage);
+}
+
+void OrangeForRN2483Class::poll()
+{
+	this->request->poll();
+	dispatchDownlinks();
+}
+
+bool OrangeForRN2483Class::onDownlink(uint8_t port, downlinkHandler handler, void* context)
+{
+	return onDownlink(port, port, handler, context);
+}
+
+bool OrangeForRN2483Class::onDownlink(uint8_t firstPort, uint8_t lastPort, downlinkHandler handler, void* context)
+{
+	if ((handler == NULL) || (firstPort > lastPort)) return false;
+
+	for (int i = 0; i < MAX_DOWNLINK_HANDLERS; i++)
+	{
+		if (this->downlinkBindings[i].handler == NULL)
+		{
+			this->downlinkBindings[i].firstPort = firstPort;
+			this->downlinkBindings[i].lastPort = lastPort;
+			this->downlinkBindings[i].context = context;
+			this->downlinkBindings[i].handler = handler;
+			return true;
+		}
+	}
+	return false;
+}
+
+void OrangeForRN2483Class::removeDownlinkHandler(downlinkHandler handler)
+{
+	for (int i = 0; i < MAX_DOWNLINK_HANDLERS; i++)
+	{
+		if (this->downlinkBindings[i].handler == handler) this->downlinkBindings[i].handler = NULL;
+	}
+}
+
+bool OrangeForRN2483Class::hasDownlinkHandler()
+{
+	for (int i = 0; i < MAX_DOWNLINK_HANDLERS; i++)
+	{
+		if (this->downlinkBindings[i].handler != NULL) return true;
+	}
+	return false;
+}
+
+void OrangeForRN2483Class::queueDownlink()
+{
+	// without handler, the application reads getDownlinkMessage() itself
+	if (!hasDownlinkHandler()) return;
+
+	uint16_t len = 0;
+	const uint8_t* payload = this->downlinkMessage.getPayload(&len);
+	if (!this->downlinkQueue.push(this->downlinkMessage.getPort(), payload, len))
+	{
+		this->downlinkStats.overflows++;
+		return;
+	}
+
+	this->downlinkStats.queued++;
+	if (this->downlinkQueue.getCount() > this->downlinkStats.maxDepth) this->downlinkStats.maxDepth = this->downlinkQueue.getCount();
+}
+
+uint8_t OrangeForRN2483Class::dispatchDownlinks()
+{
+	// only the downlinks queued before the call, a handler may queue new ones
+	uint8_t pending = this->downlinkQueue.getCount();
+	for (uint8_t n = 0; n < pending; n++)
+	{
+		const uint8_t* payload = NULL;
+		const sQueuedDownlink* downlink = this->downlinkQueue.peek(&payload);
+
+		bool handled = false;
+		for (int i = 0; (i < MAX_DOWNLINK_HANDLERS) && !handled; i++)
+		{
+			sDownlinkBinding* binding = &this->downlinkBindings[i];
+			if ((binding->handler == NULL) || (downlink->port < binding->firstPort) || (downlink->port > binding->lastPort)) continue;
+
+			binding->handler(downlink->port, payload, downlink->length, binding->context);
+			handled = true;
+		}
+
+		if (handled) this->downlinkStats.dispatched++;
+		else this->downlinkStats.unhandled++;
+		this->downlinkQueue.pop();
+	}
+	return pending;
+}
+
+void OrangeForRN2483Class::getDownlinkStats(sDownlinkStats* stats)
+{
+	memcpy(stats, &this->downlinkStats, sizeof(sDownlinkStats));
+}
+
+void OrangeForRN2483Class::onModuleEvent(eResponseToken token, uint8_t* line, void* context)
+{
+	OrangeForRN2483Class* orange = (OrangeForRN2483Class*)context;
+
+	if (token == RESP_MAC_RX)
+	{
+		// downlink received after the uplink command was over
+		orange->downlinkMessage.setResponseMessage(line);
+		orange->queueDownlink();
+	}
+	else if (token == RESP_RESET_BANNER)
+	{
+		// the module restarted (brownout...), the session is lost
+		orange->isNetworkJoined = false;
+	}
+}
+
 void OrangeForRN2483Class::onAlarmInterrupt()
 {
 	deepSleeping = false;
@@ -63,14 +200,30 @@ SysCmdsClass* OrangeForRN2483Class::getSysCmds() {
 	return &SysCmds;
 }
 
+RnRequestClass* OrangeForRN2483Class::getRequest()
+{
+	return this->request;
+}
+
+void OrangeForRN2483Class::enableCache(bool enable)
+{
+	this->request->enableCache(enable);
+}
+
+OrangeForRN2483Class& OrangeForRN2483Class::refresh()
+{
+	this->request->bypassCache();
+	return *this;
+}
+
 eErrorType OrangeForRN2483Class::getLastError()
 {
-	RnRequest.getLastError();
+	return this->request->getLastError();
 }
 
 void OrangeForRN2483Class::setLastError(eErrorType errorType)
 {
-	RnRequest.setLastError(errorType);
+	this->request->setLastError(errorType);
 }
 
 bool OrangeForRN2483Class::getJoinState()
@@ -80,19 +233,217 @@ bool OrangeForRN2483Class::getJoinState()
 
 bool OrangeForRN2483Class::isStreamInit()
 {
-	return RnRequest.isStreamInit();
+	return this->request->isStreamInit();
 }
 
 bool OrangeForRN2483Class::setAbpKeys(const uint8_t* nwkSkey, const uint8_t* appSKey)
 {
-	getSysCmds()->wakeUp();
-	return (setNwkSKey(nwkSkey) && setAppSKey(appSKey));
+	beginBatch();
+	addToBatch(NWKS_KEY, nwkSkey, 16);
+	addToBatch(APPS_KEY, appSKey, 16);
+	return (commitBatch() == 0);
 }
 
 bool OrangeForRN2483Class::setOttaKeys(const uint8_t* devEui, const uint8_t* appEui, const uint8_t* appKey)
+{
+	beginBatch();
+	addToBatch(DEVEUI, devEui, 8);
+	addToBatch(APPEUI, appEui, 8);
+	addToBatch(APP_KEY, appKey, 16);
+	return (commitBatch() == 0);
+}
+
+void OrangeForRN2483Class::beginBatch()
+{
+	batchCount = 0;
+}
+
+bool OrangeForRN2483Class::addToBatch(eParamMac param, const char* value)
+{
+	if ((batchCount >= MAX_BATCH_COMMANDS) || (value == NULL) || (strlen(value) >= MAX_BATCH_VALUE_SIZE)) return false;
+
+	sMacSetCommand* command = &batch[batchCount++];
+	command->param = param;
+	strcpy(command->value, value);
+	command->result = LORA_SUCCESS;
+	return true;
+}
+
+bool OrangeForRN2483Class::addToBatch(eParamMac param, const uint8_t* value, uint8_t len)
+{
+	if ((batchCount >= MAX_BATCH_COMMANDS) || (value == NULL) || ((len * 2) >= MAX_BATCH_VALUE_SIZE)) return false;
+
+	sMacSetCommand* command = &batch[batchCount++];
+	command->param = param;
+	command->value[HexCodec::encode(value, len, command->value)] = '\0';
+	command->result = LORA_SUCCESS;
+	return true;
+}
+
+void OrangeForRN2483Class::onBatchResponse(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context)
+{
+	((sMacSetCommand*)context)->result = errorType;
+}
+
+uint8_t OrangeForRN2483Class::commitBatch(uint8_t window)
 {
 	getSysCmds()->wakeUp();
-	return (setDevEUI(devEui) && setAppEUI(appEui) && setAppKey(appKey));
+
+	while (this->request->isBusy()) this->request->poll();
+	this->request->setPipelineDepth(window);
+
+	uint8_t next = 0;
+	while ((next < batchCount) || this->request->isBusy())
+	{
+		if (next < batchCount)
+		{
+			sMacSetCommand* command = &batch[next];
+			if (this->request->submit(MAC, SET, CommandTable::name(command->param), command->value, onBatchResponse, command) != RN_INVALID_HANDLE) next++;
+			else if (this->request->getLastError() != LORA_BUSY)
+			{
+				// not sent at all, the module is sleeping
+				command->result = this->request->getLastError();
+				next++;
+			}
+		}
+		this->request->poll();
+	}
+	this->request->setPipelineDepth(1);
+
+	uint8_t failed = 0;
+	for (uint8_t i = 0; i < batchCount; i++)
+	{
+		if (batch[i].result != LORA_SUCCESS) failed++;
+	}
+	return failed;
+}
+
+eErrorType OrangeForRN2483Class::getBatchResult(uint8_t index)
+{
+	return (index < batchCount) ? batch[index].result : LORA_INVALID_PARAM;
+}
+
+// fields of sDeviceProfile, in the order of their values in applyProfile()
+typedef struct _sProfileParam {
+	uint8_t param;							// eParamMac value
+	bool readable;							// read back with "mac get"
+	bool persisted;							// kept by "mac save"
+}sProfileParam;
+
+#define PROFILE_PARAMS	9
+
+static const sProfileParam profileParams[PROFILE_PARAMS] PROGMEM = {
+	{ DATARATE, true, false },
+	{ ADR, true, false },
+	{ RETRANS_NB, true, false },
+	{ PWR_IND_VAL, true, false },
+	{ RX_DELAY_1, true, false },
+	{ RX2, true, true },
+	{ SYNC, true, false },
+	{ LINK_CHECK, false, false },
+	{ BAT_LVL, false, false }
+};
+
+void OrangeForRN2483Class::onProfileResponse(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context)
+{
+	if ((errorType != LORA_SUCCESS) || (response == NULL) || (strlen((char*)response) >= CACHE_VALUE_SIZE)) return;
+	strcpy((char*)context, (char*)response);
+}
+
+void OrangeForRN2483Class::readProfileState(uint8_t window, char known[][CACHE_VALUE_SIZE])
+{
+	while (this->request->isBusy()) this->request->poll();
+	this->request->setPipelineDepth(window);
+
+	// the cached values are taken as they are, the other readable ones are read with pipelined "mac get"
+	uint8_t next = 0;
+	while ((next < PROFILE_PARAMS) || this->request->isBusy())
+	{
+		if (next < PROFILE_PARAMS)
+		{
+			uint8_t param = pgm_read_byte(&profileParams[next].param);
+			const char* name = CommandTable::name((eParamMac)param);
+			const char* cached = this->request->cacheEnabled ? this->request->cache.get(MAC, name) : NULL;
+
+			known[next][0] = '\0';
+			if (cached != NULL) strcpy(known[next], cached);
+
+			if (!pgm_read_byte(&profileParams[next].readable) || (cached != NULL)) next++;
+			else
+			{
+				// the response of a plain "get" is also cached by the command engine
+				RnHandle handle = this->request->submit(MAC, GET, name, (param == RX2) ? "868" : NULL, onProfileResponse, known[next]);
+				if ((handle != RN_INVALID_HANDLE) || (this->request->getLastError() != LORA_BUSY)) next++;
+			}
+		}
+		this->request->poll();
+	}
+	this->request->setPipelineDepth(1);
+
+	// "mac get rx2 868" carries the band, the cache only knows the value of the 868 MHz band
+	for (uint8_t i = 0; i < PROFILE_PARAMS; i++)
+	{
+		if ((pgm_read_byte(&profileParams[i].param) != RX2) || !this->request->cacheEnabled || (known[i][0] == '\0')) continue;
+		this->request->cache.store(ParamCache::find(MAC, CommandTable::name(RX2)), known[i], strlen(known[i]));
+	}
+}
+
+bool OrangeForRN2483Class::applyProfile(const sDeviceProfile& profile, uint8_t window)
+{
+	getSysCmds()->wakeUp();
+
+	char known[PROFILE_PARAMS][CACHE_VALUE_SIZE];
+	readProfileState(window, known);
+
+	char values[PROFILE_PARAMS][CACHE_VALUE_SIZE];
+	snprintf(values[0], CACHE_VALUE_SIZE, "%u", (unsigned int)profile.dataRate);
+	strcpy(values[1], profile.adr ? STR_ON : STR_OFF);
+	snprintf(values[2], CACHE_VALUE_SIZE, "%u", profile.retx);
+	snprintf(values[3], CACHE_VALUE_SIZE, "%u", profile.pwrIdx);
+	snprintf(values[4], CACHE_VALUE_SIZE, "%u", profile.rxDelay1);
+	snprintf(values[5], CACHE_VALUE_SIZE, "%u %lu", (unsigned int)profile.rx2DataRate, (unsigned long)profile.rx2Frequency);
+	snprintf(values[6], CACHE_VALUE_SIZE, "%02X", profile.syncWord);
+	snprintf(values[7], CACHE_VALUE_SIZE, "%u", profile.linkCheck);
+	snprintf(values[8], CACHE_VALUE_SIZE, "%u", profile.batteryLevel);
+
+	beginBatch();
+	for (uint8_t i = 0; i < PROFILE_PARAMS; i++)
+	{
+		eParamMac param = (eParamMac)pgm_read_byte(&profileParams[i].param);
+
+		// the module answers hexadecimal values in either case
+		if ((known[i][0] == '\0') || (strcasecmp(known[i], values[i]) != 0)) addToBatch(param, values[i]);
+	}
+	if (batchCount == 0) return true;
+
+	uint8_t failed = commitBatch(window);
+
+	bool persistedChange = false;
+	for (uint8_t i = 0; i < batchCount; i++)
+	{
+		if (batch[i].result != LORA_SUCCESS) continue;
+
+		switch (batch[i].param)
+		{
+			case DATARATE:
+				this->request->linkTiming.dataRate = profile.dataRate;
+				this->request->linkTiming.dataRateKnown = true;
+				break;
+			case ADR: this->request->linkTiming.adr = profile.adr; break;
+			case RETRANS_NB: this->request->linkTiming.retx = profile.retx; break;
+			case RX_DELAY_1: this->request->linkTiming.rxDelay1 = profile.rxDelay1; break;
+			case RX2: this->request->linkTiming.rx2DataRate = profile.rx2DataRate; break;
+			default: break;
+		}
+
+		for (uint8_t j = 0; j < PROFILE_PARAMS; j++)
+		{
+			if ((pgm_read_byte(&profileParams[j].param) == batch[i].param) && pgm_read_byte(&profileParams[j].persisted)) persistedChange = true;
+		}
+	}
+
+	if (persistedChange && !save()) return false;
+	return (failed == 0);
 }
 
 void OrangeForRN2483Class::resetDevice()
@@ -102,7 +453,8 @@ void OrangeForRN2483Class::resetDevice()
 	delay(10);
 	digitalWrite(LORA_RESET, HIGH);
 	delay(200);
-	RnRequest.getResponse();
+	this->request->getResponse();
+	this->request->invalidateCache();
 }
 
 bool OrangeForRN2483Class::joinNetwork(const uint8_t* appEui, const uint8_t* appKey)
@@ -110,21 +462,15 @@ bool OrangeForRN2483Class::joinNetwork(const uint8_t* appEui, const uint8_t* app
 	getSysCmds()->wakeUp();
 
 	String hwDevEuiString = SysCmds.getHardwareDevEUI();
-	const char* hwDevEuiBuffer = hwDevEuiString.c_str();
 
-	char hwDevEui[8];
-	
-	for (int i = 0; i < 8; i++)
-	{
-		char highNibbleStr = hwDevEuiBuffer[i * 2];
-		char lowNibbleStr = hwDevEuiBuffer[(i * 2) + 1];
+	uint8_t hwDevEui[8];
 
-		hwDevEui[i] = HEX_CHAR_TO_HIGH_NIBBLE(highNibbleStr) + HEX_CHAR_TO_LOW_NIBBLE(lowNibbleStr);
-		
-		loraDebugInt((int)hwDevEui[i]); loraDebugPrint(" ");
+	if ((hwDevEuiString.length() != 16) || (HexCodec::decode(hwDevEuiString.c_str(), 16, hwDevEui) != 8))
+	{
+		setLastError(LORA_INVALID_PARAM);
+		return false;
 	}
-	loraDebugPrintLn("");
-	return joinNetwork((const uint8_t*)hwDevEui, appEui, appKey);
+	return joinNetwork(hwDevEui, appEui, appKey);
 }
 
 bool OrangeForRN2483Class::joinNetwork(const uint8_t* devEui, const uint8_t* appEui, const uint8_t* appKey)
@@ -141,11 +487,21 @@ bool OrangeForRN2483Class::sendMessage(eTypeMessage typeMessage, uint8_t* data,
 	getSysCmds()->wakeUp();
 	if (isStreamInit()) {
 		if (getJoinState()) {
+			// the module would only refuse it after a whole exchange, it is left to check it when the data rate is unknown
+			eDataRate dataRate = getCurrentDataRate();
+			if ((dataRate != DATA_RATE_ERROR) && (size > RegionTable::maxPayloadSize(this->region, dataRate)))
+			{
+				setLastError(LORA_INVALID_DATA_LEN);
+				return false;
+			}
+
 			SerialUSB.println("Sending message...");
 			uint8_t* response = tx(typeMessage, data, size, port);
 
-			eSuccessType successType = RnRequest.getLastSuccess();
-			downlinkMessage.setResponseMessage((successType == LORA_RX) ? response : NULL);
+			// the last success type is the one of a previous command when tx() returned before sending
+			bool received = (response != NULL) && (this->request->getLastSuccess() == LORA_RX);
+			downlinkMessage.setResponseMessage(received ? response : NULL);
+			if (received) queueDownlink();
 			return (response != NULL);
 		}
 		else
@@ -158,6 +514,67 @@ bool OrangeForRN2483Class::sendMessage(eTypeMessage typeMessage, uint8_t* data,
 	return false;
 }
 
+bool OrangeForRN2483Class::sendFragmented(eTypeMessage typeMessage, const uint8_t* data, uint16_t size, uint8_t port)
+{
+	// nothing is sent when the message cannot fit at the current data rate
+	uint8_t maxPayloadSize = getMaxPayloadSize();
+	if ((maxPayloadSize <= FRAGMENT_HEADER_SIZE) || (size > MAX_FRAGMENTS * (uint16_t)(maxPayloadSize - FRAGMENT_HEADER_SIZE)))
+	{
+		setLastError(LORA_INVALID_DATA_LEN);
+		return false;
+	}
+
+	uint8_t frame[FRAGMENT_HEADER_SIZE + UPLINK_FRAME_SIZE];
+	uint8_t number = this->fragmentedMessages++;
+	uint16_t offset = 0;
+
+	for (uint8_t index = 0; index < MAX_FRAGMENTS; index++)
+	{
+		// the data rate may change between two fragments with ADR
+		if (index > 0) maxPayloadSize = getMaxPayloadSize();
+		if (maxPayloadSize <= FRAGMENT_HEADER_SIZE)
+		{
+			setLastError(LORA_INVALID_DATA_LEN);
+			return false;
+		}
+
+		uint16_t len = size - offset;
+		if (len > maxPayloadSize - FRAGMENT_HEADER_SIZE) len = maxPayloadSize - FRAGMENT_HEADER_SIZE;
+
+		frame[0] = number;
+		frame[1] = index | ((offset + len == size) ? FRAGMENT_LAST : 0);
+		memcpy(&frame[FRAGMENT_HEADER_SIZE], &data[offset], len);
+
+		// the fragments follow each other as fast as the duty cycle allows
+		delay(nextTxOpportunity());
+		if (!sendMessage(typeMessage, frame, len + FRAGMENT_HEADER_SIZE, port)) return false;
+
+		offset += len;
+		if (offset == size) return true;
+	}
+
+	// a data rate lowered by ADR left less room than checked at the start
+	setLastError(LORA_INVALID_DATA_LEN);
+	return false;
+}
+
+void OrangeForRN2483Class::setRegion(eRegion region)
+{
+	this->region = region;
+}
+
+eRegion OrangeForRN2483Class::getRegion()
+{
+	return this->region;
+}
+
+uint8_t OrangeForRN2483Class::getMaxPayloadSize()
+{
+	// the slowest data rate has the smallest payload
+	eDataRate dataRate = getCurrentDataRate();
+	return RegionTable::maxPayloadSize(this->region, (dataRate == DATA_RATE_ERROR) ? DATA_RATE_0 : dataRate);
+}
+
 DownlinkMessage* OrangeForRN2483Class::getDownlinkMessage()
 {
 	return &downlinkMessage;
@@ -172,20 +589,20 @@ bool OrangeForRN2483Class::sendMessage(uint8_t* data, uint8_t size, uint8_t port
 String OrangeForRN2483Class::getDevAddr()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[DEVADDR]);
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(DEVADDR));
 	return String((response == NULL) ? "" : (char*)response);
 }
 
 bool OrangeForRN2483Class::setDevAddr(const uint8_t* devAddr)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[DEVADDR], devAddr, 4) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(DEVADDR), devAddr, 4) != NULL);
 }
 
 String OrangeForRN2483Class::getDevEUI()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[DEVEUI]);
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(DEVEUI));
 	if (response == NULL) return String("");
 	return String((char*)response);
 }
@@ -193,7 +610,7 @@ String OrangeForRN2483Class::getDevEUI()
 String OrangeForRN2483Class::getAppEUI()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[APPEUI]);
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(APPEUI));
 	if (response == NULL) return String("");
 	return String((char*)response);
 }
@@ -201,53 +618,77 @@ String OrangeForRN2483Class::getAppEUI()
 bool OrangeForRN2483Class::setNwkSKey(const uint8_t* nwkSKey)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[NWKS_KEY], nwkSKey, 16) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(NWKS_KEY), nwkSKey, 16) != NULL);
 }
 
 eBoolean OrangeForRN2483Class::isAdr()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[ADR]);
-	return (response != NULL) ? iS_ON(String((char*)response)) : BOOL_ERROR;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(ADR));
+	if (response == NULL) return BOOL_ERROR;
+
+	eBoolean adr = iS_ON(response);
+	this->request->linkTiming.adr = (adr == BOOL_TRUE);
+	return adr;
 }
 
 bool OrangeForRN2483Class::enableAdr(bool adr)
 {
 	getSysCmds()->wakeUp();
-	String adrStr = adr ? STR_ON : STR_OFF;
-	return (RnRequest.rnRequest(MAC, SET, params[ADR], adrStr.c_str()) != NULL);
+	if (this->request->rnRequest(MAC, SET, CommandTable::name(ADR), adr ? STR_ON : STR_OFF) == NULL) return false;
+
+	this->request->linkTiming.adr = adr;
+	return true;
 }
 
 bool OrangeForRN2483Class::getStatus(uint32_t& status)
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[STATUS]);
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(STATUS));
 
 	if (response == NULL) return false;
-	status = (uint32_t)String((char*)response).toInt();
-	return true;
+	// hexadecimal bit field
+	return NumberParser::parseHex((char*)response, &status);
 }
 
 short OrangeForRN2483Class::getSync()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[SYNC]);
-	if (response == NULL) return INT_ERROR_FAILED;
-	return String((char*)response).toInt();
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(SYNC));
+	uint32_t sync;
+	return ((response != NULL) && NumberParser::parseHex((char*)response, &sync)) ? (short)sync : INT_ERROR_FAILED;
 }
 
 String OrangeForRN2483Class::getAutoReply()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[AUTO_REPLY]);
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(AUTO_REPLY));
 	return String((response == NULL) ? "" : (char*)response);
 }
 
 eDataRate OrangeForRN2483Class::getDataRate()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[DATARATE]);
-	return (response != NULL) ? (eDataRate)String((char*)response).toInt() : DATA_RATE_ERROR;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(DATARATE));
+	if (response == NULL) return DATA_RATE_ERROR;
+
+	uint32_t value;
+	if (!NumberParser::parseUInt((char*)response, &value)) return DATA_RATE_ERROR;
+
+	eDataRate dataRate = (eDataRate)value;
+	if ((dataRate >= DATA_RATE_0) && (dataRate < COUNT_DATA_RATE))
+	{
+		this->request->linkTiming.dataRate = dataRate;
+		this->request->linkTiming.dataRateKnown = true;
+	}
+	return dataRate;
+}
+
+eDataRate OrangeForRN2483Class::getCurrentDataRate()
+{
+	// read again after each uplink while ADR is on, known from the last setter or getter otherwise
+	if (!this->request->linkTiming.dataRateKnown) getDataRate();
+	return this->request->linkTiming.dataRateKnown ? this->request->linkTiming.dataRate : DATA_RATE_ERROR;
 }
 
 bool OrangeForRN2483Class::setDataRate(eDataRate dataRate)
@@ -255,201 +696,333 @@ bool OrangeForRN2483Class::setDataRate(eDataRate dataRate)
 	getSysCmds()->wakeUp();
 	if (dataRate < 0 || dataRate > COUNT_DATA_RATE - 1) return false;
 
-	return (RnRequest.rnRequest(MAC, SET, params[DATARATE], String(dataRate).c_str()) != NULL);
+	if (this->request->rnRequest(MAC, SET, CommandTable::name(DATARATE), String(dataRate).c_str()) == NULL) return false;
+
+	this->request->linkTiming.dataRate = dataRate;
+	this->request->linkTiming.dataRateKnown = true;
+	return true;
 }
 
 ePowerIdx OrangeForRN2483Class::getPwrIdxValue()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[PWR_IND_VAL]);
-	return (response != NULL) ? (ePowerIdx)String((char*)response).toInt() : POWER_ERROR;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(PWR_IND_VAL));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? (ePowerIdx)value : POWER_ERROR;
 }
 
 uint16_t OrangeForRN2483Class::getBand()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[BAND]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(BAND));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint16_t OrangeForRN2483Class::getRetransNb()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[RETRANS_NB]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(RETRANS_NB));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint16_t OrangeForRN2483Class::getDemodMargin()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[DEMOD_MARGIN]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(DEMOD_MARGIN));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint16_t OrangeForRN2483Class::getGatewayNb()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[GATEWAY_NB]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(GATEWAY_NB));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint16_t OrangeForRN2483Class::getRx2(uint16_t freqBand)
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[RX2], String(freqBand).c_str());
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(RX2), String(freqBand).c_str());
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint32_t OrangeForRN2483Class::getRxdelay1()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[RX_DELAY_1]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(RX_DELAY_1));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint32_t OrangeForRN2483Class::getRxdelay2()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[RX_DELAY_2]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(RX_DELAY_2));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint32_t OrangeForRN2483Class::getDCyclePs()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[D_CYCLE_PS]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(D_CYCLE_PS));
+	uint32_t value;
+	return ((response != NULL) && NumberParser::parseUInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 uint64_t OrangeForRN2483Class::getUpctr()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[UP_CTR]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(UP_CTR));
+	uint64_t value;
+	return ((response != NULL) && NumberParser::parseUInt64((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 bool OrangeForRN2483Class::setUpctr(uint32_t upctr)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[UP_CTR], String(upctr).c_str()) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(UP_CTR), String(upctr).c_str()) != NULL);
 }
 
 uint64_t OrangeForRN2483Class::getDwnctr()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, GET, params[DWN_CTR]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(DWN_CTR));
+	uint64_t value;
+	return ((response != NULL) && NumberParser::parseUInt64((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 bool OrangeForRN2483Class::setDwnctr(uint32_t dwnctr)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[DWN_CTR], String(dwnctr).c_str()) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(DWN_CTR), String(dwnctr).c_str()) != NULL);
 }
 
 bool OrangeForRN2483Class::setDevEUI(const uint8_t* devEUI)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[DEVEUI], devEUI, 8) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(DEVEUI), devEUI, 8) != NULL);
 }
 
 bool OrangeForRN2483Class::setAppEUI(const uint8_t* appEUI)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[APPEUI], appEUI, 8) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(APPEUI), appEUI, 8) != NULL);
 }
 
 bool OrangeForRN2483Class::setAppSKey(const uint8_t* appSKey)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[APPS_KEY], appSKey, 16) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(APPS_KEY), appSKey, 16) != NULL);
 }
 
 bool OrangeForRN2483Class::setAppKey(const uint8_t* appKey)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[APP_KEY], appKey, 16) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(APP_KEY), appKey, 16) != NULL);
 }
 
 bool OrangeForRN2483Class::setPwrIdx(uint8_t pwrIdx)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[PWR_IND_VAL], String(pwrIdx).c_str()) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(PWR_IND_VAL), String(pwrIdx).c_str()) != NULL);
 }
 
 bool OrangeForRN2483Class::setBatLvl(uint8_t lvl)
 {
-	return (RnRequest.rnRequest(MAC, SET, params[BAT_LVL], String(lvl).c_str()) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(BAT_LVL), String(lvl).c_str()) != NULL);
 }
 
 bool OrangeForRN2483Class::setRetx(uint8_t retx)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[RETRANS_NB], String(retx).c_str()) != NULL);
+	if (this->request->rnRequest(MAC, SET, CommandTable::name(RETRANS_NB), String(retx).c_str()) == NULL) return false;
+
+	this->request->linkTiming.retx = retx;
+	return true;
 }
 
 bool OrangeForRN2483Class::setLinkCheck(uint16_t linkCheck)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[LINK_CHECK], String(linkCheck).c_str()) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(LINK_CHECK), String(linkCheck).c_str()) != NULL);
 }
 
 bool OrangeForRN2483Class::setRxDelay1(uint16_t rxDelay1)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[RX_DELAY_1], String(rxDelay1).c_str()) != NULL);
+	if (this->request->rnRequest(MAC, SET, CommandTable::name(RX_DELAY_1), String(rxDelay1).c_str()) == NULL) return false;
+
+	this->request->linkTiming.rxDelay1 = rxDelay1;
+	return true;
 }
 
 bool OrangeForRN2483Class::setAutoReply(String autoRep)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[AUTO_REPLY], autoRep.c_str()) != NULL);
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(AUTO_REPLY), autoRep.c_str()) != NULL);
 }
 
 bool OrangeForRN2483Class::setRx2(eDataRate dataRate, uint32_t frequency)
 {
 	getSysCmds()->wakeUp();
 	String rx2Param = String(dataRate) + SEPARATOR + String(frequency);
-	return (RnRequest.rnRequest(MAC, SET, params[RX2], rx2Param.c_str()) != NULL);
+	if (this->request->rnRequest(MAC, SET, CommandTable::name(RX2), rx2Param.c_str()) == NULL) return false;
+
+	if ((dataRate >= DATA_RATE_0) && (dataRate < COUNT_DATA_RATE)) this->request->linkTiming.rx2DataRate = dataRate;
+	return true;
 }
 
 bool OrangeForRN2483Class::setSync(int8_t syncWord)
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, SET, params[SYNC], String(syncWord).c_str()) != NULL);
+	// the module expects an hexadecimal byte
+	char hex[3];
+	HexCodec::encode((uint8_t*)&syncWord, 1, hex);
+	hex[2] = 0;
+	return (this->request->rnRequest(MAC, SET, CommandTable::name(SYNC), hex) != NULL);
 }
 
 bool OrangeForRN2483Class::join()
 {
 	getSysCmds()->wakeUp();
-	uint8_t* response = RnRequest.rnRequest(MAC, params[JOIN], STR_OTAA);
-	if (response == NULL) return false;
+	if (this->dutyCycleEnforced && (nextTxOpportunity() > 0))
+	{
+		setLastError(LORA_NO_FREE_CH);
+		return false;
+	}
+
+	// charged at the data rate of the request, the slowest one if the module could not tell
+	getCurrentDataRate();
+	eDataRate dataRate = this->request->getLinkDataRate();
+
+	// "ok" then "accepted" or "denied", both handled by the command engine, the module transmits after "ok"
+	this->request->txStart = this->request->now();
+	bool joined = (this->request->rnRequest(MAC, CommandTable::name(JOIN), STR_OTAA) != NULL);
 
-	response = RnRequest.getResponse(JOIN_TIMEOUT);
-	return (response != NULL);
+	if (joined || isTransmitted(getLastError())) this->dutyCycle.record(this->request->txStart, (TimeOnAir::frame(dataRate, JOIN_REQUEST_SIZE) + 999) / 1000);
+	return joined;
+}
+
+bool OrangeForRN2483Class::rejoin()
+{
+	this->isNetworkJoined = join();
+	return this->isNetworkJoined;
 }
 
 uint8_t* OrangeForRN2483Class::tx(eTypeMessage typeMessage, uint8_t * data, uint8_t size, uint8_t port)
 {
 	getSysCmds()->wakeUp();
-	String type = (typeMessage == CONFIRMED_MESSAGE) ? STR_CNF : STR_UNCNF;
-	return RnRequest.rnUplinkRequest(type.c_str(), data, size, port);
+	if (this->dutyCycleEnforced && (nextTxOpportunity() > 0))
+	{
+		setLastError(LORA_NO_FREE_CH);
+		return NULL;
+	}
+
+	// ADR may change the data rate after the uplink, it is kept for the airtime
+	getCurrentDataRate();
+	eDataRate dataRate = this->request->getLinkDataRate();
+
+	// charged from the "ok" of the module, which transmits right after, or from the request without "ok"
+	const char* type = (typeMessage == CONFIRMED_MESSAGE) ? STR_CNF : STR_UNCNF;
+	this->request->txStart = this->request->now();
+	uint8_t* response = this->request->rnUplinkRequest(type, data, size, port);
+
+	if ((response != NULL) || isTransmitted(getLastError())) recordUplink(this->request->txStart, TimeOnAir::dataFrame(dataRate, size), typeMessage == CONFIRMED_MESSAGE);
+	return response;
+}
+
+void OrangeForRN2483Class::recordUplink(uint32_t start, uint32_t airtime, bool confirmed)
+{
+	this->dutyCycle.record(start, airtime);
+	if (!confirmed) return;
+
+	// the module does not tell how many times a confirmed uplink was sent: at most retx retransmissions,
+	// each one after the receive windows and the shortest ACK_TIMEOUT, all charged as late as they can have started
+	uint32_t end = this->request->now();
+	uint32_t cycle = airtime + this->request->linkTiming.rxDelay1 + RX_WINDOW_GAP + ACK_TIMEOUT_MIN;
+	uint32_t retransmissions = (end - start) / cycle;
+	if (retransmissions > this->request->linkTiming.retx) retransmissions = this->request->linkTiming.retx;
+
+	for (uint32_t i = retransmissions; i > 0; i--)
+	{
+		uint32_t latest = end - airtime - ((i - 1) * cycle);
+		this->dutyCycle.record(latest, airtime);
+	}
+}
+
+bool OrangeForRN2483Class::isTransmitted(eErrorType errorType)
+{
+	// the module answered "ok" before the failure
+	return (errorType == LORA_JOIN_DENIED) || (errorType == LORA_MAC_ERR) || (errorType == LORA_TIMEOUT);
+}
+
+uint32_t OrangeForRN2483Class::nextTxOpportunity()
+{
+	return this->dutyCycle.nextTxOpportunity(this->request->now());
+}
+
+DutyCycle* OrangeForRN2483Class::getDutyCycle()
+{
+	return &this->dutyCycle;
+}
+
+void OrangeForRN2483Class::enforceDutyCycle(bool enable)
+{
+	this->dutyCycleEnforced = enable;
+}
+
+bool OrangeForRN2483Class::setChannelDutyCycle(uint8_t channel, uint16_t dcycle)
+{
+	if (channel >= this->dutyCycle.getChannelCount())
+	{
+		setLastError(LORA_INVALID_PARAM);
+		return false;
+	}
+
+	getSysCmds()->wakeUp();
+	char values[20];
+	snprintf(values, sizeof(values), "dcycle %u %u", channel, dcycle);
+	if (this->request->rnRequest(MAC, SET, CommandTable::name(CHANNEL), values) == NULL) return false;
+
+	return this->dutyCycle.setChannelDutyCycle(channel, dcycle);
+}
+
+bool OrangeForRN2483Class::readChannelDutyCycles()
+{
+	getSysCmds()->wakeUp();
+	bool read = true;
+	for (uint8_t i = 0; i < this->dutyCycle.getChannelCount(); i++)
+	{
+		char values[12];
+		snprintf(values, sizeof(values), "dcycle %u", i);
+		uint8_t* response = this->request->rnRequest(MAC, GET, CommandTable::name(CHANNEL), values);
+
+		if ((response == NULL) || (*response < '0') || (*response > '9')) read = false;
+		else this->dutyCycle.setChannelDutyCycle(i, (uint16_t)atol((char*)response));
+	}
+	return read;
 }
 
 bool OrangeForRN2483Class::save()
 {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, params[SAVE]) != NULL);
+	return (this->request->rnRequest(MAC, CommandTable::name(SAVE)) != NULL);
 }
 
 bool OrangeForRN2483Class::pause() {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, params[PAUSE]) != NULL);
+	return (this->request->rnRequest(MAC, CommandTable::name(PAUSE)) != NULL);
 }
 
 bool OrangeForRN2483Class::resume() {
 	getSysCmds()->wakeUp();
-	return (RnRequest.rnRequest(MAC, params[RESUME]) != NULL);
+	return (this->request->rnRequest(MAC, CommandTable::name(RESUME)) != NULL);
 }
 
 void OrangeForRN2483Class::deepSleep(uint8_t hours, uint8_t minutes, uint8_t seconds)
@@ -458,7 +1031,10 @@ void OrangeForRN2483Class::deepSleep(uint8_t hours, uint8_t minutes, uint8_t sec
 	exitSleepMode = false;
 
 	uint32_t delayMs = (((hours * 60) + minutes) * 60) + seconds;
-	OrangeForRN2483.getSysCmds()->sleep(delayMs + 60000);
+	getSysCmds()->sleep(delayMs + 60000);
+
+	// the alarm wakes the instance which went to sleep
+	OrangeForRN2483Class::refOrangeForRN2483 = this;
 
 	rtc.begin();
 
@@ -472,6 +1048,10 @@ void OrangeForRN2483Class::deepSleep(uint8_t hours, uint8_t minutes, uint8_t sec
 	USBDevice.detach();
 
 	rtc.standbyMode();
+
+	// millis() did not count the time spent in standby, the RTC started from 0 did
+	uint32_t slept = ((((rtc.getDay() - 1) * 24UL + rtc.getHours()) * 60 + rtc.getMinutes()) * 60) + rtc.getSeconds();
+	this->request->advanceClock(slept * 1000);
 }
 
 bool OrangeForRN2483Class::isDeepSleeping()
@@ -42,62 +42,87 @@
 #include "LpwaOrangeEncoder.h"
 #include "RnRequest.h"
 #include "DownlinkMessage.h"
+#include "DutyCycle.h"
+#include "DownlinkQueue.h"
+
+/**
+* \brief     "mac set" command queued in a batch
+* \details   The value is kept as the string written to the module, the result is filled when the batch is committed
+*/
+typedef struct _sMacSetCommand {
+	eParamMac param;
+	char value[MAX_BATCH_VALUE_SIZE];
+	eErrorType result;
+}sMacSetCommand;
+
+/**
+* \brief     Settings of the module applied by applyProfile()
+* \details   The RX2 settings are the ones of the 868 MHz band
+*/
+typedef struct _sDeviceProfile {
+	eDataRate dataRate;
+	bool adr;
+	uint8_t retx;
+	uint8_t pwrIdx;
+	uint16_t rxDelay1;
+	eDataRate rx2DataRate;
+	uint32_t rx2Frequency;
+	uint8_t syncWord;
+	uint16_t linkCheck;						// seconds, 0 to disable
+	uint8_t batteryLevel;					// 0 external power, 1 to 254 level, 255 unknown
+}sDeviceProfile;
+
+/**
+* \brief     Function receiving the downlinks of a range of ports
+* \details   The payload is read in place, it is only valid during the call
+*/
+typedef void(*downlinkHandler)(uint8_t port, const uint8_t* payload, uint16_t len, void* context);
+
+/**
+* \brief     Handler bound to a range of ports
+*/
+typedef struct _sDownlinkBinding {
+	uint8_t firstPort;
+	uint8_t lastPort;
+	downlinkHandler handler;
+	void* context;
+}sDownlinkBinding;
+
+/**
+* \brief     Counters of the downlink dispatch
+*/
+typedef struct _sDownlinkStats {
+	uint32_t queued;						// Downlinks queued for the handlers
+	uint32_t dispatched;					// Downlinks given to a handler
+	uint32_t unhandled;						// Downlinks on a port without handler
+	uint32_t overflows;						// Downlinks lost because the queue was full
+	uint8_t maxDepth;						// Largest number of downlinks waiting at once
+}sDownlinkStats;
 
 class OrangeForRN2483Class
 {
 protected:	
+	RnRequestClass* request;
 	RadioCmdsClass RadioCmds;
 	SysCmdsClass SysCmds;
-	DownlinkMessage downlinkMessage;	
+	DownlinkMessage downlinkMessage;
+	DutyCycle dutyCycle;
+	bool dutyCycleEnforced;
+
+	sDownlinkBinding downlinkBindings[MAX_DOWNLINK_HANDLERS];
+	DownlinkQueue downlinkQueue;
+	sDownlinkStats downlinkStats;
 
 	Stream* diagStream;
 	bool isNetworkJoined;
+	eRegion region;
+	uint8_t fragmentedMessages;
 	bool deepSleeping;
 	bool exitSleepMode;
 
-	const char* params[COUNT_PARAM_MAC] = {
-		"devaddr",
-		"deveui",
-		"appeui",
-		"band",
-		"dr",
-		"pwridx",
-		"adr",
-		"retx",
-		"rxdelay1",
-		"rxdelay2",
-		"ar",
-		"rx2",
-		"dcycleps",
-		"mrgn",
-		"gwnb",
-		"status",
-		"sync",
-		"upctr",
-		"dnctr",
-		"nwkskey",
-		"appskey",
-		"appkey",
-		"join",
-		"tx",
-		"bat",
-		"linkchk",
-		"save",
-		"pause",
-		"resume"
-	};
-
-	const char* commandType[COUNT_TYPE] = { "mac", "sys", "radio" };
-	const char* possibleResponses[LORA_COUNT_ERRORS] = { "ok"
-													"invalid_param",
-													"keys_not_init",
-													"no_free_ch",
-													"silent",
-													"busy",
-													"mac_paused",
-													"denied",
-													"invalid_data_len",
-													"frame_counter_err_rejoin_needed"}; 
+	sMacSetCommand batch[MAX_BATCH_COMMANDS];
+	uint8_t batchCount;
+
 	bool isStreamInit();
 	
 	uint8_t* tx(eTypeMessage typeMessage, uint8_t * data, uint8_t size, uint8_t port);
@@ -108,6 +133,17 @@ protected:
 	bool setOttaKeys(const uint8_t* devEui, const uint8_t* appEui, const uint8_t* appKey);
 
 	void resetDevice();
+	void registerHandlers();
+
+	static bool isTransmitted(eErrorType errorType);
+	void recordUplink(uint32_t start, uint32_t airtime, bool confirmed);
+	bool hasDownlinkHandler();
+	void queueDownlink();
+
+	static void onBatchResponse(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context);
+	static void onProfileResponse(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context);
+	void readProfileState(uint8_t window, char known[][CACHE_VALUE_SIZE]);
+	static void onModuleEvent(eResponseToken token, uint8_t* line, void* context);
 
 public:
 	static OrangeForRN2483Class* refOrangeForRN2483;
@@ -116,9 +152,11 @@ public:
 
 	/**
 	* @brief		Constructor for the OrangeForRN2483Class class
-	* @details		Used to instanciate a new OrangeForRN2483Class object
+	* @details		Used to instanciate a new OrangeForRN2483Class object. Each module needs its own RnRequestClass
+	*				object, initialized with the transport the module is connected to
+	* @param		request		Object communicating with the module, the global RnRequest by default
 	*/
-	OrangeForRN2483Class();
+	OrangeForRN2483Class(RnRequestClass* request = &RnRequest);
 
 	/**
 	* @brief		Destructor for the OrangeForRN2483Class class
@@ -132,6 +170,64 @@ public:
 	*/
 	void init();
 
+	/**
+	* @brief		Initializing the communication with the module through a given transport
+	* @details		Used when the module is not on Serial2: another UART, a serial port of a Linux host, or a
+	*				LoopbackTransport in tests
+	* @param		transport		Transport connected to the module, already opened
+	*/
+	void init(RnTransport* transport);
+
+	/**
+	* @brief		Processing the data received from the module
+	* @details		This function must be called regularly, typically from loop(), to drive the asynchronous
+	*				commands and to receive the lines sent by the module outside of a command, such as a late
+	*				downlink or the banner sent after a reset
+	*/
+	void poll();
+
+	/**
+	* @brief		Binding a handler to the downlinks of a port
+	* @details		Once a handler is bound, the downlinks are queued when received and handed over to the handlers
+	*				by \e poll(), in the order they were received, never during a blocking uplink
+	* @param		port		Port of the downlinks, from 1 to 223
+	* @param		handler		Function receiving the downlinks
+	* @param		context		Pointer given back to the handler
+	* @return		Boolean value, false if MAX_DOWNLINK_HANDLERS handlers are already bound
+	*/
+	bool onDownlink(uint8_t port, downlinkHandler handler, void* context = NULL);
+
+	/**
+	* @brief		Binding a handler to the downlinks of a range of ports
+	* @details		The first bound handler whose range contains the port receives the downlink
+	* @param		firstPort	First port of the range
+	* @param		lastPort	Last port of the range, included
+	* @param		handler		Function receiving the downlinks
+	* @param		context		Pointer given back to the handler
+	* @return		Boolean value, false if MAX_DOWNLINK_HANDLERS handlers are already bound
+	*/
+	bool onDownlink(uint8_t firstPort, uint8_t lastPort, downlinkHandler handler, void* context = NULL);
+
+	/**
+	* @brief		Unbinding a handler from all its ports
+	* @param		handler		Function given to \e onDownlink()
+	*/
+	void removeDownlinkHandler(downlinkHandler handler);
+
+	/**
+	* @brief		Handing the queued downlinks over to their handlers
+	* @details		Called by \e poll(), a handler may send an uplink, the downlinks it brings are dispatched by
+	*				the next call
+	* @return		Decimal number representing the number of downlinks taken from the queue
+	*/
+	uint8_t dispatchDownlinks();
+
+	/**
+	* @brief		Getter on the counters of the downlink dispatch
+	* @param		stats		Pointer on a sDownlinkStats structure to fill
+	*/
+	void getDownlinkStats(sDownlinkStats* stats);
+
 	/**
 	* @brief		Getter for the \e isNetworkJoined class attribute
 	* @details		This function allows the user to have access to the isNetworkJoined attribute
@@ -181,6 +277,83 @@ public:
 	*/
 	bool sendMessage(eTypeMessage typeMessage, uint8_t* data, uint8_t size, uint8_t port);
 
+	/**
+	* @brief		Sending data larger than the maximum payload of the data rate
+	* @details		The data is split into as many uplinks as needed, each one starting with a 2 bytes header: the
+	*				message number, then the fragment index with the FRAGMENT_LAST flag on the last fragment.
+	*				FragmentReassembler rebuilds the message on the server side. The size is checked against
+	*				MAX_FRAGMENTS fragments at the current data rate before sending anything, then each fragment waits
+	*				for nextTxOpportunity(). Sending stops at the first failure
+	* @param		typeMessage		eTypeMessage value representing the uplink payload type (\e CONFIRMED_MESSAGE or \e UNCONFIRMED_MESSAGE)
+	* @param		data		Data sent to the server
+	* @param		size		Number of bytes of the data
+	* @param		port		Integer value representing the port to use
+	* @return		Boolean value, true if every fragment was sent
+	*/
+	bool sendFragmented(eTypeMessage typeMessage, const uint8_t* data, uint16_t size, uint8_t port);
+
+	/**
+	* @brief		Setter for the regional parameters of the network
+	* @param		region		eRegion value, \e REGION_EU868 by default
+	*/
+	void setRegion(eRegion region);
+
+	/**
+	* @brief		Getter for the regional parameters of the network
+	* @return		eRegion value
+	*/
+	eRegion getRegion();
+
+	/**
+	* @brief		Getter on the largest payload accepted at the current data rate
+	* @details		The data rate is the one of \e getCurrentDataRate(), the slowest one if it is unknown. Larger
+	*				payloads are refused by \e sendMessage() without being sent to the module
+	* @return		Size in bytes
+	*/
+	uint8_t getMaxPayloadSize();
+
+	/**
+	* @brief		Getter on the delay before the duty cycle allows the next uplink
+	* @details		Computed from the time on air of the previous uplinks and join requests and the dcycle of each
+	*				channel, as the module does. An uplink or a join request sent earlier is refused with
+	*				\e LORA_NO_FREE_CH without being sent to the module (see enforceDutyCycle()), the application
+	*				can sleep until then instead. The module does not tell how many times a confirmed uplink was
+	*				sent: the most retransmissions which fit before its response are charged
+	* @return		Duration in ms, 0 if an uplink can be sent now
+	*/
+	uint32_t nextTxOpportunity();
+
+	/**
+	* @brief		Enabling or disabling the refusal of the uplinks by the library
+	* @details		Enabled by default. Disabled, the uplinks and join requests are always sent and the module
+	*				answers "no_free_ch" itself, the time on air is still accounted for \e nextTxOpportunity()
+	* @param		enable		Boolean value, false to let the module decide
+	*/
+	void enforceDutyCycle(bool enable = true);
+
+	/**
+	* @brief		Setting the duty cycle of a channel of the module
+	* @details		Sends "mac set ch dcycle" and updates the accounting of the library
+	* @param		channel		Channel number, among the ones declared with getDutyCycle()->addChannel()
+	* @param		dcycle		Duty cycle of the channel: 100 / (dcycle + 1) %
+	* @return		Boolean value, true if the module accepted it
+	*/
+	bool setChannelDutyCycle(uint8_t channel, uint16_t dcycle);
+
+	/**
+	* @brief		Reading the duty cycle of the declared channels from the module
+	* @details		Sends "mac get ch dcycle" for each channel, to call when the module was configured without this library
+	* @return		Boolean value, true if every channel was read
+	*/
+	bool readChannelDutyCycles();
+
+	/**
+	* @brief		Getter on the duty cycle accounting
+	* @details		Used to declare the channels enabled on the module when they are not the default ones
+	* @return		Pointer on the DutyCycle object
+	*/
+	DutyCycle* getDutyCycle();
+
 	/**
 	* @brief		Sending data to the server
 	* @details		This function allows the user to \b send \b data to the server by giving
@@ -213,6 +386,29 @@ public:
 	*/
 	SysCmdsClass* getSysCmds();
 
+	/**
+	* @brief		Getter on the object communicating with the module
+	* @details		Gives access to the asynchronous commands and to the statistics of this module
+	* @return		The RnRequestClass object given to the constructor
+	*/
+	RnRequestClass* getRequest();
+
+	/**
+	* @brief		Enabling or disabling the cache of the module parameters
+	* @details		Enabled by default: a getter returns the value the library last wrote or read without sending
+	*				any command. Disable it to read every value from the module
+	* @param		enable		Boolean value, false to always read the parameters from the module
+	*/
+	void enableCache(bool enable = true);
+
+	/**
+	* @brief		Reading the next parameter from the module instead of the cache
+	* @details		Applies to the next getter, of this class or of the RADIO and SYS commands, typically
+	*				OrangeForRN2483.refresh().getDataRate(). The value read is cached
+	* @return		This object, to call the getter on
+	*/
+	OrangeForRN2483Class& refresh();
+
 
 	/**
 	* @brief		Getter for the last saved error
@@ -266,7 +462,7 @@ public:
 	* @brief		Getter on the current status of the module
 	* @details		This function allows the user to have access to the \b module \b status
 	*				by executing a "mac get status" command on the module
-	* @param		status		uint32_t variable to store the received status from the module
+	* @param		status		uint32_t variable to store the status decoded from the hexadecimal answer of the module
 	* @return		Boolean value, true if everything is ok, false if there was a problem during the execution
 	*/
 	bool getStatus(uint32_t& status);
@@ -275,7 +471,7 @@ public:
 	* @brief		Getter on the synchronization word
 	* @details		This function allows the user to have access to the \b synchronization \b word
 	*				by executing a "mac get sync" command on the module
-	* @return		The received value as a \e short value
+	* @return		The received hexadecimal value as a \e short value, \e INT_ERROR_FAILED on error
 	*/
 	short getSync();
 
@@ -295,6 +491,14 @@ public:
 	*/
 	eDataRate getDataRate();
 
+	/**
+	* @brief		Getter on the data rate of the next uplink
+	* @details		The last data rate set or read by the library, read again with "mac get dr" after each uplink
+	*				or join while ADR is on, the network being able to change it
+	* @return		eDataRate value, DATA_RATE_ERROR if the module could not tell
+	*/
+	eDataRate getCurrentDataRate();
+
 	/**
 	* @brief		Getter on the output power index value
 	* @details		This function allows the user to have access to the \b output \b power
@@ -372,7 +576,7 @@ public:
 	* @brief		Getter on the uplink frame counter
 	* @details		This function allows the user to have access to the \b uplink \b frame \b counter
 	*				by executing a "mac get upctr" command on the module
-	* @return		The received value as a \e decimal \e number, from 0 to 4294967295
+	* @return		The received value as a \e decimal \e number, from 0 to 4294967295, all bits set on error
 	*/
 	uint64_t getUpctr();
 
@@ -380,7 +584,7 @@ public:
 	* @brief		Getter on the downlink frame counter
 	* @details		This function allows the user to have access to the \b downlink \b frame \b counter
 	*				by executing a "mac get dnctr" command on the module
-	* @return		The received value as a \e decimal \e number, from 0 to 4294967295
+	* @return		The received value as a \e decimal \e number, from 0 to 4294967295, all bits set on error
 	*/
 	uint64_t getDwnctr();
 
@@ -516,7 +720,7 @@ public:
 	* @brief		Setter for the synchronization word
 	* @details		This function allows the user to set or update the \b synchronization \b word for the
 	*				LoRaWAN communication by executing a "mac set sync <syncWord>" command on the module
-	* @param		syncWord		Decimal number representing the synchronization word
+	* @param		syncWord		Number representing the synchronization word, sent in hexadecimal
 	* @return		Boolean value, true if everything is ok, false if there was a problem during the execution
 	*/
 	bool setSync(int8_t syncWord);
@@ -548,6 +752,13 @@ public:
 	*/
 	bool join();
 
+	/**
+	* @brief		Joining the network again with the keys already set
+	* @details		Needed once the frame counter rolled over, the join state is updated
+	* @return		Boolean value, true if the join request was accepted
+	*/
+	bool rejoin();
+
 	/**
 	* @brief		Save configuration parameters to the user EEPROM
 	* @details		This function allows the user to save the \b configuration \b parameters to the user EEPROM,
@@ -573,6 +784,59 @@ public:
 	*/
 	bool resume();	
 
+	/**
+	* @brief		Starting a new batch of "mac set" commands
+	* @details		This function clears the commands queued by a previous batch
+	*/
+	void beginBatch();
+
+	/**
+	* @brief		Queuing a "mac set" command in the current batch
+	* @details		Nothing is sent to the module until \e commitBatch() is called
+	* @param		param		eParamMac value representing the parameter to set
+	* @param		value		String value representing the value of the parameter
+	* @return		Boolean value, false if the batch is full or the value too long
+	*/
+	bool addToBatch(eParamMac param, const char* value);
+
+	/**
+	* @brief		Queuing a "mac set" command with an hexadecimal value in the current batch
+	* @details		Nothing is sent to the module until \e commitBatch() is called
+	* @param		param		eParamMac value representing the parameter to set
+	* @param		value		Hexadecimal number represented by an array of \e len int8_t
+	* @param		len			Size of the array
+	* @return		Boolean value, false if the batch is full or the value too long
+	*/
+	bool addToBatch(eParamMac param, const uint8_t* value, uint8_t len);
+
+	/**
+	* @brief		Sending all the commands of the current batch
+	* @details		The commands are streamed to the module with up to \e window commands waiting for their
+	*				response, the responses being matched with the commands in order
+	* @param		window		Maximum number of commands sent without waiting for a response, from 1 to \e MAX_PENDING_COMMANDS
+	* @return		Decimal number representing the number of commands which failed (see getBatchResult())
+	*/
+	uint8_t commitBatch(uint8_t window = DEFAULT_BATCH_WINDOW);
+
+	/**
+	* @brief		Getter on the result of a command of the last committed batch
+	* @param		index		Position of the command in the batch
+	* @return		\e eErrorType value, \e LORA_SUCCESS if the module accepted the command
+	*/
+	eErrorType getBatchResult(uint8_t index);
+
+	/**
+	* @brief		Applying a set of settings to the module
+	* @details		The settings are compared with the known state of the module, read first when it is not cached,
+	*				and only the changing ones are sent, as a batch. "mac save" is sent once, and only if a
+	*				setting kept by the module across a reset changed. Without the cache, the settings the module
+	*				reports are read again each time, and the write-only ones (link check, battery level) are always sent
+	* @param		profile		Settings to apply
+	* @param		window		Maximum number of commands sent before their response is received
+	* @return		Boolean value, true if every changing setting was applied and saved when needed
+	*/
+	bool applyProfile(const sDeviceProfile& profile, uint8_t window = DEFAULT_BATCH_WINDOW);
+
 	/**
 	* @brief            Put the Sodaq Explorer in deepsleep mode
 	* @details         This function allows the user to put the RN2483 module and the processor in sleep mode for a given
@@ -0,0 +1,275 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "P2PLink.h"
+#include "TimeOnAir.h"
+
+#define TX_MASK			(P2P_TX_BUFFER_SIZE - 1)
+#define RX_MASK			(P2P_RX_BUFFER_SIZE - 1)
+
+static_assert((P2P_TX_BUFFER_SIZE & TX_MASK) == 0, "P2P_TX_BUFFER_SIZE must be a power of 2");
+static_assert((P2P_RX_BUFFER_SIZE & RX_MASK) == 0, "P2P_RX_BUFFER_SIZE must be a power of 2");
+
+P2PLink::P2PLink(OrangeForRN2483Class* orange) : orange(orange), request(NULL), active(false), listening(false),
+	txHead(0), txTail(0), rxHead(0), rxTail(0), frameLength(0), txSequence(0), rxSequence(0), rxSynchronized(false), rxTimeout(0), statsStart(0)
+{
+	memset(&this->config, 0, sizeof(sP2PConfig));
+	memset(&this->stats, 0, sizeof(sP2PStats));
+}
+
+uint32_t P2PLink::getAirtime(uint8_t len)
+{
+	// default preamble of the module, rounded up to the ms
+	return (TimeOnAir::loraFrame(this->config.spreadingFactor, this->config.bandwidth, this->config.codingRate, LORAWAN_PREAMBLE, len) + 999) / 1000;
+}
+
+uint32_t P2PLink::getTxWait()
+{
+	return this->orange->getDutyCycle()->nextTxOpportunity(this->config.frequency, this->request->now());
+}
+
+bool P2PLink::configureRadio()
+{
+	RadioCmdsClass* radio = this->orange->getRadioCmds();
+
+	// the watchdog ends the reception windows, and must not cut the longest transmission
+	uint32_t watchdog = getAirtime(P2P_MAX_PACKET_SIZE) + DEFAULT_TIMEOUT;
+	if (this->config.rxWindow > watchdog) watchdog = this->config.rxWindow;
+	this->rxTimeout = watchdog + DEFAULT_TIMEOUT;
+
+	return radio->setModulation(LORA_MODULATION) && radio->setFrequency(this->config.frequency) &&
+		radio->setSF(this->config.spreadingFactor) && radio->setBandWidth(this->config.bandwidth) &&
+		radio->setCodingRate(this->config.codingRate) && radio->setOutputPower(this->config.power) &&
+		radio->setWatchdog(watchdog);
+}
+
+bool P2PLink::begin(const sP2PConfig& config)
+{
+	if (this->active) end();
+
+	this->request = this->orange->getRequest();
+	this->config = config;
+
+	if (!this->orange->pause()) return false;
+
+	if (!configureRadio())
+	{
+		this->orange->resume();
+		return false;
+	}
+
+	this->request->setRadioSink(&this->packet);
+	this->txHead = this->txTail = 0;
+	this->rxHead = this->rxTail = 0;
+	this->txSequence = 0;
+	this->rxSynchronized = false;
+	this->listening = true;
+	this->active = true;
+	resetStats();
+	return true;
+}
+
+bool P2PLink::end()
+{
+	if (!this->active) return false;
+
+	while (this->request->isBusy()) this->request->poll();
+	this->request->setRadioSink(NULL);
+	this->active = false;
+
+	return this->orange->resume();
+}
+
+void P2PLink::listen(bool enable)
+{
+	this->listening = enable;
+}
+
+uint16_t P2PLink::write(const uint8_t* data, uint16_t len)
+{
+	uint16_t i = 0;
+	for (; i < len; i++)
+	{
+		uint16_t next = (this->txHead + 1) & TX_MASK;
+		if (next == this->txTail) break;
+
+		this->txRing[this->txHead] = data[i];
+		this->txHead = next;
+	}
+	return i;
+}
+
+uint16_t P2PLink::available()
+{
+	return (this->rxHead - this->rxTail) & RX_MASK;
+}
+
+uint16_t P2PLink::read(uint8_t* data, uint16_t size)
+{
+	uint16_t i = 0;
+	for (; (i < size) && (this->rxTail != this->rxHead); i++)
+	{
+		data[i] = this->rxRing[this->rxTail];
+		this->rxTail = (this->rxTail + 1) & RX_MASK;
+	}
+	return i;
+}
+
+void P2PLink::sendNext()
+{
+	uint16_t queued = (this->txHead - this->txTail) & TX_MASK;
+	uint8_t len = (queued > P2P_MAX_PACKET_SIZE - P2P_HEADER_SIZE) ? P2P_MAX_PACKET_SIZE - P2P_HEADER_SIZE : queued;
+
+	this->frame[0] = this->txSequence >> 8;
+	this->frame[1] = this->txSequence & 0xFF;
+	for (uint8_t i = 0; i < len; i++) this->frame[P2P_HEADER_SIZE + i] = this->txRing[(this->txTail + i) & TX_MASK];
+	this->frameLength = P2P_HEADER_SIZE + len;
+
+	// a full pipeline is tried again, any other failure drops the packet as a failed transmission would
+	if (this->request->submitRadioTx(this->frame, this->frameLength, getAirtime(this->frameLength) + DEFAULT_TIMEOUT, onTxDone, this) == RN_INVALID_HANDLE)
+	{
+		if (this->request->getLastError() == LORA_BUSY) return;
+		this->stats.txErrors++;
+	}
+
+	this->txTail = (this->txTail + len) & TX_MASK;
+	this->txSequence++;
+}
+
+void P2PLink::onTxDone(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context)
+{
+	P2PLink* link = (P2PLink*)context;
+	uint32_t airtime = link->getAirtime(link->frameLength);
+
+	// the transmission ended now, the module may have sent the packet before "radio_err" or a timeout
+	if ((errorType == LORA_SUCCESS) || (errorType == LORA_RADIO_ERR) || (errorType == LORA_TIMEOUT))
+	{
+		link->orange->getDutyCycle()->record(link->config.frequency, link->request->now() - airtime, airtime);
+	}
+
+	if (errorType != LORA_SUCCESS)
+	{
+		link->stats.txErrors++;
+		return;
+	}
+
+	link->stats.packetsSent++;
+	link->stats.bytesSent += link->frameLength - P2P_HEADER_SIZE;
+	link->stats.airtime += airtime;
+}
+
+void P2PLink::onRxDone(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context)
+{
+	P2PLink* link = (P2PLink*)context;
+
+	if (errorType == LORA_RADIO_ERR) link->stats.rxWindows++;
+	else if (errorType != LORA_SUCCESS) link->stats.rxErrors++;
+	else
+	{
+		uint16_t len;
+		const uint8_t* data = link->packet.getPayload(&len);
+		if ((data == NULL) || link->packet.isTruncated()) link->stats.invalidPackets++;
+		else link->deliver(data, len);
+	}
+}
+
+void P2PLink::deliver(const uint8_t* data, uint16_t len)
+{
+	if (len < P2P_HEADER_SIZE)
+	{
+		this->stats.invalidPackets++;
+		return;
+	}
+
+	uint16_t sequence = ((uint16_t)data[0] << 8) | data[1];
+	if (this->rxSynchronized)
+	{
+		int16_t gap = (int16_t)(sequence - this->rxSequence);
+		if (gap == -1)
+		{
+			this->stats.duplicates++;
+			return;
+		}
+		// a backward jump is a restart of the sender
+		if (gap > 0) this->stats.lostPackets += gap;
+	}
+	this->rxSynchronized = true;
+	this->rxSequence = sequence + 1;
+
+	len -= P2P_HEADER_SIZE;
+	uint16_t free = (this->rxTail - this->rxHead - 1) & RX_MASK;
+	if (len > free)
+	{
+		this->stats.overflows++;
+		return;
+	}
+
+	for (uint16_t i = 0; i < len; i++)
+	{
+		this->rxRing[this->rxHead] = data[P2P_HEADER_SIZE + i];
+		this->rxHead = (this->rxHead + 1) & RX_MASK;
+	}
+	this->stats.packetsReceived++;
+	this->stats.bytesReceived += len;
+}
+
+void P2PLink::poll()
+{
+	if (!this->active) return;
+
+	this->request->poll();
+	if (this->request->isBusy()) return;
+
+	if ((this->txHead != this->txTail) && (getTxWait() == 0)) sendNext();
+	else if (this->listening) this->request->submitRadioRx(0, this->rxTimeout, onRxDone, this);
+}
+
+void P2PLink::flush()
+{
+	while (this->active && ((this->txHead != this->txTail) || this->request->isBusy()))
+	{
+		this->request->poll();
+		if (!this->request->isBusy() && (this->txHead != this->txTail) && (getTxWait() == 0)) sendNext();
+	}
+}
+
+uint32_t P2PLink::nextTxOpportunity()
+{
+	return (this->request != NULL) ? getTxWait() : 0;
+}
+
+bool P2PLink::isActive()
+{
+	return this->active;
+}
+
+void P2PLink::getStats(sP2PStats* stats)
+{
+	memcpy(stats, &this->stats, sizeof(sP2PStats));
+	stats->duration = (this->request != NULL) ? this->request->now() - this->statsStart : 0;
+}
+
+void P2PLink::resetStats()
+{
+	memset(&this->stats, 0, sizeof(sP2PStats));
+	this->statsStart = (this->request != NULL) ? this->request->now() : 0;
+}
+
+uint32_t P2PLink::getGoodput()
+{
+	sP2PStats current;
+	getStats(&current);
+	if (current.duration == 0) return 0;
+
+	return (uint32_t)(((uint64_t)current.bytesSent + current.bytesReceived) * 1000 / current.duration);
+}
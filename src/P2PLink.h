@@ -0,0 +1,203 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			P2PLink.h
+* @brief		Raw LoRa point-to-point stream between two modules
+* @details		The LoRaWAN stack is paused and the radio configured once, then the written bytes are cut into
+*				packets of the largest size, each one preceded by a sequence number, and sent back-to-back with
+*				"radio tx". Between transmissions the module listens with "radio rx": the received packets are
+*				checked against their sequence number and their data queued in a ring buffer. The link is half
+*				duplex, queued data waits for the end of the current reception window. The packets are charged to
+*				the duty cycle of the module, shared with the LoRaWAN uplinks, in the sub-band of the frequency:
+*				queued data also waits for the sub-band to be free again, listening meanwhile.
+*/
+
+#ifndef _P2P_LINK_H
+#define _P2P_LINK_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "OrangeForRN2483.h"
+#include "DownlinkMessage.h"
+
+/**
+* \brief     Radio settings of a P2PLink, both ends must use the same ones
+*/
+typedef struct _sP2PConfig {
+	uint32_t frequency;						// Hz
+	eSpreadingFactor spreadingFactor;
+	uint16_t bandwidth;						// kHz: 125, 250 or 500
+	eCodingRate codingRate;
+	int8_t power;							// dBm
+	uint16_t rxWindow;						// ms listened before sending the queued data, at least the longest packet
+}sP2PConfig;
+
+/**
+* \brief     Statistics of a P2PLink
+*/
+typedef struct _sP2PStats {
+	uint32_t packetsSent;					// "radio_tx_ok" received
+	uint32_t packetsReceived;				// Packets whose data was queued
+	uint32_t bytesSent;						// Data bytes of the sent packets, without the sequence numbers
+	uint32_t bytesReceived;					// Data bytes of the received packets, without the sequence numbers
+	uint32_t airtime;						// Time on air of the sent packets in ms
+	uint32_t txErrors;						// Transmissions ended by "radio_err" or a timeout
+	uint32_t rxWindows;						// Reception windows ended without a packet
+	uint32_t rxErrors;						// Receptions without a response from the module
+	uint32_t lostPackets;					// Gaps in the received sequence numbers
+	uint32_t duplicates;					// Packets received twice
+	uint32_t invalidPackets;				// Packets too short, truncated or not hexadecimal
+	uint32_t overflows;						// Packets dropped, the ring buffer being full
+	uint32_t duration;						// Time since begin() or resetStats() in ms
+}sP2PStats;
+
+class P2PLink
+{
+protected:
+	OrangeForRN2483Class* orange;
+	RnRequestClass* request;
+	sP2PConfig config;
+	bool active;
+	bool listening;
+
+	uint8_t txRing[P2P_TX_BUFFER_SIZE];
+	uint16_t txHead;
+	uint16_t txTail;
+	uint8_t rxRing[P2P_RX_BUFFER_SIZE];
+	uint16_t rxHead;
+	uint16_t rxTail;
+
+	uint8_t frame[P2P_MAX_PACKET_SIZE];
+	uint8_t frameLength;
+	DownlinkMessageBuffer<P2P_MAX_PACKET_SIZE> packet;
+	uint16_t txSequence;
+	uint16_t rxSequence;
+	bool rxSynchronized;
+	uint32_t rxTimeout;
+
+	uint32_t statsStart;
+	sP2PStats stats;
+
+	static void onTxDone(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context);
+	static void onRxDone(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context);
+
+	uint32_t getAirtime(uint8_t len);
+	uint32_t getTxWait();
+	bool configureRadio();
+	void sendNext();
+	void deliver(const uint8_t* data, uint16_t len);
+
+public:
+	/**
+	* @brief		Constructor for the P2PLink class
+	* @param		orange		Object driving the module, the global OrangeForRN2483 by default
+	*/
+	P2PLink(OrangeForRN2483Class* orange = &OrangeForRN2483);
+
+	/**
+	* @brief		Entering the point-to-point mode
+	* @details		Pauses the LoRaWAN stack and configures the radio. The radio watchdog is set to the reception
+	*				window, or to the time on air of the longest packet when it is longer
+	* @param		config		Radio settings
+	* @return		Boolean value, false if the stack could not be paused or a setting was refused
+	*/
+	bool begin(const sP2PConfig& config);
+
+	/**
+	* @brief		Leaving the point-to-point mode
+	* @details		Waits for the current transmission or reception, then resumes the LoRaWAN stack. The data still
+	*				queued is discarded, see \e flush()
+	* @return		Boolean value, true if the stack was resumed
+	*/
+	bool end();
+
+	/**
+	* @brief		Enabling or disabling the reception
+	* @details		While enabled, the module listens whenever it has nothing to send. Enabled by \e begin()
+	* @param		enable		Boolean value, false to only send
+	*/
+	void listen(bool enable);
+
+	/**
+	* @brief		Queuing bytes to be sent
+	* @details		The bytes are sent by \e poll(), in packets of the largest size
+	* @param		data		Bytes to send
+	* @param		len			Number of bytes
+	* @return		Decimal number representing the number of queued bytes, lower than \e len if the buffer is full
+	*/
+	uint16_t write(const uint8_t* data, uint16_t len);
+
+	/**
+	* @brief		Getter on the number of received bytes waiting to be read
+	* @return		Decimal number, up to \e P2P_RX_BUFFER_SIZE - 1
+	*/
+	uint16_t available();
+
+	/**
+	* @brief		Reading received bytes
+	* @param		data		Buffer receiving the bytes
+	* @param		size		Size of the buffer
+	* @return		Decimal number representing the number of read bytes
+	*/
+	uint16_t read(uint8_t* data, uint16_t size);
+
+	/**
+	* @brief		Driving the link
+	* @details		Must be called regularly, typically from loop(). Sends the next packet as soon as the previous
+	*				command is done, or starts a reception window when nothing is queued
+	*/
+	void poll();
+
+	/**
+	* @brief		Sending all the queued bytes
+	* @details		Drives the link until the queue is empty and the last packet is sent, waiting for the duty
+	*				cycle between the packets. Packets refused by the radio are not sent again, the receiver sees
+	*				them as lost
+	*/
+	void flush();
+
+	/**
+	* @brief		Getter on the delay before the duty cycle allows the next packet
+	* @return		Duration in ms, 0 if a packet can be sent now
+	*/
+	uint32_t nextTxOpportunity();
+
+	/**
+	* @brief		Check if the point-to-point mode is entered
+	* @return		Boolean value, true between \e begin() and \e end()
+	*/
+	bool isActive();
+
+	/**
+	* @brief		Getter on the statistics of the link
+	* @param		stats		Pointer on the structure receiving a copy of the statistics
+	*/
+	void getStats(sP2PStats* stats);
+
+	/**
+	* @brief		Resetting all the statistics to 0
+	*/
+	void resetStats();
+
+	/**
+	* @brief		Getter on the sustained goodput
+	* @details		Data bytes sent and received, without the sequence numbers, divided by the time since \e begin()
+	*				or \e resetStats()
+	* @return		Decimal number representing the goodput in bytes per second
+	*/
+	uint32_t getGoodput();
+};
+
+#endif
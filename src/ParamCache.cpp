@@ -0,0 +1,152 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "ParamCache.h"
+
+#define NETWORK_PARAM					0x80	// flag of the parameters the network can change
+
+typedef struct _sCachedParam {
+	uint8_t type;
+	uint8_t param;							// eParamMac or eParamRad value, with NETWORK_PARAM
+}sCachedParam;
+
+static const sCachedParam cachedParams[CACHED_PARAMS] PROGMEM = {
+	{ MAC, DEVADDR | NETWORK_PARAM },
+	{ MAC, DEVEUI },
+	{ MAC, APPEUI },
+	{ MAC, DATARATE | NETWORK_PARAM },
+	{ MAC, PWR_IND_VAL | NETWORK_PARAM },
+	{ MAC, ADR },
+	{ MAC, RETRANS_NB | NETWORK_PARAM },
+	{ MAC, RX_DELAY_1 | NETWORK_PARAM },
+	{ MAC, AUTO_REPLY },
+	{ MAC, SYNC },
+	{ MAC, RX2 | NETWORK_PARAM },			// value for the 868 MHz band
+	{ MAC, LINK_CHECK },					// write only
+	{ MAC, BAT_LVL },						// write only
+	{ RADIO, BT | NETWORK_PARAM },
+	{ RADIO, MOD | NETWORK_PARAM },
+	{ RADIO, FREQ | NETWORK_PARAM },
+	{ RADIO, PWR | NETWORK_PARAM },
+	{ RADIO, SPR_FACTOR | NETWORK_PARAM },
+	{ RADIO, AUTO_FREQ_CORR_BW | NETWORK_PARAM },
+	{ RADIO, RECEIVE_BW | NETWORK_PARAM },
+	{ RADIO, BIT_RATE | NETWORK_PARAM },
+	{ RADIO, FREQ_DEVIATION | NETWORK_PARAM },
+	{ RADIO, PREAMBLE_LENGTH | NETWORK_PARAM },
+	{ RADIO, CRC | NETWORK_PARAM },
+	{ RADIO, IQ_INVERS | NETWORK_PARAM },
+	{ RADIO, CODING_RATE | NETWORK_PARAM },
+	{ RADIO, WATCHDOG_TIMER | NETWORK_PARAM },
+	{ RADIO, BANDWIDTH | NETWORK_PARAM },
+	{ RADIO, SYNC_RADIO | NETWORK_PARAM }
+};
+
+ParamCache::ParamCache()
+{
+	this->valid = 0;
+	this->staged = 0;
+}
+
+int8_t ParamCache::find(uint8_t type, const char* param)
+{
+	if ((param == NULL) || ((type != MAC) && (type != RADIO))) return CACHE_MISS;
+
+	for (int8_t i = 0; i < CACHED_PARAMS; i++)
+	{
+		if (pgm_read_byte(&cachedParams[i].type) != type) continue;
+
+		uint8_t index = pgm_read_byte(&cachedParams[i].param) & ~NETWORK_PARAM;
+		const char* name = (type == MAC) ? CommandTable::name((eParamMac)index) : CommandTable::name((eParamRad)index);
+		if (strcmp(name, param) == 0) return i;
+	}
+	return CACHE_MISS;
+}
+
+const char* ParamCache::get(uint8_t type, const char* param)
+{
+	return get(find(type, param));
+}
+
+const char* ParamCache::get(int8_t index)
+{
+	if ((index < 0) || ((this->valid & ((uint32_t)1 << index)) == 0)) return NULL;
+#if RN_PARAM_CACHE
+	return this->values[index];
+#else
+	return NULL;
+#endif
+}
+
+void ParamCache::store(int8_t index, const char* value, uint16_t len)
+{
+#if RN_PARAM_CACHE
+	if ((index == CACHE_MISS) || (len >= CACHE_VALUE_SIZE)) return;
+
+	memcpy(this->values[index], value, len);
+	this->values[index][len] = '\0';
+	this->valid |= ((uint32_t)1 << index);
+	this->staged &= ~((uint32_t)1 << index);
+#endif
+}
+
+int8_t ParamCache::stage(uint8_t type, const char* param, const char* value, uint16_t len)
+{
+#if RN_PARAM_CACHE
+	int8_t i = find(type, param);
+	if ((i == CACHE_MISS) || (len >= CACHE_VALUE_SIZE)) return CACHE_MISS;
+
+	memcpy(this->values[i], value, len);
+	this->values[i][len] = '\0';
+	this->valid &= ~((uint32_t)1 << i);
+	this->staged |= ((uint32_t)1 << i);
+	return i;
+#else
+	return CACHE_MISS;
+#endif
+}
+
+void ParamCache::validate(int8_t index)
+{
+	if ((index == CACHE_MISS) || ((this->staged & ((uint32_t)1 << index)) == 0)) return;
+
+	this->valid |= ((uint32_t)1 << index);
+	this->staged &= ~((uint32_t)1 << index);
+}
+
+void ParamCache::invalidate(uint8_t type, const char* param)
+{
+	int8_t i = find(type, param);
+	if (i == CACHE_MISS) return;
+
+	this->valid &= ~((uint32_t)1 << i);
+	this->staged &= ~((uint32_t)1 << i);
+}
+
+void ParamCache::invalidateNetworkParams()
+{
+	for (uint8_t i = 0; i < CACHED_PARAMS; i++)
+	{
+		if (pgm_read_byte(&cachedParams[i].param) & NETWORK_PARAM)
+		{
+			this->valid &= ~((uint32_t)1 << i);
+			this->staged &= ~((uint32_t)1 << i);
+		}
+	}
+}
+
+void ParamCache::invalidateAll()
+{
+	this->valid = 0;
+	this->staged = 0;
+}
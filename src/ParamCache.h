@@ -0,0 +1,118 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			ParamCache.h
+* @brief		Copy of the MAC and RADIO parameters of the module known by the library
+* @details		Only the configuration parameters are kept, the values the module updates by itself (counters,
+*				status, margin...) are always read from the module. A parameter the network can change through
+*				a MAC command or ADR is flagged and dropped from the cache by each uplink and join. The values are
+*				only kept when the library is built with RN_PARAM_CACHE set to 1, otherwise every getter reads
+*				the module.
+*/
+
+#ifndef _PARAM_CACHE_H
+#define _PARAM_CACHE_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "CommandTable.h"
+
+#define CACHE_MISS						-1
+#define CACHE_UNKNOWN					-2		// position not looked up yet
+
+class ParamCache
+{
+protected:
+#if RN_PARAM_CACHE
+	char values[CACHED_PARAMS][CACHE_VALUE_SIZE];
+#endif
+	uint32_t valid;
+	uint32_t staged;
+
+public:
+	/**
+	* @brief		Constructor for the ParamCache class, the cache is empty
+	*/
+	ParamCache();
+
+	/**
+	* @brief		Getter on the position of a parameter in the cache
+	* @param		type		eTypeCommand value, \e MAC or \e RADIO
+	* @param		param		String value representing the parameter name
+	* @return		Position of the parameter, \e CACHE_MISS if it is not a cached parameter
+	*/
+	static int8_t find(uint8_t type, const char* param);
+
+	/**
+	* @brief		Getter on the cached value of a parameter
+	* @param		type		eTypeCommand value, \e MAC or \e RADIO
+	* @param		param		String value representing the parameter name
+	* @return		The value as returned by the module, NULL if it is not known
+	*/
+	const char* get(uint8_t type, const char* param);
+
+	/**
+	* @brief		Getter on the cached value of a parameter
+	* @param		index		Position returned by \e find()
+	* @return		The value as returned by the module, NULL if it is not known
+	*/
+	const char* get(int8_t index);
+
+	/**
+	* @brief		Storing the value of a parameter
+	* @details		Nothing is stored for a too long value
+	* @param		index		Position returned by \e find()
+	* @param		value		Value of the parameter, as returned by the module
+	* @param		len			Number of characters of the value
+	*/
+	void store(int8_t index, const char* value, uint16_t len);
+
+	/**
+	* @brief		Keeping the value written by a "set" command until the module accepts it
+	* @details		The value becomes the cached one with \e validate(), unless the parameter was invalidated meanwhile
+	* @param		type		eTypeCommand value, \e MAC or \e RADIO
+	* @param		param		String value representing the parameter name
+	* @param		value		Value written to the module
+	* @param		len			Number of characters of the value
+	* @return		Position of the parameter, \e CACHE_MISS if it is not cached or the value is too long
+	*/
+	int8_t stage(uint8_t type, const char* param, const char* value, uint16_t len);
+
+	/**
+	* @brief		Making the value kept by \e stage() the cached one
+	* @param		index		Position returned by \e stage()
+	*/
+	void validate(int8_t index);
+
+	/**
+	* @brief		Removing a parameter from the cache
+	* @param		type		eTypeCommand value, \e MAC or \e RADIO
+	* @param		param		String value representing the parameter name
+	*/
+	void invalidate(uint8_t type, const char* param);
+
+	/**
+	* @brief		Removing the parameters the network or the LoRaWAN stack may have changed
+	* @details		MAC parameters set by MAC commands or ADR, and all the RADIO parameters, which the stack overwrites
+	*/
+	void invalidateNetworkParams();
+
+	/**
+	* @brief		Emptying the cache
+	*/
+	void invalidateAll();
+};
+
+#endif
@@ -17,174 +17,417 @@
 
 #include "RadioCmds.h"
 #include "RnRequest.h"
+#include "NumberParser.h"
+#include "TimeOnAir.h"
+
+// answers of the module, in the order of eBT and eCodingRate
+static const char* const gfBT[BT_COUNT] = { "none", "1.0", "0.5", "0.3" };
+static const char* const codingRates[] = { "4/5", "4/6", "4/7", "4/8" };
+
+RadioCmdsClass::RadioCmdsClass(RnRequestClass* request)
+{
+	this->request = request;
+}
 
 eBT RadioCmdsClass::getBt()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[BT]);
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(BT));
 
 	if(response == NULL) return BT_ERROR;
 
-	String res = String((char*) response);
-
-	if (res.equals("none")) return BT_NONE;
-	else if (res.equals("1.0")) return BT_1_0;
-	else if (res.equals("0.5")) return BT_0_5;
-	else if (res.equals("0.3")) return BT_0_3;
-	else return BT_ERROR;	
+	for (uint8_t bt = 0; bt < BT_COUNT; bt++)
+	{
+		if (strcmp((char*)response, gfBT[bt]) == 0) return (eBT)bt;
+	}
+	return BT_ERROR;
 }
 
 bool RadioCmdsClass::setBt(eBT bt)
 {
-	String gfBT[] = {"none", "1.0", "0.5", "0.3" };
 	if ((bt < 0) || (bt > BT_COUNT - 1)) return false;
-	return (RnRequest.rnRequest(RADIO, SET, params[BT], gfBT[bt].c_str()) != NULL);
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(BT), gfBT[bt]) != NULL);
 }
 
 eModulation RadioCmdsClass::getModulation()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[MOD]);
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(MOD));
 	if (response == NULL) return GET_MODULATION_ERROR;
 
-	eModulation modulation = String((char*)response).equals("lora") ? LORA_MODULATION : FSK_MODULATION;
-	return modulation;
+	return (strcmp((char*)response, "lora") == 0) ? LORA_MODULATION : FSK_MODULATION;
 }
 
 bool RadioCmdsClass::setModulation(eModulation modulation)
 {
-	String mod = (modulation == FSK_MODULATION) ? "fsk" : "lora";
+	const char* mod = (modulation == FSK_MODULATION) ? "fsk" : "lora";
 
-	return (RnRequest.rnRequest(RADIO, SET, params[MOD], mod.c_str()) != NULL);
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(MOD), mod) != NULL);
 }
 
 eSpreadingFactor RadioCmdsClass::getSF()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[SPR_FACTOR]);
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(SPR_FACTOR));
 	
 	if(response == NULL) return SF_ERROR;
 	
-	String strValue = String((const char*)response + 2);
-	return (eSpreadingFactor)strValue.toInt();
+	// "sf7" to "sf12"
+	uint32_t sf;
+	if ((strncmp((char*)response, "sf", 2) != 0) || !NumberParser::parseUInt((char*)response + 2, &sf)) return SF_ERROR;
+	return (eSpreadingFactor)sf;
 }
 
 bool RadioCmdsClass::setSF(eSpreadingFactor spreadingFactor)
 {
 	String strSF = "sf" + String(spreadingFactor);
-	return (RnRequest.rnRequest(RADIO, SET, params[SPR_FACTOR], strSF.c_str()) != NULL);
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(SPR_FACTOR), strSF.c_str()) != NULL);
 }
 
 eBoolean RadioCmdsClass::getCrc()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[CRC]);
-	return (response != NULL) ? iS_ON(String((char*)response)) : BOOL_ERROR;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(CRC));
+	return (response != NULL) ? iS_ON(response) : BOOL_ERROR;
 }
 
 eBoolean RadioCmdsClass::getIqInversion()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[IQ_INVERS]);
-	return (response != NULL) ? iS_ON(String((char*)response)) : BOOL_ERROR;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(IQ_INVERS));
+	return (response != NULL) ? iS_ON(response) : BOOL_ERROR;
 }
 
 eCodingRate RadioCmdsClass::getCodingRate()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[CODING_RATE]);
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(CODING_RATE));
 	if (response == NULL) return CR_ERROR;
 
-	String res = String((char*)response);
-
-	if(res.equals("4/5")) return CR_4_5;
-	else if(res.equals("4/6")) return CR_4_6;
-	else if (res.equals("4/7")) return CR_4_7;
-	else if (res.equals("4/8")) return CR_4_8;
-	else return CR_ERROR;	
+	for (uint8_t codingRate = 0; codingRate < sizeof(codingRates) / sizeof(codingRates[0]); codingRate++)
+	{
+		if (strcmp((char*)response, codingRates[codingRate]) == 0) return (eCodingRate)codingRate;
+	}
+	return CR_ERROR;
 }
 
 short RadioCmdsClass::getSync()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[SYNC_RADIO]);
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(SYNC_RADIO));
 	if (response == NULL) return INT_ERROR_FAILED;
 
-	String sync = "0x" + String((char*)response);
-	return sync.toInt();
+	uint32_t sync;
+	return NumberParser::parseHex((char*)response, &sync) ? (short)sync : INT_ERROR_FAILED;
 }
 
 float RadioCmdsClass::getAutoFreqCorrBw()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[AUTO_FREQ_CORR_BW]);
-	return (response != NULL) ? String((char*)response).toFloat() : FLT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(AUTO_FREQ_CORR_BW));
+	int32_t bandwidth;
+	return ((response != NULL) && NumberParser::parseFixed((char*)response, 1, &bandwidth)) ? bandwidth / 10.0 : FLT_ERROR_FAILED;
 }
 
 float RadioCmdsClass::getReceiveBw()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[RECEIVE_BW]);
-	return (response != NULL) ? String((char*)response).toFloat() : FLT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(RECEIVE_BW));
+	int32_t bandwidth;
+	return ((response != NULL) && NumberParser::parseFixed((char*)response, 1, &bandwidth)) ? bandwidth / 10.0 : FLT_ERROR_FAILED;
 }
 
 bool RadioCmdsClass::getOutputPower(int8_t& outputPower)
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[PWR]);
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(PWR));
 	if(response == NULL) return false;
   
-	outputPower = String((char*)response).toInt();
+	int32_t value;
+	if (!NumberParser::parseInt((char*)response, &value)) return false;
+
+	outputPower = value;
 	return true;
 }
 
 bool RadioCmdsClass::setOutputPower(int8_t pwrout)
 {
-	return (RnRequest.rnRequest(RADIO, SET, params[PWR], String(pwrout).c_str()) != NULL);
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(PWR), String(pwrout).c_str()) != NULL);
 }
 
 int16_t RadioCmdsClass::getBandWidth()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[BANDWIDTH]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(BANDWIDTH));
+	int32_t value;
+	return ((response != NULL) && NumberParser::parseInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 int16_t RadioCmdsClass::getSigNoiseRation()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[SIG_NOISE_RATIO]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(SIG_NOISE_RATIO));
+	int32_t value;
+	return ((response != NULL) && NumberParser::parseInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 int32_t RadioCmdsClass::getBitRate()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[BIT_RATE]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(BIT_RATE));
+	int32_t value;
+	return ((response != NULL) && NumberParser::parseInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 int32_t RadioCmdsClass::getFreqDeviation()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[FREQ_DEVIATION]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(FREQ_DEVIATION));
+	int32_t value;
+	return ((response != NULL) && NumberParser::parseInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 int32_t RadioCmdsClass::getPreambleLength()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[PREAMBLE_LENGTH]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(PREAMBLE_LENGTH));
+	int32_t value;
+	return ((response != NULL) && NumberParser::parseInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 int32_t RadioCmdsClass::getFrequency()
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[FREQ]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(FREQ));
+	int32_t value;
+	return ((response != NULL) && NumberParser::parseInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 bool RadioCmdsClass::setFrequency(int32_t frequency)
 {	
-	return (RnRequest.rnRequest(RADIO, SET, params[FREQ], String(frequency).c_str()) != NULL);
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(FREQ), String(frequency).c_str()) != NULL);
 }
 
 bool RadioCmdsClass::getWatchdog(uint64_t& watchdog)
 {
-	uint8_t* response = RnRequest.rnRequest(RADIO, GET, params[WATCHDOG_TIMER]);
+	uint8_t* response = this->request->rnRequest(RADIO, GET, CommandTable::name(WATCHDOG_TIMER));
 	if (response == NULL) return false;
 	
-	watchdog = String((char*)response).toInt();
-	return true;
+	return NumberParser::parseUInt64((char*)response, &watchdog);
 }
 
 bool RadioCmdsClass::setAutoFreqBand(String autoFreqBand)
 {
-	return (RnRequest.rnRequest(RADIO, SET, params[AUTO_FREQ_CORR_BW], autoFreqBand.c_str()) != NULL);
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(AUTO_FREQ_CORR_BW), autoFreqBand.c_str()) != NULL);
+}
+
+bool RadioCmdsClass::setBandWidth(uint16_t bandwidth)
+{
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(BANDWIDTH), String(bandwidth).c_str()) != NULL);
+}
+
+bool RadioCmdsClass::setCodingRate(eCodingRate codingRate)
+{
+	if ((codingRate < CR_4_5) || (codingRate > CR_4_8)) return false;
+
+	char cr[] = "4/5";
+	cr[2] += codingRate;
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(CODING_RATE), cr) != NULL);
+}
+
+bool RadioCmdsClass::setWatchdog(uint32_t watchdog)
+{
+	return (this->request->rnRequest(RADIO, SET, CommandTable::name(WATCHDOG_TIMER), String(watchdog).c_str()) != NULL);
+}
+
+bool RadioCmdsClass::transmit(const uint8_t* data, uint8_t len)
+{
+	if ((len == 0) || (len > P2P_MAX_PACKET_SIZE)) return false;
+
+	// the radio settings are not known here, the slowest ones bound the transmission
+	uint32_t finalTimeout = TimeOnAir::loraFrame(12, 125, CR_4_8, LORAWAN_PREAMBLE, len) / 1000 + DEFAULT_TIMEOUT;
+
+	while (this->request->isBusy()) this->request->poll();
+	return (this->request->waitFor(this->request->submitRadioTx(data, len, finalTimeout)) != NULL);
+}
+
+bool RadioCmdsClass::stopReceive()
+{
+	return (this->request->rnRequest(RADIO, CommandTable::name(RX_STOP)) != NULL);
+}
+
+
+// "radio get" parameter of each field of sRadioConfig
+static const uint8_t radioConfigParams[COUNT_RADIO_CFG] PROGMEM = {
+	MOD, FREQ, PWR, SPR_FACTOR, BANDWIDTH, CODING_RATE, CRC, IQ_INVERS, SYNC_RADIO, PREAMBLE_LENGTH, WATCHDOG_TIMER, SIG_NOISE_RATIO
+};
+
+#define BW_BASE			125
+#define BW_UNKNOWN		0xFF
+
+bool RadioCmdsClass::parseConfigField(sRadioConfig* config, uint8_t field, const char* value)
+{
+	int32_t number;
+	uint32_t unsignedNumber;
+
+	switch (field)
+	{
+		case RADIO_CFG_MOD:
+			if (strcmp(value, "lora") == 0) config->modulation = LORA_MODULATION;
+			else if (strcmp(value, "fsk") == 0) config->modulation = FSK_MODULATION;
+			else return false;
+			return true;
+
+		case RADIO_CFG_FREQ:
+			return NumberParser::parseUInt(value, &config->frequency);
+
+		case RADIO_CFG_PWR:
+			if (!NumberParser::parseInt(value, &number)) return false;
+			config->power = number;
+			return true;
+
+		case RADIO_CFG_SF:
+			// "sf7" to "sf12"
+			if ((strncmp(value, "sf", 2) != 0) || !NumberParser::parseUInt(value + 2, &unsignedNumber)) return false;
+			if ((unsignedNumber < SF7) || (unsignedNumber > SF12)) return false;
+			config->spreadingFactor = (eSpreadingFactor)unsignedNumber;
+			return true;
+
+		case RADIO_CFG_BW:
+			if (!NumberParser::parseUInt(value, &unsignedNumber) || (unsignedNumber > 0xFFFF)) return false;
+			config->bandwidth = unsignedNumber;
+			return true;
+
+		case RADIO_CFG_CR:
+			// "4/5" to "4/8"
+			if ((value[0] != '4') || (value[1] != '/') || (value[2] < '5') || (value[2] > '8') || (value[3] != 0)) return false;
+			config->codingRate = (eCodingRate)(CR_4_5 + (value[2] - '5'));
+			return true;
+
+		case RADIO_CFG_CRC:
+		case RADIO_CFG_IQI:
+		{
+			eBoolean state;
+			if (strcmp(value, STR_ON) == 0) state = BOOL_TRUE;
+			else if (strcmp(value, STR_OFF) == 0) state = BOOL_FALSE;
+			else return false;
+
+			if (field == RADIO_CFG_CRC) config->crc = state;
+			else config->iqInversion = state;
+			return true;
+		}
+
+		case RADIO_CFG_SYNC:
+			if (!NumberParser::parseHex(value, &unsignedNumber) || (unsignedNumber > 0xFF)) return false;
+			config->sync = unsignedNumber;
+			return true;
+
+		case RADIO_CFG_PRLEN:
+			if (!NumberParser::parseUInt(value, &unsignedNumber) || (unsignedNumber > 0xFFFF)) return false;
+			config->preambleLength = unsignedNumber;
+			return true;
+
+		case RADIO_CFG_WDT:
+			return NumberParser::parseUInt(value, &config->watchdog);
+
+		case RADIO_CFG_SNR:
+			if (!NumberParser::parseInt(value, &number) || (number < -128) || (number > 127)) return false;
+			config->snr = number;
+			return true;
+
+		default:
+			return false;
+	}
 }
 
+void RadioCmdsClass::onConfigResponse(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context)
+{
+	sRadioSweep* sweep = (sRadioSweep*)context;
+	if ((errorType != LORA_SUCCESS) || (response == NULL)) return;
+
+	for (uint8_t field = 0; field < COUNT_RADIO_CFG; field++)
+	{
+		if (sweep->handles[field] != handle) continue;
+
+		if (parseConfigField(sweep->config, field, (char*)response)) sweep->config->valid |= (1 << field);
+		return;
+	}
+}
+
+bool RadioCmdsClass::snapshot(sRadioConfig* config, uint8_t window)
+{
+	memset(config, 0, sizeof(sRadioConfig));
+	config->power = INT_ERROR_FAILED;
+	config->modulation = GET_MODULATION_ERROR;
+	config->spreadingFactor = SF_ERROR;
+	config->codingRate = CR_ERROR;
+	config->crc = BOOL_ERROR;
+	config->iqInversion = BOOL_ERROR;
+
+	sRadioSweep sweep;
+	sweep.config = config;
+	memset(sweep.handles, RN_INVALID_HANDLE, sizeof(sweep.handles));
+
+	while (this->request->isBusy()) this->request->poll();
+	this->request->setPipelineDepth(window);
+
+	uint8_t next = 0;
+	while ((next < COUNT_RADIO_CFG) || this->request->isBusy())
+	{
+		if (next < COUNT_RADIO_CFG)
+		{
+			eParamRad param = (eParamRad)pgm_read_byte(&radioConfigParams[next]);
+			sweep.handles[next] = this->request->submit(RADIO, GET, CommandTable::name(param), (const char*)NULL, onConfigResponse, &sweep);
+
+			// a full pipeline is retried once a response is received, any other failure skips the field
+			if ((sweep.handles[next] != RN_INVALID_HANDLE) || (this->request->getLastError() != LORA_BUSY)) next++;
+		}
+		this->request->poll();
+	}
+	this->request->setPipelineDepth(1);
+
+	return (config->valid == (1 << COUNT_RADIO_CFG) - 1);
+}
+
+uint8_t RadioCmdsClass::serializeConfig(const sRadioConfig& config, uint8_t* buffer)
+{
+	uint8_t flags = 0;
+	if (config.modulation == LORA_MODULATION) flags |= 0x80;
+	if (config.crc == BOOL_TRUE) flags |= 0x40;
+	if (config.iqInversion == BOOL_TRUE) flags |= 0x20;
+	if (config.codingRate != CR_ERROR) flags |= (config.codingRate & 0x03) << 3;
+	if (config.spreadingFactor != SF_ERROR) flags |= (config.spreadingFactor - SF7) & 0x07;
+
+	uint8_t bandwidth = BW_UNKNOWN;
+	for (uint8_t i = 0; i < 3; i++)
+	{
+		if (config.bandwidth == (BW_BASE << i)) bandwidth = i;
+	}
+
+	uint8_t counter = 0;
+	buffer[counter++] = config.valid >> 8;
+	buffer[counter++] = config.valid & 0xFF;
+	buffer[counter++] = flags;
+	buffer[counter++] = config.frequency >> 24;
+	buffer[counter++] = (config.frequency >> 16) & 0xFF;
+	buffer[counter++] = (config.frequency >> 8) & 0xFF;
+	buffer[counter++] = config.frequency & 0xFF;
+	buffer[counter++] = (uint8_t)config.power;
+	buffer[counter++] = bandwidth;
+	buffer[counter++] = config.sync;
+	buffer[counter++] = config.preambleLength >> 8;
+	buffer[counter++] = config.preambleLength & 0xFF;
+	buffer[counter++] = config.watchdog >> 24;
+	buffer[counter++] = (config.watchdog >> 16) & 0xFF;
+	buffer[counter++] = (config.watchdog >> 8) & 0xFF;
+	buffer[counter++] = config.watchdog & 0xFF;
+	buffer[counter++] = (uint8_t)config.snr;
+	return counter;
+}
+
+bool RadioCmdsClass::deserializeConfig(const uint8_t* data, uint8_t len, sRadioConfig* config)
+{
+	if (len != RADIO_CONFIG_SIZE) return false;
+
+	config->valid = ((uint16_t)data[0] << 8) | data[1];
+	uint8_t flags = data[2];
+	config->frequency = ((uint32_t)data[3] << 24) | ((uint32_t)data[4] << 16) | ((uint32_t)data[5] << 8) | data[6];
+	config->power = (int8_t)data[7];
+	config->bandwidth = (data[8] < 3) ? (BW_BASE << data[8]) : 0;
+	config->sync = data[9];
+	config->preambleLength = ((uint16_t)data[10] << 8) | data[11];
+	config->watchdog = ((uint32_t)data[12] << 24) | ((uint32_t)data[13] << 16) | ((uint32_t)data[14] << 8) | data[15];
+	config->snr = (int8_t)data[16];
+
+	// the packed fields which were not received keep their error value
+	config->modulation = (config->valid & (1 << RADIO_CFG_MOD)) ? ((flags & 0x80) ? LORA_MODULATION : FSK_MODULATION) : GET_MODULATION_ERROR;
+	config->crc = (config->valid & (1 << RADIO_CFG_CRC)) ? ((flags & 0x40) ? BOOL_TRUE : BOOL_FALSE) : BOOL_ERROR;
+	config->iqInversion = (config->valid & (1 << RADIO_CFG_IQI)) ? ((flags & 0x20) ? BOOL_TRUE : BOOL_FALSE) : BOOL_ERROR;
+	config->codingRate = (config->valid & (1 << RADIO_CFG_CR)) ? (eCodingRate)((flags >> 3) & 0x03) : CR_ERROR;
+	config->spreadingFactor = (config->valid & (1 << RADIO_CFG_SF)) ? (eSpreadingFactor)(SF7 + (flags & 0x07)) : SF_ERROR;
+	return true;
+}
@@ -32,62 +32,72 @@
 #endif
 
 #include "ConstOrangeForRN2483.h"
+#include "CommandTable.h"
+#include "RnRequest.h"
 
 /**
-* \brief     Different kind of RADIO commands
-* \details   Each of these values is used to find the correct string value in the \e params attribute of the class
+* \brief     Fields of a radio configuration snapshot, in the order they are read
+* \details   Field \e f was received and parsed when bit (1 << f) of \e sRadioConfig::valid is set
 */
-typedef enum _paramRad {
-	RX = 0,
-	TX_RADIO,
-	CW,
-	BT,
-	MOD,
-	FREQ,
-	PWR,
-	SPR_FACTOR,
-	AUTO_FREQ_CORR_BW,
-	RECEIVE_BW,
-	BIT_RATE,
-	FREQ_DEVIATION,
-	PREAMBLE_LENGTH,
-	CRC,
-	IQ_INVERS,
-	CODING_RATE,
-	WATCHDOG_TIMER,
-	BANDWIDTH,
-	SIG_NOISE_RATIO,
-	SYNC_RADIO,
-	COUNT_PARAM_RAD
-}eParamRad;
+typedef enum _eRadioConfigField {
+	RADIO_CFG_MOD = 0,
+	RADIO_CFG_FREQ,
+	RADIO_CFG_PWR,
+	RADIO_CFG_SF,
+	RADIO_CFG_BW,
+	RADIO_CFG_CR,
+	RADIO_CFG_CRC,
+	RADIO_CFG_IQI,
+	RADIO_CFG_SYNC,
+	RADIO_CFG_PRLEN,
+	RADIO_CFG_WDT,
+	RADIO_CFG_SNR,
+	COUNT_RADIO_CFG
+}eRadioConfigField;
+
+/**
+* \brief     Radio configuration of the module read at once by \e RadioCmdsClass::snapshot()
+* \details   The fields which were not received keep their error value
+*/
+typedef struct _sRadioConfig {
+	uint32_t frequency;					// Hz
+	uint32_t watchdog;						// ms
+	uint16_t bandwidth;					// kHz
+	uint16_t preambleLength;
+	uint16_t valid;						// Bit field of the received fields
+	int8_t power;							// dBm
+	int8_t snr;							// dB, last received packet
+	uint8_t sync;
+	eModulation modulation;
+	eSpreadingFactor spreadingFactor;
+	eCodingRate codingRate;
+	eBoolean crc;
+	eBoolean iqInversion;
+}sRadioConfig;
 
 class RadioCmdsClass
 {
  protected:
-	 const char* params[COUNT_PARAM_RAD] = {
-		 "rx",
-		 "tx",
-		 "cw",
-		 "bt",
-		 "mod",
-		 "freq",
-		 "pwr",
-		 "sf",
-		 "afcbw",
-		 "rxbw",
-		 "bitrate",
-		 "fdev",
-		 "prlen",
-		 "crc",
-		 "iqi",
-		 "cr",
-		 "wdt",
-		 "bw",
-		 "snr",
-		 "sync",
-	 };
+	 RnRequestClass* request;
+
+	 /**
+	 * @brief		Responses of the commands sent by \e snapshot()
+	 */
+	 typedef struct _sRadioSweep {
+		 sRadioConfig* config;
+		 RnHandle handles[COUNT_RADIO_CFG];
+	 }sRadioSweep;
+
+	 static void onConfigResponse(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context);
+	 static bool parseConfigField(sRadioConfig* config, uint8_t field, const char* value);
 
  public:
+	 /**
+	 * @brief		Constructor for the RadioCmdsClass class
+	 * @param		request		Object communicating with the module the commands are sent to
+	 */
+	 RadioCmdsClass(RnRequestClass* request = &RnRequest);
+
 	 /**constOrangeForRn2483
 	 * @brief		Getter on the data shaping FSK configuration
 	 * @details		This function allows the user to have access to the \b data \b shaping \b FSK \b configuration
@@ -167,7 +177,7 @@ class RadioCmdsClass
 	 * @brief		Getter on the synchronization word used for radio communication
 	 * @details		This function allows the user to have access to the configured synchronization word used for 
 	 *				radio communication during communication by executing a "radio get sync" command on the module
-	 * @return		The received value as a \e short value
+	 * @return		The received hexadecimal value as a \e short value, \e INT_ERROR_FAILED on error
 	 */
 	 short getSync();
 
@@ -280,6 +290,83 @@ class RadioCmdsClass
 	 * @return		Boolean value, true if everything is ok, false if there was a problem during the execution
 	 */
 	 bool setAutoFreqBand(String autoFreqBand);
+
+	 /**
+	 * @brief		Setter for the bandwidth of the LoRa modulation
+	 * @details		This function allows the user to set or update the \b bandwidth used for transmitting and receiving
+	 *				by executing a "radio set bw <bandwidth>" command on the module
+	 * @param		bandwidth		Decimal number representing the bandwidth in kHz: 125, 250 or 500
+	 * @return		Boolean value, true if everything is ok, false if there was a problem during the execution
+	 */
+	 bool setBandWidth(uint16_t bandwidth);
+
+	 /**
+	 * @brief		Setter for the coding rate of the LoRa modulation
+	 * @details		This function allows the user to set or update the \b coding \b rate used for transmitting
+	 *				by executing a "radio set cr <codingRate>" command on the module
+	 * @param		codingRate		eCodingRate value representing the coding rate (see constOrangeForRN2483.h for more information)
+	 * @return		Boolean value, true if everything is ok, false if there was a problem during the execution
+	 */
+	 bool setCodingRate(eCodingRate codingRate);
+
+	 /**
+	 * @brief		Setter for the watchdog time-out
+	 * @details		This function allows the user to set or update the \b length of the \b watchdog \b time-out bounding
+	 *				"radio tx" and "radio rx" by executing a "radio set wdt <watchdog>" command on the module
+	 * @param		watchdog		Decimal number representing the time-out in ms, 0 to disable the watchdog
+	 * @return		Boolean value, true if everything is ok, false if there was a problem during the execution
+	 */
+	 bool setWatchdog(uint32_t watchdog);
+
+	 /**
+	 * @brief		Transmitting a raw LoRa packet
+	 * @details		This function sends a packet with the current radio settings by executing a "radio tx <data>"
+	 *				command on the module, and waits for the end of the transmission. The MAC must be paused first
+	 * @param		data		Byte array representing the packet
+	 * @param		len			Size of the packet, up to \e P2P_MAX_PACKET_SIZE
+	 * @return		Boolean value, true once "radio_tx_ok" is received
+	 */
+	 bool transmit(const uint8_t* data, uint8_t len);
+
+	 /**
+	 * @brief		Stopping a continuous reception
+	 * @details		This function ends a "radio rx 0" the module is still running, typically after its response timed
+	 *				out, by executing a "radio rxstop" command on the module
+	 * @return		Boolean value, true if everything is ok, false if there was a problem during the execution
+	 */
+	 bool stopReceive();
+
+	 /**
+	 * @brief		Reading the whole radio configuration at once
+	 * @details		The "radio get" commands of every field of \e sRadioConfig are sent back-to-back, up to
+	 *				\e window commands waiting for their response at the same time, and each response fills its
+	 *				field as it is received. The call returns once every command is done
+	 * @param		config		Structure receiving the configuration
+	 * @param		window		Maximum number of commands sent before their response is received
+	 * @return		Boolean value, true if every field was received and parsed, see \e sRadioConfig::valid otherwise
+	 */
+	 bool snapshot(sRadioConfig* config, uint8_t window = MAX_PENDING_COMMANDS);
+
+	 /**
+	 * @brief		Encoding a radio configuration to be sent in an uplink
+	 * @details		The \e RADIO_CONFIG_SIZE bytes are, in network byte order: the valid fields (2 bytes),
+	 *				LoRa modulation, CRC, IQ inversion, coding rate and spreading factor minus 7 packed from bit 7
+	 *				to bit 0 (1 byte), frequency (4), power (1), bandwidth as a power of 2 times 125 kHz (1),
+	 *				sync word (1), preamble length (2), watchdog (4) and SNR (1)
+	 * @param		config		Configuration to encode
+	 * @param		buffer		Buffer receiving the bytes, at least \e RADIO_CONFIG_SIZE bytes long
+	 * @return		Decimal number representing the number of written bytes
+	 */
+	 static uint8_t serializeConfig(const sRadioConfig& config, uint8_t* buffer);
+
+	 /**
+	 * @brief		Decoding a radio configuration encoded by \e serializeConfig()
+	 * @param		data		Received bytes
+	 * @param		len			Number of received bytes
+	 * @param		config		Structure receiving the configuration
+	 * @return		Boolean value, false if \e len is not \e RADIO_CONFIG_SIZE
+	 */
+	 static bool deserializeConfig(const uint8_t* data, uint8_t len, sRadioConfig* config);
 };
 
 #endif
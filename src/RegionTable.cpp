@@ -0,0 +1,31 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "RegionTable.h"
+#include "TimeOnAir.h"
+
+uint8_t RegionTable::maxPayloadSize(eRegion region, eDataRate dataRate)
+{
+	if ((dataRate < DATA_RATE_0) || (dataRate >= COUNT_DATA_RATE)) return 0;
+
+	switch (region)
+	{
+		// same value N per data rate in the LoRaWAN Regional Parameters
+		case REGION_EU868:
+		case REGION_EU433:
+			return TimeOnAir::maxPayloadSize(dataRate);
+
+		default:
+			return 0;
+	}
+}
@@ -0,0 +1,40 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			RegionTable.h
+* @brief		Regional parameters of the LoRaWAN networks
+* @details		One case per eRegion value, the EU regions share the data rates of TimeOnAir
+*/
+
+#ifndef _REGION_TABLE_H
+#define _REGION_TABLE_H
+
+#include <Arduino.h>
+
+#include "ConstOrangeForRN2483.h"
+
+class RegionTable
+{
+public:
+	/**
+	* @brief		Getter on the maximum size of the application payload
+	* @details		The size the module accepts for "mac tx", without MAC commands in FOpts
+	* @param		region		eRegion value
+	* @param		dataRate	eDataRate value
+	* @return		Size in bytes, 0 for an unknown region or data rate
+	*/
+	static uint8_t maxPayloadSize(eRegion region, eDataRate dataRate);
+};
+
+#endif
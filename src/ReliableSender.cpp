@@ -0,0 +1,153 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "ReliableSender.h"
+
+ReliableSender::ReliableSender(OrangeForRN2483Class* orange)
+{
+	this->orange = orange;
+	this->policy.baseDelay = DEFAULT_RETRY_DELAY;
+	this->policy.maxDelay = DEFAULT_MAX_RETRY_DELAY;
+	this->policy.missesBeforeDrStep = DEFAULT_MISSES_BEFORE_DR_STEP;
+	this->policy.maxRejoins = DEFAULT_MAX_REJOINS;
+	this->lastAttempts = 0;
+	resetStats();
+}
+
+void ReliableSender::setPolicy(const sRetryPolicy& policy)
+{
+	this->policy = policy;
+}
+
+eFailureClass ReliableSender::classify(eErrorType errorType)
+{
+	switch (errorType)
+	{
+		case LORA_BUSY: return FAILURE_BUSY;
+		case LORA_NO_FREE_CH: return FAILURE_NO_FREE_CH;
+		case LORA_MAC_ERR: return FAILURE_MAC_ERR;
+		case LORA_TRANSPORT_ERR:
+		case LORA_TIMEOUT: return FAILURE_TIMEOUT;
+		case LORA_ERR_FRAME_CNTR_ERR_REJOIN_NEEDED:
+		case LORA_NETWORK_NOT_JOINED: return FAILURE_REJOIN_NEEDED;
+		default: return FAILURE_FATAL;
+	}
+}
+
+uint32_t ReliableSender::getBackoff(uint8_t retry)
+{
+	uint32_t backoff = this->policy.baseDelay;
+	while ((retry-- > 0) && (backoff < this->policy.maxDelay)) backoff *= 2;
+	if (backoff > this->policy.maxDelay) backoff = this->policy.maxDelay;
+
+	// half fixed, half random, so that devices failing together do not retry together
+	return (backoff / 2) + random((backoff / 2) + 1);
+}
+
+void ReliableSender::recordDelivery(uint8_t attempts, uint32_t duration)
+{
+	this->stats.delivered++;
+	this->stats.attemptHistogram[(attempts > ATTEMPT_BUCKETS) ? ATTEMPT_BUCKETS - 1 : attempts - 1]++;
+
+	uint8_t bucket = (duration == 0) ? 0 : 32 - __builtin_clz(duration);
+	if (bucket >= ACK_TIME_BUCKETS) bucket = ACK_TIME_BUCKETS - 1;
+	this->stats.timeToAck[bucket]++;
+}
+
+bool ReliableSender::send(uint8_t* data, uint8_t size, uint8_t port, uint32_t deadline)
+{
+	RnRequestClass* request = this->orange->getRequest();
+	uint32_t start = request->now();
+	uint8_t retries = 0;
+	uint8_t misses = 0;
+	uint8_t rejoins = 0;
+
+	this->stats.messages++;
+	this->lastAttempts = 0;
+
+	while (true)
+	{
+		this->lastAttempts++;
+		this->stats.attempts++;
+		if (this->orange->sendMessage(CONFIRMED_MESSAGE, data, size, port))
+		{
+			recordDelivery(this->lastAttempts, request->now() - start);
+			return true;
+		}
+
+		eErrorType error = this->orange->getLastError();
+		eFailureClass failure = classify(error);
+		this->stats.failures[failure]++;
+
+		uint32_t wait = 0;
+		switch (failure)
+		{
+			case FAILURE_NO_FREE_CH:
+				// the local accounting knows when a channel is free again
+				wait = this->orange->nextTxOpportunity();
+				if (wait == 0) wait = getBackoff(retries++);
+				break;
+
+			case FAILURE_MAC_ERR:
+				misses++;
+				if ((this->policy.missesBeforeDrStep > 0) && (misses >= this->policy.missesBeforeDrStep) && !request->linkTiming.adr &&
+					(request->linkTiming.dataRate > DATA_RATE_0) && this->orange->setDataRate((eDataRate)(request->linkTiming.dataRate - 1)))
+				{
+					this->stats.drSteps++;
+					misses = 0;
+				}
+				wait = getBackoff(retries++);
+				break;
+
+			case FAILURE_REJOIN_NEEDED:
+				if (rejoins++ >= this->policy.maxRejoins) failure = FAILURE_FATAL;
+				else if (this->orange->rejoin()) this->stats.rejoins++;
+				else wait = getBackoff(retries++);
+				break;
+
+			case FAILURE_BUSY:
+			case FAILURE_TIMEOUT:
+				wait = getBackoff(retries++);
+				break;
+
+			default:
+				break;
+		}
+
+		// no use starting an attempt which would end past the deadline
+		uint32_t elapsed = request->now() - start;
+		if ((failure == FAILURE_FATAL) || (elapsed + wait + request->getUplinkTimeout(size, false) > deadline))
+		{
+			// the error of the attempt, not the one of a data rate change or a rejoin
+			request->setLastError(error);
+			this->stats.givenUp++;
+			return false;
+		}
+		delay(wait);
+	}
+}
+
+uint8_t ReliableSender::getLastAttempts()
+{
+	return this->lastAttempts;
+}
+
+void ReliableSender::getStats(sReliableStats* stats)
+{
+	memcpy(stats, &this->stats, sizeof(sReliableStats));
+}
+
+void ReliableSender::resetStats()
+{
+	memset(&this->stats, 0, sizeof(sReliableStats));
+}
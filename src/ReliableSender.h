@@ -0,0 +1,130 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			ReliableSender.h
+* @brief		Confirmed uplinks sent again until acknowledged or until a deadline
+* @details		Each failure is classified and handled by its own policy: the module being busy or the radio
+*				timing out waits for a jittered exponential backoff, an exhausted duty cycle waits for the next
+*				transmission opportunity, missing acknowledgements lower the data rate after a number of misses,
+*				and a frame counter rollover or a lost session rejoins the network.
+*/
+
+#ifndef _RELIABLE_SENDER_H
+#define _RELIABLE_SENDER_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "OrangeForRN2483.h"
+
+/**
+* \brief     Classes of failure of a confirmed uplink
+*/
+typedef enum _eFailureClass {
+	FAILURE_BUSY = 0,						// "busy", the MAC was not idle
+	FAILURE_NO_FREE_CH,						// "no_free_ch" or refused by the local duty cycle accounting
+	FAILURE_MAC_ERR,						// "mac_err", no acknowledgement received
+	FAILURE_TIMEOUT,						// No response from the module in time
+	FAILURE_REJOIN_NEEDED,					// "frame_counter_err_rejoin_needed" or not joined
+	FAILURE_FATAL,							// Not worth sending again: invalid length, paused MAC...
+	COUNT_FAILURE_CLASSES
+}eFailureClass;
+
+/**
+* \brief     Settings of the policies of a ReliableSender
+*/
+typedef struct _sRetryPolicy {
+	uint32_t baseDelay;						// First backoff in ms, doubled by each retry
+	uint32_t maxDelay;						// Longest backoff in ms
+	uint8_t missesBeforeDrStep;				// Consecutive "mac_err" before lowering the data rate, 0 to never lower it
+	uint8_t maxRejoins;						// Rejoins allowed during one send
+}sRetryPolicy;
+
+/**
+* \brief     Outcome statistics of a ReliableSender
+*/
+typedef struct _sReliableStats {
+	uint32_t messages;						// Calls to send()
+	uint32_t delivered;						// Messages acknowledged
+	uint32_t givenUp;						// Messages not acknowledged before the deadline or after a fatal failure
+	uint32_t attempts;						// "mac tx" sent or refused, all messages
+	uint32_t attemptHistogram[ATTEMPT_BUCKETS];		// Number of attempts of the delivered messages, from 1
+	uint32_t timeToAck[ACK_TIME_BUCKETS];	// log2 of the time from send() to the acknowledgement in ms
+	uint32_t failures[COUNT_FAILURE_CLASSES];
+	uint32_t rejoins;
+	uint32_t drSteps;
+}sReliableStats;
+
+class ReliableSender
+{
+protected:
+	OrangeForRN2483Class* orange;
+	sRetryPolicy policy;
+	sReliableStats stats;
+	uint8_t lastAttempts;
+
+	uint32_t getBackoff(uint8_t retry);
+	void recordDelivery(uint8_t attempts, uint32_t duration);
+
+public:
+	/**
+	* @brief		Constructor for the ReliableSender class, with the default policies
+	* @param		orange		Object sending the uplinks, the global OrangeForRN2483 by default
+	*/
+	ReliableSender(OrangeForRN2483Class* orange = &OrangeForRN2483);
+
+	/**
+	* @brief		Setter for the settings of the policies
+	* @param		policy		sRetryPolicy structure
+	*/
+	void setPolicy(const sRetryPolicy& policy);
+
+	/**
+	* @brief		Classifying the error of a failed uplink
+	* @param		errorType	eErrorType value returned by getLastError()
+	* @return		eFailureClass value
+	*/
+	static eFailureClass classify(eErrorType errorType);
+
+	/**
+	* @brief		Sending a confirmed uplink until it is acknowledged
+	* @details		Blocks until the acknowledgement or a fatal failure, and gives up when the next attempt could
+	*				not end before the deadline. The last error is the one of the last attempt
+	* @param		data		Data sent to the server
+	* @param		size		Number of bytes of the data
+	* @param		port		Integer value representing the port to use
+	* @param		deadline	Maximum duration of the send in ms
+	* @return		Boolean value, true if the uplink was acknowledged
+	*/
+	bool send(uint8_t* data, uint8_t size, uint8_t port, uint32_t deadline);
+
+	/**
+	* @brief		Getter on the number of attempts of the last send
+	* @return		Decimal number
+	*/
+	uint8_t getLastAttempts();
+
+	/**
+	* @brief		Getter on the outcome statistics
+	* @param		stats		Pointer on a sReliableStats structure to fill
+	*/
+	void getStats(sReliableStats* stats);
+
+	/**
+	* @brief		Resetting the outcome statistics
+	*/
+	void resetStats();
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "ResponseClassifier.h"
+
+#define MATCH(line, keyword, token)			((strcmp((line), (keyword)) == 0) ? (token) : RESP_VALUE)
+#define MATCH_PREFIX(line, prefix, token)	((strncmp((line), (prefix), sizeof(prefix) - 1) == 0) ? (token) : RESP_VALUE)
+
+static const uint8_t successTypes[RESP_COUNT_TOKEN] PROGMEM = {
+	LORA_FAILED,			// RESP_VALUE
+	LORA_OK,				// RESP_OK
+	LORA_MAC_TX_OK,			// RESP_MAC_TX_OK
+	LORA_ACCEPTED,			// RESP_ACCEPTED
+	LORA_RX,				// RESP_MAC_RX
+	LORA_FAILED,			// RESP_MAC_ERR
+	LORA_RADIO_TX_OK,		// RESP_RADIO_TX_OK
+	LORA_RADIO_RX,			// RESP_RADIO_RX
+	LORA_FAILED,			// RESP_RADIO_ERR
+	LORA_FAILED,			// RESP_RESET_BANNER
+	LORA_FAILED,			// RESP_INVALID_PARAM
+	LORA_FAILED,			// RESP_KEYS_NOT_INIT
+	LORA_FAILED,			// RESP_NO_FREE_CH
+	LORA_FAILED,			// RESP_SILENT
+	LORA_FAILED,			// RESP_BUSY
+	LORA_FAILED,			// RESP_MAC_PAUSED
+	LORA_FAILED,			// RESP_DENIED
+	LORA_FAILED,			// RESP_INVALID_DATA_LEN
+	LORA_FAILED,			// RESP_FRAME_COUNTER_ERR
+};
+
+static const uint8_t errorTypes[RESP_COUNT_TOKEN] PROGMEM = {
+	LORA_SUCCESS,			// RESP_VALUE
+	LORA_SUCCESS,			// RESP_OK
+	LORA_SUCCESS,			// RESP_MAC_TX_OK
+	LORA_SUCCESS,			// RESP_ACCEPTED
+	LORA_SUCCESS,			// RESP_MAC_RX
+	LORA_MAC_ERR,			// RESP_MAC_ERR
+	LORA_SUCCESS,			// RESP_RADIO_TX_OK
+	LORA_SUCCESS,			// RESP_RADIO_RX
+	LORA_RADIO_ERR,			// RESP_RADIO_ERR
+	LORA_SUCCESS,			// RESP_RESET_BANNER
+	LORA_INVALID_PARAM,		// RESP_INVALID_PARAM
+	LORA_KEYS_NOT_INIT,		// RESP_KEYS_NOT_INIT
+	LORA_NO_FREE_CH,		// RESP_NO_FREE_CH
+	LORA_SILENT,			// RESP_SILENT
+	LORA_BUSY,				// RESP_BUSY
+	LORA_MAC_PAUSED,		// RESP_MAC_PAUSED
+	LORA_JOIN_DENIED,		// RESP_DENIED
+	LORA_INVALID_DATA_LEN,	// RESP_INVALID_DATA_LEN
+	LORA_ERR_FRAME_CNTR_ERR_REJOIN_NEEDED,	// RESP_FRAME_COUNTER_ERR
+};
+
+eResponseToken ResponseClassifier::classify(const char* line)
+{
+	switch (line[0])
+	{
+	case 'o': return MATCH(line, "ok", RESP_OK);
+	case 'a': return MATCH(line, "accepted", RESP_ACCEPTED);
+	case 'b': return MATCH(line, "busy", RESP_BUSY);
+	case 'd': return MATCH(line, "denied", RESP_DENIED);
+	case 'f': return MATCH(line, "frame_counter_err_rejoin_needed", RESP_FRAME_COUNTER_ERR);
+	case 'k': return MATCH(line, "keys_not_init", RESP_KEYS_NOT_INIT);
+	case 'n': return MATCH(line, "no_free_ch", RESP_NO_FREE_CH);
+	case 's': return MATCH(line, "silent", RESP_SILENT);
+	case 'R': return MATCH_PREFIX(line, "RN2483 ", RESP_RESET_BANNER);
+
+	case 'i':
+		if (strncmp(line, "invalid_", 8) != 0) return RESP_VALUE;
+		switch (line[8])
+		{
+		case 'p': return MATCH(line + 8, "param", RESP_INVALID_PARAM);
+		case 'd': return MATCH(line + 8, "data_len", RESP_INVALID_DATA_LEN);
+		}
+		return RESP_VALUE;
+
+	case 'm':
+		if (strncmp(line, "mac_", 4) != 0) return RESP_VALUE;
+		switch (line[4])
+		{
+		case 't': return MATCH(line + 4, "tx_ok", RESP_MAC_TX_OK);
+		case 'e': return MATCH(line + 4, "err", RESP_MAC_ERR);
+		case 'r': return MATCH_PREFIX(line + 4, "rx ", RESP_MAC_RX);
+		case 'p': return MATCH(line + 4, "paused", RESP_MAC_PAUSED);
+		}
+		return RESP_VALUE;
+
+	case 'r':
+		if (strncmp(line, "radio_", 6) != 0) return RESP_VALUE;
+		switch (line[6])
+		{
+		case 't': return MATCH(line + 6, "tx_ok", RESP_RADIO_TX_OK);
+		case 'e': return MATCH(line + 6, "err", RESP_RADIO_ERR);
+		case 'r': return MATCH_PREFIX(line + 6, "rx ", RESP_RADIO_RX);
+		}
+		return RESP_VALUE;
+	}
+	return RESP_VALUE;
+}
+
+eSuccessType ResponseClassifier::getSuccessType(eResponseToken token)
+{
+	return (eSuccessType)pgm_read_byte(&successTypes[token]);
+}
+
+eErrorType ResponseClassifier::getErrorType(eResponseToken token)
+{
+	return (eErrorType)pgm_read_byte(&errorTypes[token]);
+}
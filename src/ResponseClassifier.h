@@ -0,0 +1,80 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			ResponseClassifier.h
+* @brief		Recognition of the lines sent by the module
+* @details		This class maps a line received from the module to a single token. The first character
+*				selects at most one candidate keyword, so a line is recognized with a single comparison
+*				instead of scanning the lists of success and error keywords.
+*/
+
+#ifndef _RESPONSE_CLASSIFIER_H
+#define _RESPONSE_CLASSIFIER_H
+
+#include <Arduino.h>
+
+#include "ConstOrangeForRN2483.h"
+
+/**
+* \brief     Different kind of lines sent by the module
+*/
+typedef enum _eResponseToken {
+	RESP_VALUE = 0,							// Anything else, typically the value returned by a get command
+	RESP_OK,								// "ok"
+	RESP_MAC_TX_OK,							// "mac_tx_ok"
+	RESP_ACCEPTED,							// "accepted"
+	RESP_MAC_RX,							// "mac_rx <port> <data>"
+	RESP_MAC_ERR,							// "mac_err"
+	RESP_RADIO_TX_OK,						// "radio_tx_ok"
+	RESP_RADIO_RX,							// "radio_rx <data>"
+	RESP_RADIO_ERR,							// "radio_err"
+	RESP_RESET_BANNER,						// "RN2483 <version> <date>", sent after a reset
+	RESP_INVALID_PARAM,						// "invalid_param"
+	RESP_KEYS_NOT_INIT,						// "keys_not_init"
+	RESP_NO_FREE_CH,						// "no_free_ch"
+	RESP_SILENT,							// "silent"
+	RESP_BUSY,								// "busy"
+	RESP_MAC_PAUSED,						// "mac_paused"
+	RESP_DENIED,							// "denied"
+	RESP_INVALID_DATA_LEN,					// "invalid_data_len"
+	RESP_FRAME_COUNTER_ERR,					// "frame_counter_err_rejoin_needed"
+	RESP_COUNT_TOKEN
+}eResponseToken;
+
+class ResponseClassifier
+{
+public:
+	/**
+	* @brief		Recognizing a line sent by the module
+	* @param		line		Null terminated line, without its CRLF
+	* @return		\e eResponseToken value corresponding to the line, \e RESP_VALUE if it is not a keyword
+	*/
+	static eResponseToken classify(const char* line);
+
+	/**
+	* @brief		Getter on the success corresponding to a token
+	* @param		token		\e eResponseToken value returned by \e classify()
+	* @return		\e eSuccessType value, \e LORA_FAILED if the token is not a success keyword
+	*/
+	static eSuccessType getSuccessType(eResponseToken token);
+
+	/**
+	* @brief		Getter on the error corresponding to a token
+	* @param		token		\e eResponseToken value returned by \e classify()
+	* @return		\e eErrorType value, \e LORA_SUCCESS if the token is not an error keyword
+	*/
+	static eErrorType getErrorType(eResponseToken token);
+};
+
+#endif
@@ -19,13 +19,48 @@
 #include <stdlib.h>
 
 #include "RnRequest.h"
+#include "HexCodec.h"
 
 RnRequestClass RnRequest;
 
 
 RnRequestClass::RnRequestClass(){
+	this->rxHead = 0;
+	this->rxTail = 0;
 	this->receiveBuffer[0] = 0;
+	this->receiveLength = 0;
+	this->downlinkSink = NULL;
+	this->radioSink = NULL;
+	this->rxSink = NULL;
+	this->rxDecode = RX_DECODE_NONE;
+	for (int i = 0; i < MAX_EVENT_HANDLERS; i++) this->eventHandlers[i] = NULL;
+	this->responseToken = RESP_VALUE;
+	this->transport = NULL;
+	this->clock = NULL;
+	this->clockContext = NULL;
+	this->clockOffset = 0;
+	this->transmitter = NULL;
+	this->txFrame = NULL;
+	this->txLength = 0;
+	this->lastHandle = RN_INVALID_HANDLE;
+	this->commandHead = 0;
+	this->commandCount = 0;
+	this->pipelineDepth = 1;
+	// slowest data rate until the application sets it
+	this->linkTiming.dataRate = DATA_RATE_0;
+	this->linkTiming.dataRateKnown = false;
+	this->linkTiming.rx2DataRate = DATA_RATE_0;
+	this->linkTiming.rxDelay1 = DEFAULT_RX_DELAY_1;
+	this->linkTiming.retx = DEFAULT_RETX;
+	this->linkTiming.adr = false;
+	this->txStart = 0;
+	resetStats();
+	this->cacheEnabled = (RN_PARAM_CACHE != 0);
+	this->cacheBypass = false;
+	this->getCacheIndex = CACHE_UNKNOWN;
 	isAsleep = false;
+	this->sleepStart = 0;
+	this->sleepDuration = 0;
 }
 
 RnRequestClass::~RnRequestClass(){
@@ -33,90 +68,368 @@ RnRequestClass::~RnRequestClass(){
 
 void RnRequestClass::init()
 {
-	this->loraStream = &Serial2;
-	this->loraStream->begin(57600);
+	static UartTransport uartTransport(&Serial2);
+
+	uartTransport.begin();
+	init(&uartTransport);
+}
+
+void RnRequestClass::init(RnTransport* transport)
+{
+	this->transport = transport;
+	this->cache.invalidateAll();
+	this->rxHead = 0;
+	this->rxTail = 0;
+	this->receiveLength = 0;
+	this->commandCount = 0;
 }
 
 bool RnRequestClass::isStreamInit()
 {
-	return (this->loraStream);
+	return (this->transport != NULL);
+}
+
+uint32_t RnRequestClass::now()
+{
+	return (this->clock != NULL) ? this->clock(this->clockContext) : millis() + this->clockOffset;
+}
+
+void RnRequestClass::advanceClock(uint32_t elapsed)
+{
+	this->clockOffset += elapsed;
+}
+
+void RnRequestClass::setDownlinkSink(DownlinkSink* downlink)
+{
+	this->downlinkSink = downlink;
+}
+
+void RnRequestClass::setRadioSink(DownlinkSink* packet)
+{
+	this->radioSink = packet;
+}
+
+void RnRequestClass::setClock(rnClock clock, void* context)
+{
+	this->clockContext = context;
+	this->clock = clock;
+}
+
+bool RnRequestClass::startRecording(Print* sink)
+{
+	if ((this->transport == NULL) || (this->transport == &this->recorder)) return false;
+
+	this->recorder.begin(this->transport, sink);
+	this->transport = &this->recorder;
+	return true;
+}
+
+uint32_t RnRequestClass::stopRecording()
+{
+	if (this->transport == &this->recorder) this->transport = this->recorder.getTransport();
+	return this->recorder.getRecordedBytes();
 }
 
 bool RnRequestClass::cmdRequest(uint8_t type, const char* command, const char* paramName)
 {
-	if (command == NULL)  return false;
+	if (command == NULL)
+	{
+		this->errorType = LORA_INVALID_PARAM;
+		return false;
+	}
+	if ((this->transport == NULL) && (this->transmitter == NULL))
+	{
+		this->errorType = LORA_NOT_INIT;
+		return false;
+	}
 
-	loraDebugPrint(commandType[type]); loraDebugPrint(SEPARATOR);  loraDebugPrint(command); loraDebugPrint(SEPARATOR);  loraDebugPrintLn(paramName);
+	this->txSize = DEFAULT_OUTPUT_BUFFER_SIZE;
+	this->txFrame = (this->transmitter != NULL) ? this->transmitter->acquire(&this->txSize) : this->txBuffer;
+	this->txLength = 0;
+	if (this->txFrame == NULL)
+	{
+		this->errorType = LORA_BUSY;
+		return false;
+	}
+
+	this->txStat = getCommandStat(type, command);
+	invalidateParams(type, command, paramName);
+	this->cacheBypass = false;
+	this->txCacheIndex = CACHE_MISS;
+	this->txVersionQuery = (type == SYS) && (paramName != NULL) && (strcmp(command, GET) == 0) && (strcmp(paramName, CommandTable::name(VERSION)) == 0);
 
-	this->loraStream->print(commandType[type]);
-	this->loraStream->print(SEPARATOR);
-	this->loraStream->print(command);
+	appendToFrame(CommandTable::name((eTypeCommand)type));
+	appendToFrame(SEPARATOR);
+	appendToFrame(command);
 
 	if (paramName != NULL)
 	{
-		this->loraStream->print(SEPARATOR);
-		this->loraStream->print(paramName);
+		appendToFrame(SEPARATOR);
+		appendToFrame(paramName);
 	}
 	return true;
 }
 
+bool RnRequestClass::appendToFrame(const char* str)
+{
+	// txLength goes past txSize once the frame overflowed, sendFrame() then rejects it
+	while (*str != '\0')
+	{
+		if (this->txLength < this->txSize) this->txFrame[this->txLength] = *str;
+		this->txLength++;
+		str++;
+	}
+	return (this->txLength <= this->txSize);
+}
+
+bool RnRequestClass::appendToFrame(uint32_t value)
+{
+	char digits[11];
+	int i = sizeof(digits) - 1;
+
+	digits[i] = '\0';
+	do {
+		digits[--i] = '0' + (value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	return appendToFrame(&digits[i]);
+}
+
 bool RnRequestClass::writeHexString(const uint8_t* paramValue, uint8_t lenParamValue)
 {
 	if ((paramValue == NULL) || (lenParamValue <= 0)) return false;
 
-	this->loraStream->print(SEPARATOR);
-	for (int i = 0; i < lenParamValue; i++) {
-		this->loraStream->print(static_cast<char>(NIBBLE_TO_HEX_CHAR(HIGH_NIBBLE(paramValue[i]))));
-		this->loraStream->print(static_cast<char>(NIBBLE_TO_HEX_CHAR(LOW_NIBBLE(paramValue[i]))));
+	appendToFrame(SEPARATOR);
+	if (this->txLength + (lenParamValue * 2) > this->txSize)
+	{
+		this->txLength += lenParamValue * 2;
+		return false;
 	}
+
+	this->txLength += HexCodec::encode(paramValue, lenParamValue, (char*)&this->txFrame[this->txLength]);
+	return true;
 }
 
-uint8_t* RnRequestClass::rnUplinkRequest(const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue, uint8_t port)
+bool RnRequestClass::sendFrame()
 {
-	if (checkIsAsleep()) return NULL;
+	appendToFrame(CRLF);
 
-	if (!cmdRequest(MAC, params[TX_MAC], paramName)) return NULL;
+	// one more byte to terminate the string for debug printing
+	if (this->txLength >= this->txSize)
+	{
+		this->errorType = LORA_INVALID_DATA_LEN;
+		return false;
+	}
+	this->txFrame[this->txLength] = '\0';
+	loraDebugPrint(this->txFrame);
+
+	// a transfer started by the transmitter sends the whole frame
+	uint16_t written = 0;
+	if (this->transmitter != NULL) written = this->transmitter->transmit(this->txFrame, this->txLength) ? this->txLength : 0;
+	else written = this->transport->write(this->txFrame, this->txLength);
+#if RN_STATS
+	this->stats.bytesWritten += written;
+#endif
+	bool sent = (written == this->txLength);
+
+	// a partial command may still reach the module, which answers it with "invalid_param"
+	if (!sent) this->errorType = LORA_TRANSPORT_ERR;
+	return sent;
+}
 
-	this->loraStream->print(SEPARATOR);
-	this->loraStream->print(port);
+void RnRequestClass::setTransmitter(RnTransmitter* transmitter)
+{
+	this->transmitter = transmitter;
+}
 
+RnHandle RnRequestClass::submitUplink(const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue, uint8_t port, rnCmdCallback callback, void* context)
+{
+	uint32_t finalTimeout = getUplinkTimeout(lenParamValue, (paramName != NULL) && (strcmp(paramName, STR_CNF) == 0));
+	if (!canSubmit(finalTimeout)) return RN_INVALID_HANDLE;
+
+	if (checkIsAsleep()) return RN_INVALID_HANDLE;
+
+	if (!cmdRequest(MAC, CommandTable::name(TX_MAC), paramName)) return RN_INVALID_HANDLE;
+
+	appendToFrame(SEPARATOR);
+	appendToFrame((uint32_t)port);
 	writeHexString(paramValue, lenParamValue);
-	this->loraStream->print(CRLF);
 
-	uint8_t* response = getResponse();
-	if (response == NULL) return NULL;
+	if (!sendFrame()) return RN_INVALID_HANDLE;
 
-	return getResponse(UPLINK_TIMEOUT);
+	return beginCommand(DEFAULT_TIMEOUT, finalTimeout, callback, context);
 }
 
-uint8_t* RnRequestClass::rnRequest(uint8_t type, const char* command, const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue)
+RnHandle RnRequestClass::submitRadioTx(const uint8_t* data, uint8_t len, uint32_t finalTimeout, rnCmdCallback callback, void* context)
 {
-	if (checkIsAsleep()) return NULL;
+	if (!canSubmit(finalTimeout)) return RN_INVALID_HANDLE;
 
-	if (!cmdRequest(type, command, paramName)) return NULL;
+	if (checkIsAsleep()) return RN_INVALID_HANDLE;
 
-	writeHexString(paramValue, lenParamValue);
-	this->loraStream->print(CRLF);
+	if (!cmdRequest(RADIO, CommandTable::name(TX_RADIO), NULL)) return RN_INVALID_HANDLE;
 
-	return getResponse();
+	writeHexString(data, len);
+
+	if (!sendFrame()) return RN_INVALID_HANDLE;
+
+	return beginCommand(DEFAULT_TIMEOUT, finalTimeout, callback, context);
 }
 
-uint8_t* RnRequestClass::rnRequest(uint8_t type, const char* command, const char* paramName, const char* paramValues)
+RnHandle RnRequestClass::submitRadioRx(uint16_t rxWindow, uint32_t finalTimeout, rnCmdCallback callback, void* context)
+{
+	if (!canSubmit(finalTimeout)) return RN_INVALID_HANDLE;
+
+	if (checkIsAsleep()) return RN_INVALID_HANDLE;
+
+	if (!cmdRequest(RADIO, CommandTable::name(RX), NULL)) return RN_INVALID_HANDLE;
+
+	appendToFrame(SEPARATOR);
+	appendToFrame((uint32_t)rxWindow);
+
+	if (!sendFrame()) return RN_INVALID_HANDLE;
+
+	return beginCommand(DEFAULT_TIMEOUT, finalTimeout, callback, context);
+}
+
+RnHandle RnRequestClass::submit(uint8_t type, const char* command, const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue, rnCmdCallback callback, void* context)
+{
+	if (!canSubmit(0)) return RN_INVALID_HANDLE;
+
+	if (checkIsAsleep()) return RN_INVALID_HANDLE;
+
+	if (!cmdRequest(type, command, paramName)) return RN_INVALID_HANDLE;
+
+	if (writeHexString(paramValue, lenParamValue))
+	{
+		// the hexadecimal string just written is the value the module reads back
+		prepareCache(type, command, paramName, (char*)&this->txFrame[this->txLength - (lenParamValue * 2)], lenParamValue * 2);
+	}
+
+	if (!sendFrame()) return RN_INVALID_HANDLE;
+
+	return beginCommand(DEFAULT_TIMEOUT, 0, callback, context);
+}
+
+RnHandle RnRequestClass::submit(uint8_t type, const char* command, const char* paramName, const char* paramValues, rnCmdCallback callback, void* context)
 {
-	if (checkIsAsleep()) return NULL;
+	if (command == NULL)
+	{
+		this->errorType = LORA_INVALID_PARAM;
+		return RN_INVALID_HANDLE;
+	}
+
+	uint32_t finalTimeout = getFinalTimeoutDelay(command);
+	if (!canSubmit(finalTimeout)) return RN_INVALID_HANDLE;
 
-	if (!cmdRequest(type, command, paramName)) return NULL;
+	if (checkIsAsleep()) return RN_INVALID_HANDLE;
+
+	if (!cmdRequest(type, command, paramName)) return RN_INVALID_HANDLE;
 
 	if (paramValues != NULL)
 	{
-		this->loraStream->print(SEPARATOR);
-		this->loraStream->print(paramValues);
+		appendToFrame(SEPARATOR);
+		appendToFrame(paramValues);
 	}
+	prepareCache(type, command, paramName, paramValues, (paramValues != NULL) ? strlen(paramValues) : 0);
+
+	if (!sendFrame()) return RN_INVALID_HANDLE;
+	return beginCommand(getTimeoutDelay(command), finalTimeout, callback, context);
+}
+
+uint8_t* RnRequestClass::rnUplinkRequest(const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue, uint8_t port)
+{
+	while (isBusy()) poll();
+	return waitFor(submitUplink(paramName, paramValue, lenParamValue, port));
+}
+
+uint8_t* RnRequestClass::rnRequest(uint8_t type, const char* command, const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue)
+{
+	while (isBusy()) poll();
+	return waitFor(submit(type, command, paramName, paramValue, lenParamValue));
+}
+
+uint8_t* RnRequestClass::rnRequest(uint8_t type, const char* command, const char* paramName, const char* paramValues)
+{
+	uint8_t* response = (paramValues == NULL) ? getCachedParam(type, command, paramName) : NULL;
+	if (response != NULL) return response;
+
+	while (isBusy()) poll();
+	RnHandle handle = submit(type, command, paramName, paramValues);
+	this->getCacheIndex = CACHE_UNKNOWN;
+	return waitFor(handle);
+}
+
+uint8_t* RnRequestClass::getCachedParam(uint8_t type, const char* command, const char* paramName)
+{
+	bool bypass = this->cacheBypass;
+	this->cacheBypass = false;
+	if (!this->cacheEnabled || (command == NULL) || (strcmp(command, GET) != 0)) return NULL;
 
-	this->loraStream->print(CRLF);
+	// the position is kept for prepareCache(), when the command is sent
+	this->getCacheIndex = ParamCache::find(type, paramName);
+	if ((this->getCacheIndex == CACHE_MISS) || bypass) return NULL;
 
+	const char* value = this->cache.get(this->getCacheIndex);
+	if (value == NULL)
+	{
+#if RN_STATS
+		this->stats.cacheMisses++;
+#endif
+		return NULL;
+	}
 
-	return getResponse(getTimeoutDelay(command));
+#if RN_STATS
+	this->stats.cacheHits++;
+#endif
+	strcpy((char*)this->receiveBuffer, value);
+	this->successType = LORA_OK;
+	this->errorType = LORA_SUCCESS;
+	return this->receiveBuffer;
+}
+
+void RnRequestClass::invalidateParams(uint8_t type, const char* command, const char* paramName)
+{
+	if (strcmp(command, CommandTable::name(RESET)) == 0)
+	{
+		this->cache.invalidateAll();
+		this->linkTiming.dataRateKnown = false;
+	}
+	else if ((type == MAC) && ((strcmp(command, CommandTable::name(JOIN)) == 0) || (strcmp(command, CommandTable::name(TX_MAC)) == 0)))
+	{
+		this->cache.invalidateNetworkParams();
+	}
+	else if (strcmp(command, SET) == 0)
+	{
+		// stored again once the module accepted the new value
+		this->cache.invalidate(type, paramName);
+	}
+}
+
+void RnRequestClass::prepareCache(uint8_t type, const char* command, const char* paramName, const char* value, uint16_t len)
+{
+	if (!this->cacheEnabled || (paramName == NULL)) return;
+
+	// the response of a "get" or the value of a "set" is stored once the command succeeded
+	this->txCacheRead = (strcmp(command, GET) == 0);
+	if (this->txCacheRead && (value == NULL)) this->txCacheIndex = (this->getCacheIndex != CACHE_UNKNOWN) ? this->getCacheIndex : ParamCache::find(type, paramName);
+	else if (!this->txCacheRead && (value != NULL) && (strcmp(command, SET) == 0)) this->txCacheIndex = this->cache.stage(type, paramName, value, len);
+}
+
+void RnRequestClass::enableCache(bool enable)
+{
+	this->cacheEnabled = enable && (RN_PARAM_CACHE != 0);
+	if (!enable) this->cache.invalidateAll();
+}
+
+void RnRequestClass::invalidateCache()
+{
+	this->cache.invalidateAll();
+}
+
+void RnRequestClass::bypassCache()
+{
+	this->cacheBypass = true;
 }
 
 uint32_t RnRequestClass::getTimeoutDelay(const char* command)
@@ -124,22 +437,301 @@ uint32_t RnRequestClass::getTimeoutDelay(const char* command)
 	return (strcmp(command, "save") != 0) ? DEFAULT_TIMEOUT : SAVE_TIMEOUT;
 }
 
-uint8_t* RnRequestClass::getResponse(uint32_t timeout)
+uint32_t RnRequestClass::getFinalTimeoutDelay(const char* command)
 {
-	uint16_t len;
-	unsigned long start = millis();
+	if (strcmp(command, CommandTable::name(JOIN)) == 0) return getJoinTimeout();
+	// payload unknown, largest confirmed uplink
+	if (strcmp(command, CommandTable::name(TX_MAC)) == 0) return getUplinkTimeout(TimeOnAir::maxPayloadSize(getLinkDataRate()), true);
+	return 0;
+}
 
-	while (millis() < start + timeout) {
-		len = getReceivedData();
+eDataRate RnRequestClass::getLinkDataRate()
+{
+	// the slowest data rate gives the longest deadlines and the largest airtime
+	return this->linkTiming.dataRateKnown ? this->linkTiming.dataRate : DATA_RATE_0;
+}
 
-		if (len > 0) {
+uint32_t RnRequestClass::getUplinkTimeout(uint8_t payloadLen, bool confirmed)
+{
+	eDataRate dataRate = getLinkDataRate();
+	uint8_t nbTrans = confirmed ? 1 + this->linkTiming.retx : 1;
+
+	return TimeOnAir::uplinkTimeout(dataRate, payloadLen, nbTrans, this->linkTiming.rxDelay1, this->linkTiming.rx2DataRate);
+}
+
+uint32_t RnRequestClass::getJoinTimeout()
+{
+	return TimeOnAir::joinTimeout(getLinkDataRate(), this->linkTiming.rx2DataRate);
+}
+
+eCommandStat RnRequestClass::getCommandStat(uint8_t type, const char* command)
+{
+	switch (type)
+	{
+	case MAC:
+		if (strcmp(command, CommandTable::name(TX_MAC)) == 0) return STAT_MAC_TX;
+		if (strcmp(command, CommandTable::name(JOIN)) == 0) return STAT_MAC_JOIN;
+		if (strcmp(command, CommandTable::name(SAVE)) == 0) return STAT_MAC_SAVE;
+		return STAT_MAC_OTHER;
+	case SYS:
+		return (strcmp(command, CommandTable::name(SLEEP)) == 0) ? STAT_SYS_SLEEP : STAT_SYS_OTHER;
+	default:
+		return (strcmp(command, GET) == 0) ? STAT_RADIO_GET : STAT_RADIO_OTHER;
+	}
+}
+
+void RnRequestClass::recordStats(sRnCommand* command, eSuccessType successType, eErrorType errorType)
+{
+#if RN_STATS
+	uint32_t latency = now() - command->submitted;
+	uint8_t bucket = (latency == 0) ? 0 : 32 - __builtin_clz(latency);
+	if (bucket >= LATENCY_BUCKETS) bucket = LATENCY_BUCKETS - 1;
+
+	uint16_t* counter = &this->stats.latency[command->stat][bucket];
+	if (*counter < UINT16_MAX) (*counter)++;
+
+	counter = (errorType < RN_ERROR_TYPES) ? &this->stats.errorCount[errorType] : NULL;
+	if ((counter != NULL) && (*counter < UINT16_MAX)) (*counter)++;
+
+	counter = (successType < LORA_COUNT_SUCCESS) ? &this->stats.successCount[successType] : NULL;
+	if ((counter != NULL) && (*counter < UINT16_MAX)) (*counter)++;
+
+	if ((errorType == LORA_TIMEOUT) && (this->stats.timeoutCount < UINT16_MAX)) this->stats.timeoutCount++;
+#endif
+}
+
+void RnRequestClass::getStats(sRnStats* snapshot)
+{
+#if RN_STATS
+	memcpy(snapshot, &this->stats, sizeof(sRnStats));
+#else
+	memset(snapshot, 0, sizeof(sRnStats));
+#endif
+}
+
+void RnRequestClass::resetStats()
+{
+#if RN_STATS
+	memset(&this->stats, 0, sizeof(sRnStats));
+#endif
+}
+
+bool RnRequestClass::canSubmit(uint32_t finalTimeout)
+{
+	bool available = (this->commandCount < this->pipelineDepth);
+
+	// a command with a final response is never pipelined with other ones
+	if ((this->commandCount > 0) && ((finalTimeout != 0) || (this->commands[this->commandHead].finalTimeout != 0))) available = false;
+
+	if (!available) this->errorType = LORA_BUSY;
+	return available;
+}
+
+RnHandle RnRequestClass::beginCommand(uint32_t timeout, uint32_t finalTimeout, rnCmdCallback callback, void* context)
+{
+	if (++this->lastHandle == RN_INVALID_HANDLE) this->lastHandle++;
+
+	sRnCommand* command = &this->commands[(this->commandHead + this->commandCount) % MAX_PENDING_COMMANDS];
+	command->handle = this->lastHandle;
+	command->state = CMD_SENT;
+	command->stat = this->txStat;
+	command->start = now();
+	command->submitted = command->start;
+	command->timeout = timeout;
+	command->finalTimeout = finalTimeout;
+	command->callback = callback;
+	command->context = context;
+	command->cacheIndex = this->txCacheIndex;
+	command->cacheRead = this->txCacheRead;
+	command->versionQuery = this->txVersionQuery;
+	this->commandCount++;
+
+	return command->handle;
+}
+
+void RnRequestClass::completeCommand(eSuccessType successType, eErrorType errorType)
+{
+	// the oldest pending command is the one the response belongs to
+	sRnCommand command = this->commands[this->commandHead];
+	this->commands[this->commandHead].state = CMD_DONE;
+	this->commandHead = (this->commandHead + 1) % MAX_PENDING_COMMANDS;
+	this->commandCount--;
+
+	// the next command starts waiting once the module is done with this one
+	if (this->commandCount > 0) this->commands[this->commandHead].start = now();
+
+	this->successType = successType;
+	this->errorType = errorType;
+	recordStats(&command, successType, errorType);
+
+	if ((errorType == LORA_SUCCESS) && (command.cacheIndex != CACHE_MISS))
+	{
+		if (command.cacheRead) this->cache.store(command.cacheIndex, (char*)this->receiveBuffer, strlen((char*)this->receiveBuffer));
+		else this->cache.validate(command.cacheIndex);
+	}
+
+	// ADR or a MAC command of the downlink may have changed the settings
+	if ((command.stat == STAT_MAC_TX) || (command.stat == STAT_MAC_JOIN))
+	{
+		this->cache.invalidateNetworkParams();
+		if (this->linkTiming.adr) this->linkTiming.dataRateKnown = false;
+	}
+
+	if (command.callback != NULL)
+	{
+		uint8_t* response = (errorType == LORA_SUCCESS) ? this->receiveBuffer : NULL;
+		command.callback(command.handle, successType, errorType, response, command.context);
+	}
+}
+
+bool RnRequestClass::onResponse(eResponseToken token)
+{
+	eSuccessType successType = ResponseClassifier::getSuccessType(token);
+	eErrorType errorType = ResponseClassifier::getErrorType(token);
+
+	sRnCommand* command = &this->commands[this->commandHead];
+	if ((command->state == CMD_SENT) && (command->finalTimeout != 0) && (errorType == LORA_SUCCESS))
+	{
+		// first "ok", the final response comes after the transmission
+		command->state = CMD_WAIT_FINAL;
+		command->start = now();
+		this->txStart = command->start;
+		command->timeout = command->finalTimeout;
+		return false;
+	}
+
+	completeCommand(successType, errorType);
+	return true;
+}
+
+bool RnRequestClass::isFinalResponse(eResponseToken token)
+{
+	switch (token)
+	{
+	case RESP_MAC_TX_OK:
+	case RESP_MAC_RX:
+	case RESP_MAC_ERR:
+	case RESP_ACCEPTED:
+	case RESP_DENIED:
+	case RESP_RADIO_TX_OK:
+	case RESP_RADIO_RX:
+	case RESP_RADIO_ERR:
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool RnRequestClass::dispatchLine()
+{
+	loraDebugPrint("Rn2483 Buffer: ");
+	loraDebugPrintLn(this->receiveBuffer);
+
+	eResponseToken token = checkResponse(this->receiveBuffer);
+
+	// "RN2483 <version> <date>" is the answer of a pending "sys get ver", not a reset of the module
+	if ((token == RESP_RESET_BANNER) && (this->commandCount > 0) && this->commands[this->commandHead].versionQuery) return onResponse(token);
+
+	bool unsolicited = (this->commandCount == 0) || (token == RESP_RESET_BANNER) ||
+		(isFinalResponse(token) && (this->commands[this->commandHead].state != CMD_WAIT_FINAL));
+
+	if (this->isAsleep && (this->commandCount == 0) && (token != RESP_RESET_BANNER))
+	{
+		// response of "sys sleep": "ok" once the module woke up, or an error right away
+		this->isAsleep = false;
+		if (token != RESP_OK) this->errorType = ResponseClassifier::getErrorType(token);
+		return false;
+	}
+
+	if (unsolicited)
+	{
+		if (token == RESP_RESET_BANNER)
+		{
+			this->cache.invalidateAll();
+			this->linkTiming.dataRateKnown = false;
+		}
+		else if (token == RESP_MAC_RX) this->cache.invalidateNetworkParams();
+
+		for (int i = 0; i < MAX_EVENT_HANDLERS; i++)
+		{
+			if (this->eventHandlers[i] != NULL) this->eventHandlers[i](token, this->receiveBuffer, this->eventContexts[i]);
+		}
+
+		// the banner is also the response of "sys reset"
+		if ((token != RESP_RESET_BANNER) || (this->commandCount == 0)) return false;
+	}
+
+	return onResponse(token);
+}
+
+void RnRequestClass::poll()
+{
+	if (this->transport == NULL) return;
+
+	// stops at the line completing a command, its response stays in the receive buffer for the caller
+	while (getReceivedData() > 0)
+	{
+		if (dispatchLine()) return;
+	}
+
+	if (this->commandCount == 0) return;
+
+	sRnCommand* command = &this->commands[this->commandHead];
+	// unsigned difference, still right when the clock wraps around
+	if (now() - command->start >= command->timeout)
+	{
+		completeCommand(LORA_FAILED, LORA_TIMEOUT);
+	}
+}
+
+uint8_t* RnRequestClass::waitFor(RnHandle handle)
+{
+	if (handle == RN_INVALID_HANDLE) return NULL;
+
+	while (getCommandState(handle) != CMD_DONE) poll();
+
+	return (this->errorType == LORA_SUCCESS) ? this->receiveBuffer : NULL;
+}
+
+eCmdState RnRequestClass::getCommandState(RnHandle handle)
+{
+	for (uint8_t i = 0; i < this->commandCount; i++)
+	{
+		sRnCommand* command = &this->commands[(this->commandHead + i) % MAX_PENDING_COMMANDS];
+		if ((handle != RN_INVALID_HANDLE) && (command->handle == handle)) return command->state;
+	}
+	return CMD_DONE;
+}
+
+bool RnRequestClass::isBusy()
+{
+	return (this->commandCount > 0);
+}
+
+void RnRequestClass::setPipelineDepth(uint8_t depth)
+{
+	if (depth < 1) depth = 1;
+	if (depth > MAX_PENDING_COMMANDS) depth = MAX_PENDING_COMMANDS;
+	this->pipelineDepth = depth;
+}
+
+uint8_t RnRequestClass::getPendingCount()
+{
+	return this->commandCount;
+}
+
+uint8_t* RnRequestClass::getResponse(uint32_t timeout)
+{
+	uint32_t start = now();
+
+	while (now() - start < timeout) {
+		if (getReceivedData() > 0) {
 			loraDebugPrint("Rn2483 Buffer: ");
 			loraDebugPrintLn(this->receiveBuffer);
 			
-			this->successType = checkSuccess(this->receiveBuffer);
-			if (this->successType != LORA_FAILED) return this->receiveBuffer;
-
-			this->errorType = checkErrors(this->receiveBuffer);
+			eResponseToken token = checkResponse(this->receiveBuffer);
+			this->successType = ResponseClassifier::getSuccessType(token);
+			this->errorType = ResponseClassifier::getErrorType(token);
 
 			return (this->errorType == LORA_SUCCESS) ? this->receiveBuffer : NULL;
 		}
@@ -151,47 +743,133 @@ uint8_t* RnRequestClass::getResponse(uint32_t timeout)
 
 uint16_t RnRequestClass::getReceivedData()
 {
+	fillRing();
 	return readLn(this->receiveBuffer, DEFAULT_INPUT_BUFFER_SIZE);
 }
 
-uint16_t RnRequestClass::readLn(uint8_t* buffer, uint16_t size)
+void RnRequestClass::fillRing()
 {
-	uint16_t len = this->loraStream->readBytesUntil('\n', (uint8_t*)buffer, size);
-	if (len > 0) {
-		this->receiveBuffer[len - 1] = 0;
+	// reads straight into the free part of the ring, in two chunks when it wraps around
+	while (true)
+	{
+		uint16_t free = (this->rxTail - this->rxHead - 1) & (RX_RING_SIZE - 1);
+		uint16_t chunk = RX_RING_SIZE - this->rxHead;
+		if (chunk > free) chunk = free;
+		if (chunk == 0) break;
+
+		uint16_t len = this->transport->read(&this->rxRing[this->rxHead], chunk);
+		if (len == 0) break;
+
+		this->rxHead = (this->rxHead + len) & (RX_RING_SIZE - 1);
+#if RN_STATS
+		this->stats.bytesRead += len;
+#endif
 	}
-	return len;
 }
 
-eSuccessType RnRequestClass::checkSuccess(uint8_t* resp) {
-	int resNum = -1;
+uint16_t RnRequestClass::feed(const uint8_t* data, uint16_t len)
+{
+	uint16_t i = 0;
+	for (; i < len; i++)
+	{
+		uint16_t next = (this->rxHead + 1) & (RX_RING_SIZE - 1);
+		if (next == this->rxTail) break;
 
-	bool found = false;
-	int i = 0;
+		this->rxRing[this->rxHead] = data[i];
+		this->rxHead = next;
+	}
+	return i;
+}
 
-	while ((i <	LORA_COUNT_SUCCESS) && (!found))
+uint16_t RnRequestClass::readLn(uint8_t* buffer, uint16_t size)
+{
+	// non blocking: keeps the partial line between calls and returns its length once '\n' is received
+	while (this->rxTail != this->rxHead)
 	{
-		if (strncmp(successResponses[i], (char*)resp, strlen(successResponses[i])) == 0) found = true;
-		else i++;
+		uint8_t c = this->rxRing[this->rxTail];
+		this->rxTail = (this->rxTail + 1) & (RX_RING_SIZE - 1);
+
+		if (c == '\n')
+		{
+			if (this->rxDecode == RX_DECODE_DATA) this->rxSink->end();
+			// "mac_rx <port>" without data empties the downlink of the previous one
+			else if (this->rxDecode == RX_DECODE_PORT)
+			{
+				this->downlinkSink->begin((uint8_t)atoi((char*)&buffer[7]));
+				this->downlinkSink->end();
+			}
+			this->rxDecode = RX_DECODE_NONE;
+
+			uint16_t len = this->receiveLength;
+			if ((len > 0) && (buffer[len - 1] == '\r')) len--;
+			buffer[len] = 0;
+			this->receiveLength = 0;
+			return len + 1;
+		}
+
+		if (this->rxDecode == RX_DECODE_DATA)
+		{
+			// "radio_rx" is followed by two spaces
+			if ((c != '\r') && (c != ' ')) this->rxSink->write(c);
+			continue;
+		}
+
+		if (this->receiveLength < size - 1) buffer[this->receiveLength++] = c;
+
+		// "mac_rx <port> <data>": the data goes straight to the downlink, the line keeps "mac_rx <port>"
+		if ((this->rxDecode == RX_DECODE_NONE) && (this->downlinkSink != NULL) && (this->receiveLength == 7) && (strncmp((char*)buffer, "mac_rx ", 7) == 0))
+		{
+			this->rxDecode = RX_DECODE_PORT;
+		}
+		else if ((this->rxDecode == RX_DECODE_PORT) && (c == ' '))
+		{
+			buffer[--this->receiveLength] = 0;
+			this->rxSink = this->downlinkSink;
+			this->rxSink->begin((uint8_t)atoi((char*)&buffer[7]));
+			this->rxDecode = RX_DECODE_DATA;
+		}
+		// "radio_rx  <data>": same for the packets received in P2P mode, the line keeps "radio_rx "
+		else if ((this->rxDecode == RX_DECODE_NONE) && (this->radioSink != NULL) && (this->receiveLength == 9) && (strncmp((char*)buffer, "radio_rx ", 9) == 0))
+		{
+			this->rxSink = this->radioSink;
+			this->rxSink->begin(0);
+			this->rxDecode = RX_DECODE_DATA;
+		}
 	}
+	return 0;
+}
 
-	return (found ? (eSuccessType)i : LORA_FAILED);
+bool RnRequestClass::addEventHandler(rnEventHandler handler, void* context)
+{
+	for (int i = 0; i < MAX_EVENT_HANDLERS; i++)
+	{
+		if (this->eventHandlers[i] == NULL)
+		{
+			this->eventContexts[i] = context;
+			this->eventHandlers[i] = handler;
+			return true;
+		}
+	}
+	return false;
 }
 
-eErrorType RnRequestClass::checkErrors(uint8_t* resp) {
-	int resNum = -1;
+void RnRequestClass::removeEventHandler(rnEventHandler handler)
+{
+	for (int i = 0; i < MAX_EVENT_HANDLERS; i++)
+	{
+		if (this->eventHandlers[i] == handler) this->eventHandlers[i] = NULL;
+	}
+}
 
-	bool found = false;
-	int i = 0;
+eResponseToken RnRequestClass::checkResponse(uint8_t* resp)
+{
+	this->responseToken = ResponseClassifier::classify((char*)resp);
 
-	while ((i <	LORA_COUNT_ERRORS) && (!found))
+	if (ResponseClassifier::getErrorType(this->responseToken) != LORA_SUCCESS)
 	{
-		if (strcmp((char*)resp, possibleResponses[i]) == 0) found = true;
-		else i++;
+		loraDebugPrint("Response : "); loraDebugPrint(resp); loraDebugPrintLn(" received during execution !");
 	}
-
-	loraDebugPrint("Response : "); loraDebugPrint(resp); loraDebugPrintLn(" received during execution !");
-	return (found ? (eErrorType)i : LORA_SUCCESS);
+	return this->responseToken;
 }
 
 eSuccessType RnRequestClass::getLastSuccess()
@@ -209,36 +887,58 @@ void RnRequestClass::setLastError(eErrorType errorType)
 	this->errorType = errorType;
 }
 
+bool RnRequestClass::sleep(uint32_t duration)
+{
+	while (isBusy()) poll();
+
+	if (checkIsAsleep()) return false;
+
+	if (!cmdRequest(SYS, CommandTable::name(SLEEP), NULL)) return false;
+
+	appendToFrame(SEPARATOR);
+	appendToFrame(duration);
+	if (!sendFrame()) return false;
+
+	// no command is pending: the "ok" comes when the module wakes up and is caught by dispatchLine()
+	this->sleepStart = now();
+	this->sleepDuration = duration;
+	this->isAsleep = true;
+	return true;
+}
+
 bool RnRequestClass::checkIsAsleep()
 {
-	if (!isAsleep) return false;
-	
-	if (getResponse() == NULL)
+	if (!this->isAsleep) return false;
+
+	poll();
+	if (!this->isAsleep) return false;
+
+	// without its "ok", the module is considered awake once the requested duration is over,
+	// with a margin for the drift of its clock
+	uint32_t deadline = this->sleepDuration + (this->sleepDuration / 32) + SLEEP_WAKE_MARGIN;
+	if (now() - this->sleepStart >= deadline)
 	{
-		this->errorType = LORA_SLEEP;
-		return true;
+		this->isAsleep = false;
+		return false;
 	}
-	
-	isAsleep = false;
 
-	return isAsleep;
+	this->errorType = LORA_SLEEP;
+	return true;
 }
 
 void RnRequestClass::setBreakCondition()
 {
-	// "emulate" break condition
-	this->loraStream->flush();
-
-	this->loraStream->begin(300);
-	this->loraStream->write((uint8_t)0x00);
-	this->loraStream->flush();
+	this->transport->sendBreak();
 }
 
 void RnRequestClass::setWakeupFlag()
 {
-	this->loraStream->begin(57600);
-	this->loraStream->write((uint8_t)0x55);
-	this->loraStream->flush();
-
-	RnRequest.getResponse();
+	// autobaud detection of the module
+	const uint8_t sync = 0x55;
+	uint16_t written = this->transport->write(&sync, 1);
+#if RN_STATS
+	this->stats.bytesWritten += written;
+#endif
+
+	getResponse();
 }
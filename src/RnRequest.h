@@ -28,77 +28,158 @@
 
 #include "InternalConstForRN2483.h"
 #include "ConstOrangeForRN2483.h"
+#include "ResponseClassifier.h"
+#include "CommandTable.h"
+#include "TimeOnAir.h"
+#include "RnTransport.h"
+#include "UartTransport.h"
+#include "TraceRecorder.h"
+#include "ParamCache.h"
+#include "DownlinkMessage.h"
 
-#if defined(ARDUINO_ARCH_AVR)
-typedef HardwareSerial SerialType;
-#define ENABLE_SLEEP
-#elif defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
-typedef Uart SerialType;
-#define ENABLE_SLEEP
-#else
-typedef Stream SerialType;
-#endif
+/**
+* \brief     Different states of a command handled by the asynchronous command engine
+* \details   A command goes from \e CMD_SENT to \e CMD_DONE, through \e CMD_WAIT_FINAL when the module
+*			 sends a second response after its first "ok" (mac tx, mac join)
+*/
+typedef enum _eCmdState {
+	CMD_FREE = 0,							// No command submitted
+	CMD_SENT,								// Command written, waiting for the first response
+	CMD_WAIT_FINAL,							// First response received, waiting for the final one
+	CMD_DONE								// Response received or timeout, result is available
+}eCmdState;
+
+/**
+* \brief     Progress of the line reader through a "mac_rx <port> <data>" line
+* \details   The data is decoded into the DownlinkMessage as it is received, instead of being kept as a string
+*/
+typedef enum _eRxDecode {
+	RX_DECODE_NONE = 0,						// Not a downlink line, or not far enough to know
+	RX_DECODE_PORT,							// "mac_rx " received, reading the port
+	RX_DECODE_DATA							// Decoding the data
+}eRxDecode;
+
+/**
+* \brief     Handle identifying a command submitted to the asynchronous command engine
+*/
+typedef uint8_t RnHandle;
+
+#define RN_INVALID_HANDLE				0
+
+/**
+* \brief     Completion callback of an asynchronous command
+* \details   Called from \e poll() once the command is done. \e response points to the received line,
+*			 or is NULL when the module answered with an error or did not answer in time
+*/
+typedef void(*rnCmdCallback)(RnHandle handle, eSuccessType successType, eErrorType errorType, uint8_t* response, void* context);
 
 /**
-* \brief     Different kind of commands which could be sent to the Rn2483 module
-* \details   Each of these values is used to find the correct string value in the \e commandType attribute of the class
+* \brief     Handler of the lines sent by the module while no command is waiting for them
+* \details   Typically a late "mac_rx", a "mac_err" or the banner sent after a reset. \e line points to the
+*			 receive buffer of the RnRequestClass object and is only valid during the call
 */
-typedef enum _typecmd {
-	MAC = 0,
-	SYS,
-	RADIO,
-	COUNT_TYPE
-}eTypeCommand;
+typedef void(*rnEventHandler)(eResponseToken token, uint8_t* line, void* context);
 
 /**
-* \brief     Different kind of MAC commands
-* \details   Each of these values is used to find the correct string value in the \e params attribute of the class
+* \brief     Clock used for the timeouts and the statistics, in ms
+* \details   millis() by default, TraceReplayer::clock during a playback
 */
-typedef enum _paramMac {
-	DEVADDR = 0,
-	DEVEUI,
-	APPEUI,
-	BAND,
-	DATARATE,
-	PWR_IND_VAL,
-	ADR,
-	RETRANS_NB,
-	RX_DELAY_1,
-	RX_DELAY_2,
-	AUTO_REPLY,
-	RX2,
-	D_CYCLE_PS,
-	DEMOD_MARGIN,
-	GATEWAY_NB,
-	STATUS,
-	SYNC,
-	UP_CTR,
-	DWN_CTR,
-	NWKS_KEY,
-	APPS_KEY,
-	APP_KEY,
-	JOIN,
-	TX_MAC,
-	BAT_LVL,
-	LINK_CHECK,
-	SAVE,
-	PAUSE,
-	RESUME,
-	COUNT_PARAM_MAC
-}eParamMac;
+typedef uint32_t(*rnClock)(void* context);
 
 /**
-* \brief     Different kind of success message
-* \details   Each of these values is used to find the correct string value in the \e successResponses attribute of the class
+* \brief     Kinds of commands the latency statistics are gathered for
 */
-typedef enum _eSuccessType {
-	LORA_OK = 0,
-	LORA_MAC_TX_OK,
-	LORA_ACCEPTED,
-	LORA_RX,
-	LORA_COUNT_SUCCESS,
-	LORA_FAILED,
-}eSuccessType;
+typedef enum _eCommandStat {
+	STAT_MAC_TX = 0,
+	STAT_MAC_JOIN,
+	STAT_MAC_SAVE,
+	STAT_MAC_OTHER,							// mac get, mac set...
+	STAT_SYS_SLEEP,
+	STAT_SYS_OTHER,
+	STAT_RADIO_GET,
+	STAT_RADIO_OTHER,
+	STAT_COUNT
+}eCommandStat;
+
+#define RN_ERROR_TYPES					(LORA_TRANSPORT_ERR + 1)
+
+/**
+* \brief     Statistics of the exchanges with the module
+* \details   \e latency[kind][i] counts the commands completed in [2^(i-1), 2^i[ ms, from the submission to the
+*			 final response. Counters stop at their maximum value instead of wrapping around
+*/
+typedef struct _sRnStats {
+	uint16_t latency[STAT_COUNT][LATENCY_BUCKETS];
+	uint16_t successCount[LORA_COUNT_SUCCESS];
+	uint16_t errorCount[RN_ERROR_TYPES];
+	uint16_t timeoutCount;
+	uint32_t bytesWritten;
+	uint32_t bytesRead;
+	uint32_t cacheHits;						// Getters answered from the parameter cache
+	uint32_t cacheMisses;					// Getters of a cached parameter sent to the module
+}sRnStats;
+
+/**
+* \brief     Command handled by the asynchronous command engine
+*/
+typedef struct _sRnCommand {
+	RnHandle handle;
+	eCmdState state;
+	eCommandStat stat;
+	uint32_t submitted;					// Submission time, for the latency statistics
+	uint32_t start;						// Start of the current waiting stage
+	uint32_t timeout;						// Timeout of the current waiting stage
+	uint32_t finalTimeout;					// Timeout of the final response, 0 if only one response is expected
+	int8_t cacheIndex;						// Parameter read or written, CACHE_MISS if not cached
+	bool cacheRead;
+	bool versionQuery;						// "sys get ver", answered with a line looking like the reset banner
+	rnCmdCallback callback;
+	void* context;
+}sRnCommand;
+
+/**
+* \brief     Radio settings of the module the deadlines of "mac tx" and "mac join" depend on
+* \details   Kept up to date by the OrangeForRN2483Class setters and getters. The data rate is unknown until
+*			 it is set or read, again after a reset of the module and after each uplink or join while ADR is on.
+*			 The slowest one is assumed while it is unknown
+*/
+typedef struct _sLinkTiming {
+	eDataRate dataRate;
+	bool dataRateKnown;
+	eDataRate rx2DataRate;
+	uint16_t rxDelay1;
+	uint8_t retx;
+	bool adr;
+}sLinkTiming;
+
+/**
+* \brief     Interface handing the framed commands over to the UART
+* \details   The default implementation frames the commands in a buffer of the RnRequestClass object and writes it
+*			 with a single call to the stream. A DMA capable transmitter can provide its own buffers from \e acquire()
+*			 and start the transfer from \e transmit() without copying them. Without transmitter, the frame is
+*			 written to the RnTransport
+*/
+class RnTransmitter
+{
+public:
+	virtual ~RnTransmitter() {}
+
+	/**
+	* @brief		Getter on the buffer used to frame the next command
+	* @details		The buffer must stay valid until the transfer started by \e transmit() is over
+	* @param		size		Pointer on an uint16_t value to receive the size of the buffer
+	* @return		Pointer on the buffer, NULL if no buffer is available
+	*/
+	virtual uint8_t* acquire(uint16_t* size) = 0;
+
+	/**
+	* @brief		Sending a framed command
+	* @param		buffer		Buffer returned by \e acquire(), containing the command and its CRLF
+	* @param		length		Number of bytes to send
+	* @return		Boolean value, true if the transfer was started
+	*/
+	virtual bool transmit(uint8_t* buffer, uint16_t length) = 0;
+};
 
 class RnRequestClass
 {
@@ -106,91 +187,108 @@ public:
 	friend class OrangeForRN2483Class;
 	friend class RadioCmdsClass;
 	friend class SysCmdsClass;
+	friend class UplinkQueue;
+	friend class ReliableSender;
+	friend class P2PLink;
 
 protected:
-	SerialType* loraStream;
+	RnTransport* transport;
+	RnTransmitter* transmitter;
+	TraceRecorder recorder;
+	rnClock clock;
+	void* clockContext;
+	uint32_t clockOffset;					// Time millis() was stopped, in standby
+
+	uint8_t txBuffer[DEFAULT_OUTPUT_BUFFER_SIZE];
+	uint8_t* txFrame;
+	uint16_t txSize;
+	uint16_t txLength;
+
+	uint8_t rxRing[RX_RING_SIZE];
+	volatile uint16_t rxHead;
+	volatile uint16_t rxTail;
 
 	uint8_t receiveBuffer[DEFAULT_INPUT_BUFFER_SIZE];
+	uint16_t receiveLength;
+	DownlinkSink* downlinkSink;
+	DownlinkSink* radioSink;
+	DownlinkSink* rxSink;				// Sink of the line being decoded
+	eRxDecode rxDecode;
+
+	rnEventHandler eventHandlers[MAX_EVENT_HANDLERS];
+	void* eventContexts[MAX_EVENT_HANDLERS];
+	sRnCommand commands[MAX_PENDING_COMMANDS];
+	uint8_t commandHead;
+	uint8_t commandCount;
+	uint8_t pipelineDepth;
+	RnHandle lastHandle;
+	sLinkTiming linkTiming;
+	uint32_t txStart;						// Time of the "ok" of the last transmission, which starts right after
+	ParamCache cache;
+	bool cacheEnabled;
+	bool cacheBypass;						// The next getter reads the module
+	int8_t getCacheIndex;					// Position found by getCachedParam() for the "get" it sends
+	int8_t txCacheIndex;
+	bool txCacheRead;
+	bool txVersionQuery;
+#if RN_STATS
+	sRnStats stats;
+#endif
+	eCommandStat txStat;
+	eResponseToken responseToken;
 	eSuccessType successType;
 	eErrorType errorType;
 	bool isAsleep;
-
-	const char* params[COUNT_PARAM_MAC] = {
-		"devaddr",
-		"deveui",
-		"appeui",
-		"band",
-		"dr",
-		"pwridx",
-		"adr",
-		"retx",
-		"rxdelay1",
-		"rxdelay2",
-		"ar",
-		"rx2",
-		"dcycleps",
-		"mrgn",
-		"gwnb",
-		"status",
-		"sync",
-		"upctr",
-		"dnctr",
-		"nwkskey",
-		"appskey",
-		"appkey",
-		"join",
-		"tx",
-		"bat",
-		"linkchk",
-		"save",
-		"pause",
-		"resume"
-	};
-
-	const char* commandType[COUNT_TYPE] = { "mac", "sys", "radio" };
-
-	const char* successResponses[LORA_COUNT_SUCCESS] = { "ok",
-		"mac_tx_ok",
-		"accepted",
-		"mac_rx"
-	};
-
-	const char* possibleResponses[LORA_COUNT_ERRORS] = {"invalid_param",
-		"keys_not_init",
-		"no_free_ch",
-		"silent",
-		"busy",
-		"mac_paused",
-		"denied",
-		"invalid_data_len",
-		"frame_counter_err_rejoin_needed"
-	};
+	uint32_t sleepStart;
+	uint32_t sleepDuration;
 
 	uint16_t getReceivedData();
 
 	uint16_t readLn(uint8_t* buffer, uint16_t size);
+	void fillRing();
+	bool dispatchLine();
+	bool isFinalResponse(eResponseToken token);
 
-	eErrorType checkErrors(uint8_t* resp);
 
 	bool isStreamInit();
+	uint32_t now();
+	void advanceClock(uint32_t elapsed);
+	eDataRate getLinkDataRate();
 
 	void init();
 
 	bool writeHexString(const uint8_t* paramValue, uint8_t lenParamValue);
 	bool cmdRequest(uint8_t type, const char* command, const char* paramName);
+	bool appendToFrame(const char* str);
+	bool appendToFrame(uint32_t value);
+	bool sendFrame();
+
+	eCommandStat getCommandStat(uint8_t type, const char* command);
+	void invalidateParams(uint8_t type, const char* command, const char* paramName);
+	uint8_t* getCachedParam(uint8_t type, const char* command, const char* paramName);
+	void prepareCache(uint8_t type, const char* command, const char* paramName, const char* value, uint16_t len);
+	void recordStats(sRnCommand* command, eSuccessType successType, eErrorType errorType);
+
+	bool canSubmit(uint32_t finalTimeout);
+	RnHandle beginCommand(uint32_t timeout, uint32_t finalTimeout, rnCmdCallback callback, void* context);
+	void completeCommand(eSuccessType successType, eErrorType errorType);
+	bool onResponse(eResponseToken token);
+	uint8_t* waitFor(RnHandle handle);
 
 	uint8_t* rnRequest(uint8_t type, const char* command, const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue);
 	uint8_t* rnUplinkRequest(const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue, uint8_t port);
 	uint8_t* rnRequest(uint8_t type, const char* command, const char* paramName = NULL, const char* paramValues = NULL);
 
 	uint32_t getTimeoutDelay(const char* command);
+	uint32_t getFinalTimeoutDelay(const char* command);
 	uint8_t* getResponse(uint32_t timeout = DEFAULT_TIMEOUT);
 	
 	eSuccessType getLastSuccess();
 	eErrorType getLastError();
 	void setLastError(eErrorType errorType);
 	
-	eSuccessType checkSuccess(uint8_t* resp);
+	eResponseToken checkResponse(uint8_t* resp);
+	bool sleep(uint32_t duration);
 	bool checkIsAsleep();
 	void setBreakCondition();
 	void setWakeupFlag();
@@ -206,6 +304,237 @@ public:
 	* @details		Used to delete an RnRequestClass instance
 	*/
 	virtual ~RnRequestClass();
+
+	/**
+	* @brief		Initialization of the communication with the module through a given transport
+	* @details		\e init() without parameter uses Serial2 at 57600 bauds
+	* @param		transport		Transport connected to the module, already opened
+	*/
+	void init(RnTransport* transport);
+
+	/**
+	* @brief		Submitting a command without waiting for its response
+	* @details		The command "<type> <command> <paramName> <paramValues>" is written to the module and the
+	*				function returns immediately. The command is then driven by \e poll()
+	* @param		type			eTypeCommand value representing the kind of command (\e MAC, \e SYS or \e RADIO)
+	* @param		command			String value representing the command (get, set, join...)
+	* @param		paramName		String value representing the parameter name, or NULL
+	* @param		paramValues		String value representing the parameter values, or NULL
+	* @param		callback		Function called when the command is done, or NULL
+	* @param		context			Pointer given back to the callback
+	* @return		Handle of the command, \e RN_INVALID_HANDLE if it could not be sent (see getLastError())
+	*/
+	RnHandle submit(uint8_t type, const char* command, const char* paramName, const char* paramValues, rnCmdCallback callback = NULL, void* context = NULL);
+
+	/**
+	* @brief		Submitting a command with an hexadecimal parameter without waiting for its response
+	* @details		Same as the previous method, the parameter value being written as an hexadecimal string
+	* @param		type			eTypeCommand value representing the kind of command (\e MAC, \e SYS or \e RADIO)
+	* @param		command			String value representing the command (get, set...)
+	* @param		paramName		String value representing the parameter name
+	* @param		paramValue		Byte array written as an hexadecimal string
+	* @param		lenParamValue	Size of the byte array
+	* @param		callback		Function called when the command is done, or NULL
+	* @param		context			Pointer given back to the callback
+	* @return		Handle of the command, \e RN_INVALID_HANDLE if it could not be sent (see getLastError())
+	*/
+	RnHandle submit(uint8_t type, const char* command, const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue, rnCmdCallback callback = NULL, void* context = NULL);
+
+	/**
+	* @brief		Submitting an uplink without waiting for its response
+	* @details		Writes a "mac tx <paramName> <port> <data>" command. The command is done once the module
+	*				has sent its final response (mac_tx_ok, mac_rx...)
+	* @param		paramName		String value representing the uplink type (\e cnf or \e uncnf)
+	* @param		paramValue		Byte array representing the payload
+	* @param		lenParamValue	Size of the payload
+	* @param		port			Port to use
+	* @param		callback		Function called when the command is done, or NULL
+	* @param		context			Pointer given back to the callback
+	* @return		Handle of the command, \e RN_INVALID_HANDLE if it could not be sent (see getLastError())
+	*/
+	RnHandle submitUplink(const char* paramName, const uint8_t* paramValue, uint8_t lenParamValue, uint8_t port, rnCmdCallback callback = NULL, void* context = NULL);
+
+	/**
+	* @brief		Submitting a raw LoRa packet without waiting for its response
+	* @details		Writes a "radio tx <data>" command, the MAC being paused. The command is done once the module
+	*				has sent its final response (radio_tx_ok or radio_err)
+	* @param		data			Byte array representing the packet
+	* @param		len				Size of the packet
+	* @param		finalTimeout	Delay of the final response in ms, from the time on air with the current radio settings
+	* @param		callback		Function called when the command is done, or NULL
+	* @param		context			Pointer given back to the callback
+	* @return		Handle of the command, \e RN_INVALID_HANDLE if it could not be sent (see getLastError())
+	*/
+	RnHandle submitRadioTx(const uint8_t* data, uint8_t len, uint32_t finalTimeout, rnCmdCallback callback = NULL, void* context = NULL);
+
+	/**
+	* @brief		Submitting a raw LoRa reception without waiting for its response
+	* @details		Writes a "radio rx <rxWindow>" command, the MAC being paused. The command is done with the
+	*				final response: "radio_rx" once a packet is received, or "radio_err" when the radio watchdog
+	*				expires. The packet is decoded into the sink set by \e setRadioSink()
+	* @param		rxWindow		Number of symbols to listen for, 0 to listen until the watchdog expires
+	* @param		finalTimeout	Delay of the final response in ms, longer than the radio watchdog
+	* @param		callback		Function called when the command is done, or NULL
+	* @param		context			Pointer given back to the callback
+	* @return		Handle of the command, \e RN_INVALID_HANDLE if it could not be sent (see getLastError())
+	*/
+	RnHandle submitRadioRx(uint16_t rxWindow, uint32_t finalTimeout, rnCmdCallback callback = NULL, void* context = NULL);
+
+	/**
+	* @brief		Driving the submitted command
+	* @details		Must be called regularly, typically from loop(). Reads the available bytes from the module
+	*				without blocking, advances the state of the current command and calls its callback once done.
+	*				Unsolicited lines are dispatched to the handlers registered with \e addEventHandler()
+	*/
+	void poll();
+
+	/**
+	* @brief		Getter on the state of a submitted command
+	* @param		handle		Handle returned by a submit method
+	* @return		eCmdState value, \e CMD_DONE for a command which is no longer pending
+	*/
+	eCmdState getCommandState(RnHandle handle);
+
+	/**
+	* @brief		Check if a command is waiting for a response
+	* @return		Boolean value, true if at least one command is in progress
+	*/
+	bool isBusy();
+
+	/**
+	* @brief		Setter for the number of commands sent without waiting for the previous responses
+	* @details		Responses are matched with the pending commands in the order they were sent. Commands
+	*				with two responses (mac tx, mac join) are never pipelined with other commands
+	* @param		depth		Maximum number of pending commands, from 1 to \e MAX_PENDING_COMMANDS
+	*/
+	void setPipelineDepth(uint8_t depth);
+
+	/**
+	* @brief		Getter on the number of commands waiting for a response
+	* @return		Decimal number, from 0 to the pipeline depth
+	*/
+	uint8_t getPendingCount();
+
+	/**
+	* @brief		Getter on the delay of the final response of an uplink
+	* @details		Computed from the time on air of the uplink at the current data rate, the receive windows
+	*				and, for a confirmed uplink, the retransmissions
+	* @param		payloadLen		Size of the payload in bytes
+	* @param		confirmed		Boolean value, true for a confirmed uplink
+	* @return		Duration in milliseconds
+	*/
+	uint32_t getUplinkTimeout(uint8_t payloadLen, bool confirmed);
+
+	/**
+	* @brief		Getter on the delay of the final response of a join request
+	* @return		Duration in milliseconds
+	*/
+	uint32_t getJoinTimeout();
+
+	/**
+	* @brief		Getter on the statistics of the exchanges with the module
+	* @details		Gathered since the start or the last call to \e resetStats(), typically sent in a periodic
+	*				diagnostic uplink. All the statistics are 0 unless the library is built with RN_STATS set to 1
+	* @param		snapshot		Pointer on the structure receiving a copy of the statistics
+	*/
+	void getStats(sRnStats* snapshot);
+
+	/**
+	* @brief		Resetting all the statistics to 0
+	*/
+	void resetStats();
+
+	/**
+	* @brief		Enabling or disabling the parameter cache
+	* @details		Enabled by default when the library is built with RN_PARAM_CACHE set to 1: the values read from or
+	*				written to the module are kept, and reading them again does not send any command. Disabled, every
+	*				getter reads the value from the module. Without RN_PARAM_CACHE, the cache stays disabled
+	* @param		enable			Boolean value, false to always read the parameters from the module
+	*/
+	void enableCache(bool enable = true);
+
+	/**
+	* @brief		Emptying the parameter cache
+	* @details		To call after changing the configuration of the module without this library
+	*/
+	void invalidateCache();
+
+	/**
+	* @brief		Reading the next parameter from the module
+	* @details		The next blocking getter sends its command even if the value is cached, and caches the
+	*				value received. Any other command cancels the bypass
+	*/
+	void bypassCache();
+
+	/**
+	* @brief		Starting to record the exchanges with the module
+	* @details		Every byte written and read from now on is written to \e sink as a binary trace, see TraceRecorder.h
+	* @param		sink			Destination of the trace (SD card file, SerialUSB...)
+	* @return		Boolean value, false if the transport is not initialized or a recording is in progress
+	*/
+	bool startRecording(Print* sink);
+
+	/**
+	* @brief		Stopping the recording started by \e startRecording()
+	* @return		Decimal number representing the size of the recorded trace
+	*/
+	uint32_t stopRecording();
+
+	/**
+	* @brief		Setter for the clock used for the timeouts and the statistics
+	* @param		clock			Function returning the time in ms, NULL for millis()
+	* @param		context			Pointer given back to the clock
+	*/
+	void setClock(rnClock clock, void* context = NULL);
+
+	/**
+	* @brief		Setter for the object receiving the data of the downlinks
+	* @details		The hexadecimal data of a "mac_rx" line is decoded into it as it is received, the line then
+	*				only holds "mac_rx <port>". Without it, the data stays in the line and is cut to its size
+	* @param		downlink		DownlinkSink object, or NULL
+	*/
+	void setDownlinkSink(DownlinkSink* downlink);
+
+	/**
+	* @brief		Setter for the object receiving the packets of "radio rx"
+	* @details		The hexadecimal data of a "radio_rx" line is decoded into it as it is received, the line then
+	*				only holds "radio_rx ". Without it, the data stays in the line and is cut to its size
+	* @param		packet			DownlinkSink object, or NULL
+	*/
+	void setRadioSink(DownlinkSink* packet);
+
+	/**
+	* @brief		Setter for the transmitter of the framed commands
+	* @param		transmitter		Pointer on the transmitter, NULL to write the commands to the stream
+	*/
+	void setTransmitter(RnTransmitter* transmitter);
+
+	/**
+	* @brief		Pushing bytes received from the module
+	* @details		The bytes are stored in the receive ring buffer read by \e poll(). The stream is read by
+	*				\e poll() itself, this function is meant for other sources such as a DMA transfer
+	* @param		data		Received bytes
+	* @param		len			Number of received bytes
+	* @return		Decimal number representing the number of bytes stored, lower than \e len if the ring is full
+	*/
+	uint16_t feed(const uint8_t* data, uint16_t len);
+
+	/**
+	* @brief		Registering a handler for the unsolicited lines sent by the module
+	* @details		A line is unsolicited when no command is waiting for a response, or when it is a final
+	*				response (mac_rx, mac_err...) while no command is waiting for one. The reset banner is
+	*				always dispatched to the handlers
+	* @param		handler		Function called from \e poll() for each unsolicited line
+	* @param		context		Pointer given back to the handler
+	* @return		Boolean value, false if \e MAX_EVENT_HANDLERS handlers are already registered
+	*/
+	bool addEventHandler(rnEventHandler handler, void* context = NULL);
+
+	/**
+	* @brief		Unregistering a handler registered with \e addEventHandler()
+	* @param		handler		Function to unregister
+	*/
+	void removeEventHandler(rnEventHandler handler);
 };
 
 extern RnRequestClass RnRequest;
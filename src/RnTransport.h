@@ -0,0 +1,62 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			RnTransport.h
+* @brief		Interface of the link between the library and the module
+* @details		RnRequestClass only talks to the module through this interface. UartTransport wraps an
+*				Arduino UART, TermiosTransport a serial port of a Linux host and LoopbackTransport an in
+*				memory buffer standing for the module.
+*/
+
+#ifndef _RN_TRANSPORT_H
+#define _RN_TRANSPORT_H
+
+#include <Arduino.h>
+
+class RnTransport
+{
+public:
+	virtual ~RnTransport() {}
+
+	/**
+	* @brief		Getter on the number of received bytes waiting to be read
+	* @return		Decimal number, 0 if nothing was received
+	*/
+	virtual int available() = 0;
+
+	/**
+	* @brief		Reading the received bytes without blocking
+	* @param		buffer		Buffer receiving the bytes
+	* @param		size		Size of the buffer
+	* @return		Decimal number representing the number of bytes read, 0 if nothing was received
+	*/
+	virtual uint16_t read(uint8_t* buffer, uint16_t size) = 0;
+
+	/**
+	* @brief		Writing bytes to the module
+	* @details		Returns once the bytes are queued for sending, without waiting for the end of the transfer
+	* @param		data		Bytes to write
+	* @param		len			Number of bytes to write
+	* @return		Decimal number representing the number of bytes queued, lower than \e len on error
+	*/
+	virtual uint16_t write(const uint8_t* data, uint16_t len) = 0;
+
+	/**
+	* @brief		Sending a break condition on the line
+	* @details		Used to wake the module up, the baudrate is the communication one again once the function returns
+	*/
+	virtual void sendBreak() = 0;
+};
+
+#endif
@@ -17,85 +17,91 @@
 
 #include "SysCmds.h"
 #include "RnRequest.h"
+#include "NumberParser.h"
+
+SysCmdsClass::SysCmdsClass(RnRequestClass* request)
+{
+	this->request = request;
+}
 
 //Getters
 String SysCmdsClass::getVersion()
 {
-	return String((char*)RnRequest.rnRequest(SYS, GET, params[VERSION]));
+	return String((char*)this->request->rnRequest(SYS, GET, CommandTable::name(VERSION)));
 }
 
 String SysCmdsClass::getNvm(uint8_t address[2])
 {
-	return String((char*)RnRequest.rnRequest(SYS, GET, params[NVM], address, 2));
+	return String((char*)this->request->rnRequest(SYS, GET, CommandTable::name(NVM), address, 2));
 }
 
 bool SysCmdsClass::setNvm(uint8_t address[2], uint8_t data[1])
 {
 //	int8_t temp[4] = { address[0], address[1], -1, data[0] };
-//	return !isEmpty(RnRequest.rnRequest(SYS, SET, params[NVM], temp, 4));
+//	return !isEmpty(this->request->rnRequest(SYS, SET, CommandTable::name(NVM), temp, 4));
 	return false;
 }
 
 String SysCmdsClass::getHardwareDevEUI()
 {
-	uint8_t* data = RnRequest.rnRequest(SYS, GET, params[HWEUI]);
+	uint8_t* data = this->request->rnRequest(SYS, GET, CommandTable::name(HWEUI));
 	return String((char*)data);
 }
 
 String SysCmdsClass::getPindig(String pinname)
 {
-	return String((char*)RnRequest.rnRequest(SYS, GET, params[PIN_DIG], pinname.c_str()));
+	return String((char*)this->request->rnRequest(SYS, GET, CommandTable::name(PIN_DIG), pinname.c_str()));
 }
 
 bool SysCmdsClass::sleep(uint32_t delay)
 {	
-	RnRequest.isAsleep = (RnRequest.rnRequest(SYS, params[SLEEP], String(delay).c_str()) == NULL);
-	return RnRequest.isAsleep;
+	return this->request->sleep(delay);
 }
 
 bool SysCmdsClass::isAsleep()
 {
-	return RnRequest.checkIsAsleep();
+	return this->request->checkIsAsleep();
 }
 
 bool SysCmdsClass::setPinDig(String pinname, String pinstate)
 {
 	String pinDig = pinname + SEPARATOR + pinstate;
-	return (RnRequest.rnRequest(SYS, SET, params[PIN_DIG], pinDig.c_str()) != NULL);
+	return (this->request->rnRequest(SYS, SET, CommandTable::name(PIN_DIG), pinDig.c_str()) != NULL);
 }
 
 String SysCmdsClass::getPinana(String pinname)
 {
-	return String((char*)RnRequest.rnRequest(SYS, GET, params[PIN_ANA], pinname.c_str()));
+	return String((char*)this->request->rnRequest(SYS, GET, CommandTable::name(PIN_ANA), pinname.c_str()));
 }
 
 int16_t SysCmdsClass::getVdd()
 {
-	uint8_t* response = RnRequest.rnRequest(SYS, GET, params[VDD]);
-	return (response != NULL) ? String((char*)response).toInt() : INT_ERROR_FAILED;
+	uint8_t* response = this->request->rnRequest(SYS, GET, CommandTable::name(VDD));
+	int32_t value;
+	return ((response != NULL) && NumberParser::parseInt((char*)response, &value)) ? value : INT_ERROR_FAILED;
 }
 
 bool SysCmdsClass::setPinMode(String pinname, String pinfunc)
 {
 	String pinMode = pinname + SEPARATOR + pinfunc;
-	return (RnRequest.rnRequest(SYS, SET, params[PIN_MODE], pinMode.c_str()) != NULL);
+	return (this->request->rnRequest(SYS, SET, CommandTable::name(PIN_MODE), pinMode.c_str()) != NULL);
 }
 
 String SysCmdsClass::reset()
 {
-	return String((char*)RnRequest.rnRequest(SYS, params[RESET]));
+	return String((char*)this->request->rnRequest(SYS, CommandTable::name(RESET)));
 }
 
 void SysCmdsClass::wakeUp()
 {
 	if (isAsleep())
 	{
-		RnRequest.setBreakCondition();
+		this->request->setBreakCondition();
 
 		delay(100);
 
 		// set baudrate
-		RnRequest.setWakeupFlag();
-		RnRequest.isAsleep = false;
+		this->request->setWakeupFlag();
+		this->request->isAsleep = false;
 	}
 }
\ No newline at end of file
@@ -32,39 +32,21 @@
 	#include "WProgram.h"
 #endif
 
-/**
-* @brief     Different kind of SYS commands
-* @details   Each of these values is used to find the correct string value in the \e params attribute of the class
-*/
-typedef enum _paramSys {
-	VERSION = 0,
-	NVM,
-	VDD,
-	PIN_DIG,
-	PIN_ANA,
-	PIN_MODE,
-	HWEUI,
-	SLEEP,
-	RESET,
-	COUNT_PARAM_SYS
-}eParamSys;
-
+#include "CommandTable.h"
+#include "RnRequest.h"
 
 class SysCmdsClass
 {
  protected:
-	 const char* params[COUNT_PARAM_SYS] = {
-		 "ver",
-		 "nvm",
-		 "vdd",
-		 "pindig",
-		 "pinana",
-		 "pinmode",
-		 "hweui",
-		 "sleep",
-		 "reset",
-	 };
+	 RnRequestClass* request;
+
  public:
+	 /**
+	 * @brief		Constructor for the SysCmdsClass class
+	 * @param		request		Object communicating with the module the commands are sent to
+	 */
+	 SysCmdsClass(RnRequestClass* request = &RnRequest);
+
 
 	 /**
 	 * @brief		Getter on the firmware version of the device
@@ -0,0 +1,149 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "TermiosTransport.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+typedef struct _sBaudrate {
+	unsigned long baudrate;
+	speed_t speed;
+}sBaudrate;
+
+static const sBaudrate baudrates[] = {
+	{ 300, B300 }, { 600, B600 }, { 1200, B1200 }, { 2400, B2400 }, { 4800, B4800 }, { 9600, B9600 },
+	{ 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 }, { 115200, B115200 }, { 230400, B230400 },
+	{ 460800, B460800 }, { 921600, B921600 }
+};
+
+static bool toSpeed(unsigned long baudrate, speed_t* speed)
+{
+	for (size_t i = 0; i < sizeof(baudrates) / sizeof(baudrates[0]); i++)
+	{
+		if (baudrates[i].baudrate == baudrate)
+		{
+			*speed = baudrates[i].speed;
+			return true;
+		}
+	}
+	return false;
+}
+
+TermiosTransport::TermiosTransport()
+{
+	this->fd = -1;
+}
+
+TermiosTransport::~TermiosTransport()
+{
+	close();
+}
+
+bool TermiosTransport::open(const char* device, unsigned long baudrate)
+{
+	close();
+
+	speed_t speed;
+	if (!toSpeed(baudrate, &speed)) return false;
+
+	this->fd = ::open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (this->fd < 0) return false;
+
+	struct termios tty;
+	if (tcgetattr(this->fd, &tty) != 0)
+	{
+		close();
+		return false;
+	}
+
+	cfmakeraw(&tty);
+	tty.c_cflag |= CLOCAL | CREAD;
+	tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+	tty.c_cc[VMIN] = 0;
+	tty.c_cc[VTIME] = 0;
+
+	cfsetispeed(&tty, speed);
+	cfsetospeed(&tty, speed);
+
+	if (tcsetattr(this->fd, TCSANOW, &tty) != 0)
+	{
+		close();
+		return false;
+	}
+
+	tcflush(this->fd, TCIOFLUSH);
+	return true;
+}
+
+void TermiosTransport::close()
+{
+	if (this->fd >= 0) ::close(this->fd);
+	this->fd = -1;
+}
+
+int TermiosTransport::available()
+{
+	int count = 0;
+	if ((this->fd < 0) || (ioctl(this->fd, FIONREAD, &count) != 0)) return 0;
+	return count;
+}
+
+uint16_t TermiosTransport::read(uint8_t* buffer, uint16_t size)
+{
+	if (this->fd < 0) return 0;
+
+	ssize_t len = ::read(this->fd, buffer, size);
+	return (len > 0) ? (uint16_t)len : 0;
+}
+
+uint16_t TermiosTransport::write(const uint8_t* data, uint16_t len)
+{
+	if (this->fd < 0) return 0;
+
+	// the port is non blocking, a full output queue takes a partial write or EAGAIN
+	uint16_t total = 0;
+	while (total < len)
+	{
+		ssize_t written = ::write(this->fd, data + total, len - total);
+		if (written > 0)
+		{
+			total += written;
+			continue;
+		}
+		if ((written < 0) && (errno == EINTR)) continue;
+		if ((written < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) break;
+
+		struct pollfd output = { this->fd, POLLOUT, 0 };
+		int ready = poll(&output, 1, TERMIOS_WRITE_TIMEOUT);
+		if ((ready < 0) && (errno == EINTR)) continue;
+		if ((ready <= 0) || (output.revents & (POLLERR | POLLHUP | POLLNVAL))) break;
+	}
+	return total;
+}
+
+void TermiosTransport::sendBreak()
+{
+	if (this->fd < 0) return;
+
+	tcdrain(this->fd);
+	tcsendbreak(this->fd, 0);
+}
+
+#endif
@@ -0,0 +1,77 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			TermiosTransport.h
+* @brief		Transport over a serial port of a Linux host
+* @details		Used when the module is connected to a gateway class host through an USB-UART adapter.
+*				Only built on Linux
+*/
+
+#ifndef _TERMIOS_TRANSPORT_H
+#define _TERMIOS_TRANSPORT_H
+
+#if defined(__linux__)
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "RnTransport.h"
+
+class TermiosTransport : public RnTransport
+{
+protected:
+	int fd;
+
+public:
+	/**
+	* @brief		Constructor for the TermiosTransport class
+	*/
+	TermiosTransport();
+
+	/**
+	* @brief		Destructor for the TermiosTransport class, closes the port
+	*/
+	virtual ~TermiosTransport();
+
+	/**
+	* @brief		Opening and configuring the serial port
+	* @details		The port is set to raw mode, 8N1, non blocking reads
+	* @param		device		String value representing the device path (/dev/ttyUSB0...)
+	* @param		baudrate	Communication baudrate, one of the standard rates from 300 to 921600
+	* @return		Boolean value, true if the port is ready, false if it can't be opened or the baudrate is not supported
+	*/
+	bool open(const char* device, unsigned long baudrate = RN2483_BAUDRATE);
+
+	/**
+	* @brief		Closing the serial port
+	*/
+	void close();
+
+	virtual int available();
+	virtual uint16_t read(uint8_t* buffer, uint16_t size);
+
+	/**
+	* @brief		Writing bytes to the module
+	* @details		Waits for room in the output queue of the port when it is full, up to TERMIOS_WRITE_TIMEOUT ms each time
+	* @param		data		Bytes to write
+	* @param		len			Number of bytes to write
+	* @return		Decimal number representing the number of bytes written, lower than \e len on error or timeout
+	*/
+	virtual uint16_t write(const uint8_t* data, uint16_t len);
+	virtual void sendBreak();
+};
+
+#endif
+
+#endif
@@ -0,0 +1,170 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			TimeOnAir.h
+* @brief		Time on air of the LoRaWAN frames and deadlines of the commands using the radio
+* @details		This class implements the time on air formula of the Semtech LoRa modem (SX1276 datasheet)
+*				for the EU868 data rates, and derives from it how long the module may take to answer
+*				"mac tx" and "mac join". All methods are constexpr: timeouts for constant parameters
+*				are computed by the compiler, the other ones with a few integer operations.
+*/
+
+#ifndef _TIME_ON_AIR_H
+#define _TIME_ON_AIR_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "ConstOrangeForRN2483.h"
+
+class TimeOnAir
+{
+public:
+	/**
+	* @brief		Getter on the spreading factor of an EU868 data rate
+	* @param		dataRate	eDataRate value, from \e DATA_RATE_0 to \e DATA_RATE_6
+	* @return		Spreading factor, from 7 to 12
+	*/
+	static constexpr uint8_t spreadingFactor(eDataRate dataRate)
+	{
+		return (dataRate <= DATA_RATE_5) ? (uint8_t)(SF12 - dataRate) : (uint8_t)SF7;
+	}
+
+	/**
+	* @brief		Getter on the bandwidth of an EU868 data rate
+	* @param		dataRate	eDataRate value, from \e DATA_RATE_0 to \e DATA_RATE_6
+	* @return		Bandwidth in kHz
+	*/
+	static constexpr uint16_t bandwidth(eDataRate dataRate)
+	{
+		return (dataRate == DATA_RATE_6) ? 250 : 125;
+	}
+
+	/**
+	* @brief		Getter on the maximum application payload of an EU868 data rate
+	* @param		dataRate	eDataRate value
+	* @return		Size in bytes, without FOpts
+	*/
+	static constexpr uint8_t maxPayloadSize(eDataRate dataRate)
+	{
+		return (dataRate <= DATA_RATE_2) ? 51 : ((dataRate == DATA_RATE_3) ? 115 : 222);
+	}
+
+	/**
+	* @brief		Getter on the duration of a LoRa symbol
+	* @param		sf			Spreading factor, from 7 to 12
+	* @param		bw			Bandwidth in kHz
+	* @return		Duration in microseconds
+	*/
+	static constexpr uint32_t symbolTime(uint8_t sf, uint16_t bw)
+	{
+		return ((uint32_t)1 << sf) * 1000UL / bw;
+	}
+
+	/**
+	* @brief		Getter on the number of symbols of a LoRa payload
+	* @details		Explicit header and CRC on, low data rate optimization for symbols longer than 16 ms
+	* @param		sf			Spreading factor, from 7 to 12
+	* @param		bw			Bandwidth in kHz
+	* @param		codingRate	eCodingRate value
+	* @param		len			Size of the PHY payload in bytes
+	* @return		Number of symbols, including the 8 symbols of the header
+	*/
+	static constexpr uint32_t payloadSymbols(uint8_t sf, uint16_t bw, eCodingRate codingRate, uint16_t len)
+	{
+		return 8 + ((8 * (int32_t)len - 4 * sf + 44 > 0) ?
+			(uint32_t)((8 * (int32_t)len - 4 * sf + 44 + 4 * lowDataRateSf(sf, bw) - 1) / (4 * lowDataRateSf(sf, bw))) * (codingRate + 5) : 0);
+	}
+
+	/**
+	* @brief		Getter on the time on air of a LoRa frame
+	* @param		sf			Spreading factor, from 7 to 12
+	* @param		bw			Bandwidth in kHz
+	* @param		codingRate	eCodingRate value
+	* @param		preamble	Number of preamble symbols
+	* @param		len			Size of the PHY payload in bytes
+	* @return		Duration in microseconds
+	*/
+	static constexpr uint32_t loraFrame(uint8_t sf, uint16_t bw, eCodingRate codingRate, uint16_t preamble, uint16_t len)
+	{
+		// (preamble + 4.25) symbols, then the header and the payload
+		return ((4 * (uint32_t)preamble + 17) * symbolTime(sf, bw)) / 4 + payloadSymbols(sf, bw, codingRate, len) * symbolTime(sf, bw);
+	}
+
+	/**
+	* @brief		Getter on the time on air of a LoRaWAN PHY payload
+	* @details		\e DATA_RATE_7 is the 50 kbps FSK modulation, the other data rates use the coding rate 4/5
+	* @param		dataRate	eDataRate value
+	* @param		len			Size of the PHY payload in bytes
+	* @return		Duration in microseconds
+	*/
+	static constexpr uint32_t frame(eDataRate dataRate, uint16_t len)
+	{
+		return (dataRate == DATA_RATE_7) ? (len + FSK_FRAME_OVERHEAD) * FSK_BYTE_TIME :
+			loraFrame(spreadingFactor(dataRate), bandwidth(dataRate), CR_4_5, LORAWAN_PREAMBLE, len);
+	}
+
+	/**
+	* @brief		Getter on the time on air of a LoRaWAN data frame
+	* @param		dataRate	eDataRate value
+	* @param		payloadLen	Size of the application payload in bytes
+	* @return		Duration in milliseconds, rounded up
+	*/
+	static constexpr uint32_t dataFrame(eDataRate dataRate, uint16_t payloadLen)
+	{
+		return (frame(dataRate, payloadLen + LORAWAN_OVERHEAD) + 999) / 1000;
+	}
+
+	/**
+	* @brief		Getter on the delay of the final response of "mac tx"
+	* @details		Each transmission is followed by the RX1 and RX2 windows, a downlink of the maximum size
+	*				being received in RX2. A confirmed uplink is sent again after ACK_TIMEOUT until it is acknowledged
+	* @param		dataRate	eDataRate value of the uplink
+	* @param		payloadLen	Size of the application payload in bytes
+	* @param		nbTrans		Number of transmissions, 1 for an unconfirmed uplink, 1 + retx for a confirmed one
+	* @param		rxDelay1	Delay of the RX1 window in milliseconds
+	* @param		rx2DataRate	eDataRate value of the RX2 window
+	* @return		Duration in milliseconds
+	*/
+	static constexpr uint32_t uplinkTimeout(eDataRate dataRate, uint16_t payloadLen, uint8_t nbTrans, uint16_t rxDelay1, eDataRate rx2DataRate)
+	{
+		return nbTrans * (dataFrame(dataRate, payloadLen) + rxDelay1 + RX_WINDOW_GAP + dataFrame(rx2DataRate, maxPayloadSize(rx2DataRate))) +
+			(nbTrans - 1) * ACK_TIMEOUT_MAX + AIRTIME_MARGIN;
+	}
+
+	/**
+	* @brief		Getter on the delay of the final response of "mac join"
+	* @param		dataRate	eDataRate value of the join request
+	* @param		rx2DataRate	eDataRate value of the RX2 window
+	* @return		Duration in milliseconds
+	*/
+	static constexpr uint32_t joinTimeout(eDataRate dataRate, eDataRate rx2DataRate)
+	{
+		return (frame(dataRate, JOIN_REQUEST_SIZE) + 999) / 1000 + JOIN_ACCEPT_DELAY2 +
+			(frame(rx2DataRate, JOIN_ACCEPT_SIZE) + 999) / 1000 + AIRTIME_MARGIN;
+	}
+
+private:
+	static constexpr int32_t lowDataRateSf(uint8_t sf, uint16_t bw)
+	{
+		return (symbolTime(sf, bw) > 16000) ? sf - 2 : sf;
+	}
+};
+
+// values of the LoRa calculator of Semtech
+static_assert(TimeOnAir::frame(DATA_RATE_0, 23) == 1482752, "time on air of a join request at SF12");
+static_assert(TimeOnAir::frame(DATA_RATE_5, 23) == 61696, "time on air of a join request at SF7");
+static_assert(TimeOnAir::frame(DATA_RATE_6, 23) == 30848, "time on air of a join request at SF7/250kHz");
+
+#endif
@@ -0,0 +1,110 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "TraceRecorder.h"
+
+TraceRecorder::TraceRecorder()
+{
+	this->transport = NULL;
+	this->sink = NULL;
+	this->lastMicros = 0;
+	this->lastMillis = 0;
+	this->recordedBytes = 0;
+}
+
+void TraceRecorder::begin(RnTransport* transport, Print* sink)
+{
+	this->transport = transport;
+	this->sink = sink;
+	this->lastMicros = micros();
+	this->lastMillis = millis();
+	this->recordedBytes = sink->write((const uint8_t*)TRACE_MAGIC, TRACE_HEADER_SIZE - 1);
+	this->recordedBytes += sink->write((uint8_t)TRACE_VERSION);
+}
+
+RnTransport* TraceRecorder::getTransport()
+{
+	return this->transport;
+}
+
+uint32_t TraceRecorder::getRecordedBytes()
+{
+	return this->recordedBytes;
+}
+
+uint64_t TraceRecorder::getElapsedTime()
+{
+	unsigned long nowMicros = micros();
+	unsigned long nowMillis = millis();
+
+	// micros() wraps around every 71.6 minutes, millis() every 49.7 days: the wraps of micros() missed
+	// between two records are the ones which bring its delta the closest to the one of millis()
+	uint64_t elapsed = (uint32_t)(nowMicros - this->lastMicros);
+	uint64_t approximate = (uint64_t)(uint32_t)(nowMillis - this->lastMillis) * 1000;
+	while (approximate > elapsed + 0x80000000ULL) elapsed += 0x100000000ULL;
+
+	this->lastMicros = nowMicros;
+	this->lastMillis = nowMillis;
+	return elapsed;
+}
+
+void TraceRecorder::writeVarint(uint64_t value)
+{
+	uint8_t bytes[10];
+	uint8_t len = 0;
+
+	do {
+		bytes[len] = value & 0x7F;
+		value >>= 7;
+		if (value != 0) bytes[len] |= 0x80;
+		len++;
+	} while (value != 0);
+
+	this->recordedBytes += this->sink->write(bytes, len);
+}
+
+void TraceRecorder::writeRecord(eTraceTag tag, const uint8_t* data, uint16_t len)
+{
+	this->recordedBytes += this->sink->write((uint8_t)tag);
+	writeVarint(getElapsedTime());
+
+	if (tag == TRACE_BREAK) return;
+
+	writeVarint(len);
+	this->recordedBytes += this->sink->write(data, len);
+}
+
+int TraceRecorder::available()
+{
+	return this->transport->available();
+}
+
+uint16_t TraceRecorder::read(uint8_t* buffer, uint16_t size)
+{
+	uint16_t len = this->transport->read(buffer, size);
+	if (len > 0) writeRecord(TRACE_READ, buffer, len);
+	return len;
+}
+
+uint16_t TraceRecorder::write(const uint8_t* data, uint16_t len)
+{
+	uint16_t written = this->transport->write(data, len);
+	writeRecord(TRACE_WRITE, data, written);
+	return written;
+}
+
+void TraceRecorder::sendBreak()
+{
+	this->transport->sendBreak();
+	writeRecord(TRACE_BREAK, NULL, 0);
+}
@@ -0,0 +1,91 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			TraceRecorder.h
+* @brief		Recording of the exchanges with the module
+* @details		TraceRecorder is placed between RnRequestClass and the transport, and writes each exchange
+*				to a Print object (SD card file, SerialUSB...) as a binary trace which TraceReplayer plays back.
+*
+*				Trace format: the 4 characters "RNTR" and a version byte, then one record per exchange:
+*				- a tag byte: \e TRACE_WRITE, \e TRACE_READ or \e TRACE_BREAK
+*				- the time elapsed since the previous record, in µs, as a LEB128 varint of up to 64 bits
+*				- for \e TRACE_WRITE and \e TRACE_READ, the number of bytes as a LEB128 varint, then the bytes
+*/
+
+#ifndef _TRACE_RECORDER_H
+#define _TRACE_RECORDER_H
+
+#include <Arduino.h>
+
+#include "RnTransport.h"
+
+#define TRACE_MAGIC						"RNTR"
+#define TRACE_VERSION					2		// 1 wrote the elapsed time on 32 bits, which is still read
+#define TRACE_HEADER_SIZE				5
+
+/**
+* \brief     Kinds of records of a trace
+*/
+typedef enum _eTraceTag {
+	TRACE_WRITE = 0,						// Bytes written by the library
+	TRACE_READ,								// Bytes received from the module
+	TRACE_BREAK								// Break condition sent by the library
+}eTraceTag;
+
+class TraceRecorder : public RnTransport
+{
+protected:
+	RnTransport* transport;
+	Print* sink;
+	unsigned long lastMicros;				// Time of the previous record
+	unsigned long lastMillis;
+	uint32_t recordedBytes;
+
+	uint64_t getElapsedTime();
+	void writeVarint(uint64_t value);
+	void writeRecord(eTraceTag tag, const uint8_t* data, uint16_t len);
+
+public:
+	/**
+	* @brief		Constructor for the TraceRecorder class
+	*/
+	TraceRecorder();
+
+	/**
+	* @brief		Starting a recording
+	* @details		Writes the trace header to the sink
+	* @param		transport	Transport the exchanges go through
+	* @param		sink		Destination of the trace
+	*/
+	void begin(RnTransport* transport, Print* sink);
+
+	/**
+	* @brief		Getter on the transport the exchanges go through
+	* @return		Pointer on the transport given to \e begin()
+	*/
+	RnTransport* getTransport();
+
+	/**
+	* @brief		Getter on the size of the recorded trace
+	* @return		Decimal number representing the number of bytes written to the sink
+	*/
+	uint32_t getRecordedBytes();
+
+	virtual int available();
+	virtual uint16_t read(uint8_t* buffer, uint16_t size);
+	virtual uint16_t write(const uint8_t* data, uint16_t len);
+	virtual void sendBreak();
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "TraceReplayer.h"
+
+TraceReplayer::TraceReplayer()
+{
+	this->trace = NULL;
+	this->traceLength = 0;
+	this->position = 0;
+	this->remaining = 0;
+	this->finished = true;
+	this->now = 0;
+	this->recordCount = 0;
+	this->mismatchCount = 0;
+}
+
+bool TraceReplayer::begin(const uint8_t* trace, uint32_t len)
+{
+	this->trace = trace;
+	this->traceLength = len;
+	this->now = 0;
+	this->recordTime = 0;
+	this->recordCount = 0;
+	this->mismatchCount = 0;
+
+	if ((len < TRACE_HEADER_SIZE) || (memcmp(trace, TRACE_MAGIC, TRACE_HEADER_SIZE - 1) != 0) || (trace[TRACE_HEADER_SIZE - 1] == 0) || (trace[TRACE_HEADER_SIZE - 1] > TRACE_VERSION))
+	{
+		this->finished = true;
+		return false;
+	}
+
+	this->position = TRACE_HEADER_SIZE;
+	this->finished = false;
+	nextRecord();
+	return true;
+}
+
+bool TraceReplayer::readVarint(uint64_t* value)
+{
+	*value = 0;
+	for (uint8_t shift = 0; (shift < 70) && (this->position < this->traceLength); shift += 7)
+	{
+		uint8_t byte = this->trace[this->position++];
+		*value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return true;
+	}
+	return false;
+}
+
+void TraceReplayer::nextRecord()
+{
+	uint64_t delta = 0;
+	uint64_t len = 0;
+
+	if (this->position >= this->traceLength)
+	{
+		this->finished = true;
+		return;
+	}
+
+	this->tag = (eTraceTag)this->trace[this->position++];
+	bool valid = readVarint(&delta) && (this->tag <= TRACE_BREAK);
+	if (valid && (this->tag != TRACE_BREAK)) valid = readVarint(&len) && (len <= this->traceLength - this->position);
+
+	// a truncated trace ends the playback
+	this->finished = !valid;
+	this->recordTime += delta;
+	this->remaining = (uint16_t)len;
+}
+
+void TraceReplayer::waitRecord()
+{
+	// the library waits for the module: virtual time jumps to the next record
+	if (this->now < this->recordTime) this->now = this->recordTime;
+}
+
+uint32_t TraceReplayer::clock(void* replayer)
+{
+	return (uint32_t)(((TraceReplayer*)replayer)->now / 1000);
+}
+
+bool TraceReplayer::isFinished()
+{
+	return this->finished;
+}
+
+uint32_t TraceReplayer::getRecordCount()
+{
+	return this->recordCount;
+}
+
+uint32_t TraceReplayer::getMismatchCount()
+{
+	return this->mismatchCount;
+}
+
+int TraceReplayer::available()
+{
+	if (this->finished || (this->tag != TRACE_READ) || (this->now < this->recordTime)) return 0;
+	return this->remaining;
+}
+
+uint16_t TraceReplayer::read(uint8_t* buffer, uint16_t size)
+{
+	if (this->finished)
+	{
+		// past the end of the trace, only time goes on so that the pending commands time out
+		this->now += 1000;
+		return 0;
+	}
+
+	waitRecord();
+	if (this->tag != TRACE_READ) return 0;
+
+	uint16_t len = (size < this->remaining) ? size : this->remaining;
+	memcpy(buffer, &this->trace[this->position], len);
+	this->position += len;
+	this->remaining -= len;
+
+	if (this->remaining == 0)
+	{
+		this->recordCount++;
+		nextRecord();
+	}
+	return len;
+}
+
+uint16_t TraceReplayer::write(const uint8_t* data, uint16_t len)
+{
+	if (this->finished || (this->tag != TRACE_WRITE))
+	{
+		this->mismatchCount++;
+		return len;
+	}
+
+	waitRecord();
+	if ((len != this->remaining) || (memcmp(data, &this->trace[this->position], len) != 0)) this->mismatchCount++;
+
+	this->position += this->remaining;
+	this->recordCount++;
+	nextRecord();
+	return len;
+}
+
+void TraceReplayer::sendBreak()
+{
+	if (this->finished || (this->tag != TRACE_BREAK))
+	{
+		this->mismatchCount++;
+		return;
+	}
+
+	waitRecord();
+	this->recordCount++;
+	nextRecord();
+}
@@ -0,0 +1,99 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			TraceReplayer.h
+* @brief		Playback of a trace written by TraceRecorder
+* @details		TraceReplayer stands for the module: it hands the recorded responses over to the library and
+*				checks the written commands against the recorded ones. Time is virtual: it jumps to the next
+*				record whenever the library waits, so a session lasting minutes is played back as fast as the
+*				library processes it. Give \e TraceReplayer::clock to RnRequestClass::setClock() so that the
+*				timeouts of the library follow the virtual time.
+*/
+
+#ifndef _TRACE_REPLAYER_H
+#define _TRACE_REPLAYER_H
+
+#include <Arduino.h>
+
+#include "RnTransport.h"
+#include "TraceRecorder.h"
+
+class TraceReplayer : public RnTransport
+{
+protected:
+	const uint8_t* trace;
+	uint32_t traceLength;
+	uint32_t position;						// Next byte of the trace to parse
+
+	eTraceTag tag;							// Current record
+	uint64_t recordTime;					// Time of the current record in µs
+	uint16_t remaining;
+	bool finished;
+
+	uint64_t now;							// Virtual time in µs, uint32_t would wrap around after 71 minutes
+	uint32_t recordCount;
+	uint32_t mismatchCount;
+
+	bool readVarint(uint64_t* value);
+	void nextRecord();
+	void waitRecord();
+
+public:
+	/**
+	* @brief		Constructor for the TraceReplayer class
+	*/
+	TraceReplayer();
+
+	/**
+	* @brief		Starting a playback
+	* @param		trace		Trace written by TraceRecorder, must stay valid during the playback
+	* @param		len			Size of the trace
+	* @return		Boolean value, false if the trace header is not valid
+	*/
+	bool begin(const uint8_t* trace, uint32_t len);
+
+	/**
+	* @brief		Clock of the library during the playback
+	* @details		To give to RnRequestClass::setClock() with the replayer as context
+	* @param		replayer	Pointer on the TraceReplayer object
+	* @return		Virtual time in ms
+	*/
+	static uint32_t clock(void* replayer);
+
+	/**
+	* @brief		Check if the whole trace was played back
+	* @return		Boolean value, true once the last record was consumed
+	*/
+	bool isFinished();
+
+	/**
+	* @brief		Getter on the number of consumed records
+	* @return		Decimal number
+	*/
+	uint32_t getRecordCount();
+
+	/**
+	* @brief		Getter on the number of exchanges which differ from the trace
+	* @details		A written command or a break which is not the recorded one, typically a behaviour change of the library
+	* @return		Decimal number
+	*/
+	uint32_t getMismatchCount();
+
+	virtual int available();
+	virtual uint16_t read(uint8_t* buffer, uint16_t size);
+	virtual uint16_t write(const uint8_t* data, uint16_t len);
+	virtual void sendBreak();
+};
+
+#endif
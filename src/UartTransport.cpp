@@ -0,0 +1,59 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "UartTransport.h"
+
+UartTransport::UartTransport(SerialType* serial, unsigned long baudrate)
+{
+	this->serial = serial;
+	this->baudrate = baudrate;
+}
+
+void UartTransport::begin()
+{
+	this->serial->begin(this->baudrate);
+}
+
+int UartTransport::available()
+{
+	return this->serial->available();
+}
+
+uint16_t UartTransport::read(uint8_t* buffer, uint16_t size)
+{
+	uint16_t len = 0;
+	while ((len < size) && (this->serial->available() > 0))
+	{
+		int c = this->serial->read();
+		if (c < 0) break;
+		buffer[len++] = (uint8_t)c;
+	}
+	return len;
+}
+
+uint16_t UartTransport::write(const uint8_t* data, uint16_t len)
+{
+	return this->serial->write(data, len);
+}
+
+void UartTransport::sendBreak()
+{
+	// "emulate" break condition: a null byte at a low baudrate holds the line low long enough
+	this->serial->flush();
+
+	this->serial->begin(BREAK_BAUDRATE);
+	this->serial->write((uint8_t)0x00);
+	this->serial->flush();
+
+	this->serial->begin(this->baudrate);
+}
@@ -0,0 +1,63 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			UartTransport.h
+* @brief		Transport over an Arduino UART
+* @details		Default transport of the library, used on Serial2 by RnRequestClass::init()
+*/
+
+#ifndef _UART_TRANSPORT_H
+#define _UART_TRANSPORT_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "RnTransport.h"
+
+#if defined(ARDUINO_ARCH_AVR)
+typedef HardwareSerial SerialType;
+#define ENABLE_SLEEP
+#elif defined(ARDUINO_ARCH_SAM) || defined(ARDUINO_ARCH_SAMD)
+typedef Uart SerialType;
+#define ENABLE_SLEEP
+#else
+typedef Stream SerialType;
+#endif
+
+class UartTransport : public RnTransport
+{
+protected:
+	SerialType* serial;
+	unsigned long baudrate;
+
+public:
+	/**
+	* @brief		Constructor for the UartTransport class
+	* @param		serial		UART connected to the module
+	* @param		baudrate	Communication baudrate
+	*/
+	UartTransport(SerialType* serial, unsigned long baudrate = RN2483_BAUDRATE);
+
+	/**
+	* @brief		Starting the UART
+	*/
+	void begin();
+
+	virtual int available();
+	virtual uint16_t read(uint8_t* buffer, uint16_t size);
+	virtual uint16_t write(const uint8_t* data, uint16_t len);
+	virtual void sendBreak();
+};
+
+#endif
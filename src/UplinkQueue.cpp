@@ -0,0 +1,130 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+#include "UplinkQueue.h"
+#include "TimeOnAir.h"
+
+UplinkQueue::UplinkQueue(uint8_t port, OrangeForRN2483Class* orange, uint32_t maxAge)
+{
+	this->orange = orange;
+	this->port = port;
+	this->typeMessage = UNCONFIRMED_MESSAGE;
+	this->maxAge = maxAge;
+	this->frameLength = 0;
+	this->frameRecords = 0;
+	this->firstRecordTime = 0;
+	resetStats();
+}
+
+void UplinkQueue::setMessageType(eTypeMessage typeMessage)
+{
+	this->typeMessage = typeMessage;
+}
+
+void UplinkQueue::setMaxAge(uint32_t maxAge)
+{
+	this->maxAge = maxAge;
+}
+
+bool UplinkQueue::add(const uint8_t* record, uint8_t len, bool urgent)
+{
+	uint8_t maxFrameSize = this->orange->getMaxPayloadSize();
+	if ((record == NULL) || (len == 0) || (len + 1 > maxFrameSize))
+	{
+		this->stats.droppedRecords++;
+		return false;
+	}
+
+	// the data rate may have been lowered since the frame was started
+	if ((this->frameLength + len + 1 > maxFrameSize) && !flush())
+	{
+		this->stats.droppedRecords++;
+		return false;
+	}
+
+	if (this->frameRecords == 0) this->firstRecordTime = this->orange->getRequest()->now();
+
+	this->frame[this->frameLength++] = len;
+	memcpy(&this->frame[this->frameLength], record, len);
+	this->frameLength += len;
+	this->frameRecords++;
+
+	// nothing else fits, no reason to wait
+	if (urgent || (this->frameLength + 2 > maxFrameSize)) return flush();
+	return true;
+}
+
+bool UplinkQueue::add(LpwaOrangeEncoderClass* encoder, bool urgent)
+{
+	int8_t len = 0;
+	uint8_t* payload = encoder->getFramePayload(&len);
+
+	bool result = add(payload, (uint8_t)len, urgent);
+	encoder->flush();
+	return result;
+}
+
+bool UplinkQueue::poll()
+{
+	if (this->frameRecords == 0) return true;
+
+	if (this->orange->getRequest()->now() - this->firstRecordTime < this->maxAge) return true;
+	return flush();
+}
+
+bool UplinkQueue::flush()
+{
+	if (this->frameRecords == 0) return true;
+
+	// kept for the next poll() rather than refused by the module
+	if (this->orange->nextTxOpportunity() > 0) return false;
+
+	eDataRate dataRate = this->orange->getCurrentDataRate();
+	if (dataRate == DATA_RATE_ERROR) dataRate = DATA_RATE_0;
+	if (!this->orange->sendMessage(this->typeMessage, this->frame, this->frameLength, this->port))
+	{
+		this->stats.failedFrames++;
+		return false;
+	}
+
+	this->stats.records += this->frameRecords;
+	this->stats.frames++;
+	this->stats.recordBytes += this->frameLength - this->frameRecords;
+	this->stats.frameBytes += this->frameLength;
+	this->stats.airtime += TimeOnAir::dataFrame(dataRate, this->frameLength);
+
+	this->frameLength = 0;
+	this->frameRecords = 0;
+	return true;
+}
+
+uint8_t UplinkQueue::getPendingRecords()
+{
+	return this->frameRecords;
+}
+
+void UplinkQueue::getStats(sUplinkQueueStats* stats)
+{
+	memcpy(stats, &this->stats, sizeof(sUplinkQueueStats));
+}
+
+void UplinkQueue::resetStats()
+{
+	memset(&this->stats, 0, sizeof(sUplinkQueueStats));
+}
+
+uint8_t UplinkQueue::getPackingEfficiency()
+{
+	uint32_t sent = this->stats.frameBytes + (this->stats.frames * LORAWAN_OVERHEAD);
+	return (sent == 0) ? 0 : (uint8_t)((this->stats.recordBytes * 100) / sent);
+}
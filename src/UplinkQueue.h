@@ -0,0 +1,140 @@
+/*
+* Copyright (C) 2017 Orange
+*
+* This software is distributed under the terms and conditions of the 'Apache-2.0'
+* license which can be found in the file 'LICENSE.txt' in this package distribution
+* or at 'http://www.apache.org/licenses/LICENSE-2.0'.
+*/
+
+/* Orange LoRa Explorer Kit
+*
+* Version:     1.0-SNAPSHOT
+*/
+
+/**
+* @file			UplinkQueue.h
+* @brief		Packing of small records into uplinks of the largest size allowed by the data rate
+* @details		Each record is preceded by its length on one byte, so the application server splits a frame
+*				back into records. A frame is sent when the next record does not fit, when its oldest record
+*				reaches the maximum age, or right after an urgent record.
+*/
+
+#ifndef _UPLINK_QUEUE_H
+#define _UPLINK_QUEUE_H
+
+#include <Arduino.h>
+
+#include "InternalConstForRN2483.h"
+#include "OrangeForRN2483.h"
+#include "LpwaOrangeEncoder.h"
+
+/**
+* \brief     Packing statistics of an UplinkQueue
+*/
+typedef struct _sUplinkQueueStats {
+	uint32_t records;						// Records sent
+	uint32_t frames;						// Uplinks sent
+	uint32_t recordBytes;					// Bytes of the records, without their length
+	uint32_t frameBytes;					// Application payload bytes of the uplinks
+	uint32_t airtime;						// Time on air of the uplinks in ms, one transmission each
+	uint32_t failedFrames;					// Uplinks refused by the module or the network
+	uint32_t droppedRecords;				// Records refused because the queue could not be emptied
+}sUplinkQueueStats;
+
+class UplinkQueue
+{
+protected:
+	OrangeForRN2483Class* orange;
+	uint8_t port;
+	eTypeMessage typeMessage;
+	uint32_t maxAge;
+
+	uint8_t frame[UPLINK_FRAME_SIZE];
+	uint8_t frameLength;
+	uint8_t frameRecords;
+	uint32_t firstRecordTime;
+
+	sUplinkQueueStats stats;
+
+public:
+	/**
+	* @brief		Constructor for the UplinkQueue class
+	* @param		port		Port of the uplinks, from 1 to 223
+	* @param		orange		Object sending the uplinks, the global OrangeForRN2483 by default
+	* @param		maxAge		Maximum time in ms a record waits before being sent
+	*/
+	UplinkQueue(uint8_t port, OrangeForRN2483Class* orange = &OrangeForRN2483, uint32_t maxAge = DEFAULT_UPLINK_MAX_AGE);
+
+	/**
+	* @brief		Setter for the type of the uplinks
+	* @param		typeMessage		eTypeMessage value, unconfirmed by default
+	*/
+	void setMessageType(eTypeMessage typeMessage);
+
+	/**
+	* @brief		Setter for the maximum time a record waits before being sent
+	* @param		maxAge		Duration in ms
+	*/
+	void setMaxAge(uint32_t maxAge);
+
+	/**
+	* @brief		Queuing a record
+	* @details		The queued records are sent first if the record does not fit in the current frame
+	* @param		record		Bytes of the record
+	* @param		len			Number of bytes, at most the largest payload of the data rate minus one
+	* @param		urgent		Boolean value, true to send the frame right after queuing the record
+	* @return		Boolean value, false if the record is too long or could not be queued, or if the urgent
+	*				frame could not be sent
+	*/
+	bool add(const uint8_t* record, uint8_t len, bool urgent = false);
+
+	/**
+	* @brief		Queuing the payload built by an encoder as a record
+	* @details		The encoder is flushed once its payload is queued
+	* @param		encoder		Encoder holding the record
+	* @param		urgent		Boolean value, true to send the frame right after queuing the record
+	* @return		Boolean value, false if the record could not be queued or sent
+	*/
+	bool add(LpwaOrangeEncoderClass* encoder, bool urgent = false);
+
+	/**
+	* @brief		Sending the frame once its oldest record reached the maximum age
+	* @details		This function must be called regularly, typically from loop()
+	* @return		Boolean value, false if a frame was due but could not be sent
+	*/
+	bool poll();
+
+	/**
+	* @brief		Sending the queued records now
+	* @details		The records are kept when the uplink fails or the duty cycle does not allow it yet, and sent again
+	*				by the next flush
+	* @return		Boolean value, true if nothing was queued or the uplink was sent
+	*/
+	bool flush();
+
+	/**
+	* @brief		Getter on the number of records waiting to be sent
+	* @return		Decimal number
+	*/
+	uint8_t getPendingRecords();
+
+	/**
+	* @brief		Getter on the packing statistics
+	* @param		stats		Pointer on a sUplinkQueueStats structure to fill
+	*/
+	void getStats(sUplinkQueueStats* stats);
+
+	/**
+	* @brief		Resetting the packing statistics
+	*/
+	void resetStats();
+
+	/**
+	* @brief		Getter on the packing efficiency
+	* @details		Share of the bytes of the records in the bytes sent, the LoRaWAN overhead of each uplink included
+	* @return		Percentage, 0 if nothing was sent
+	*/
+	uint8_t getPackingEfficiency();
+};
+
+#endif